@@ -359,6 +359,69 @@ imu::Quaternion Adafruit_BNO055::getQuat(void)
   return quat;
 }
 
+/**************************************************************************/
+/*!
+    @brief  Reads all of the motion data registers in a single I2C transfer
+*/
+/**************************************************************************/
+bool Adafruit_BNO055::readAllMotionData(adafruit_bno055_motion_t *data)
+{
+  uint8_t buffer[BNO055_MOTION_DATA_LEN];
+
+  if (!readLen(BNO055_ACCEL_DATA_X_LSB_ADDR, buffer, BNO055_MOTION_DATA_LEN))
+  {
+    return false;
+  }
+
+  decodeMotionData(buffer, data);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Decodes a raw dump of the registers from
+            BNO055_ACCEL_DATA_X_LSB_ADDR to BNO055_TEMP_ADDR
+*/
+/**************************************************************************/
+static int16_t readInt16(const uint8_t *buffer)
+{
+  return (int16_t)(((uint16_t)buffer[1]) << 8 | buffer[0]);
+}
+
+static imu::Vector<3> readVector(const uint8_t *buffer, double lsb)
+{
+  imu::Vector<3> xyz;
+  xyz[0] = readInt16(&buffer[0]) / lsb;
+  xyz[1] = readInt16(&buffer[2]) / lsb;
+  xyz[2] = readInt16(&buffer[4]) / lsb;
+  return xyz;
+}
+
+void Adafruit_BNO055::decodeMotionData(const uint8_t *buffer, adafruit_bno055_motion_t *data)
+{
+  const uint8_t base = BNO055_ACCEL_DATA_X_LSB_ADDR;
+
+  /* Scaling for the default units (section 3.6.4): m/s^2, uT, dps, degrees */
+  data->accel       = readVector(&buffer[BNO055_ACCEL_DATA_X_LSB_ADDR - base], 100.0);
+  for (int i = 0; i < 3; i++)
+  {
+    data->accelRaw[i] = readInt16(&buffer[BNO055_ACCEL_DATA_X_LSB_ADDR - base + 2 * i]);
+  }
+  data->mag         = readVector(&buffer[BNO055_MAG_DATA_X_LSB_ADDR - base], 16.0);
+  data->gyro        = readVector(&buffer[BNO055_GYRO_DATA_X_LSB_ADDR - base], 16.0);
+  data->euler       = readVector(&buffer[BNO055_EULER_H_LSB_ADDR - base], 16.0);
+  data->linearAccel = readVector(&buffer[BNO055_LINEAR_ACCEL_DATA_X_LSB_ADDR - base], 100.0);
+  data->gravity     = readVector(&buffer[BNO055_GRAVITY_DATA_X_LSB_ADDR - base], 100.0);
+
+  /* 3.6.5.5 Orientation (Quaternion), 1 quaternion unit = 2^14 LSB */
+  const uint8_t *q = &buffer[BNO055_QUATERNION_DATA_W_LSB_ADDR - base];
+  const double scale = (1.0 / (1<<14));
+  data->quat = imu::Quaternion(scale * readInt16(&q[0]), scale * readInt16(&q[2]),
+                               scale * readInt16(&q[4]), scale * readInt16(&q[6]));
+
+  data->temp = (int8_t)buffer[BNO055_TEMP_ADDR - base];
+}
+
 /**************************************************************************/
 /*!
     @brief  Provides the sensor_t data for this sensor
@@ -628,8 +691,15 @@ bool Adafruit_BNO055::readLen(adafruit_bno055_reg_t reg, byte * buffer, uint8_t
   #else
     Wire.send(reg);
   #endif
-  Wire.endTransmission();
-  Wire.requestFrom(_address, (byte)len);
+  if (Wire.endTransmission() != 0)
+  {
+    return false;
+  }
+
+  if (Wire.requestFrom(_address, (byte)len) != len)
+  {
+    return false;
+  }
 
   for (uint8_t i = 0; i < len; i++)
   {
@@ -640,6 +710,5 @@ bool Adafruit_BNO055::readLen(adafruit_bno055_reg_t reg, byte * buffer, uint8_t
     #endif
   }
 
-  /* ToDo: Check for errors! */
   return true;
 }
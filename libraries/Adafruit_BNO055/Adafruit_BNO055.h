@@ -42,6 +42,10 @@
 
 #define NUM_BNO055_OFFSET_REGISTERS (22)
 
+/* Accel, mag, gyro, euler, quaternion, linear accel, gravity and temperature
+   sit back to back from BNO055_ACCEL_DATA_X_LSB_ADDR to BNO055_TEMP_ADDR */
+#define BNO055_MOTION_DATA_LEN (45)
+
 typedef struct
 {
     uint16_t accel_offset_x;
@@ -279,6 +283,20 @@ class Adafruit_BNO055 : public Adafruit_Sensor
       VECTOR_GRAVITY       = BNO055_GRAVITY_DATA_X_LSB_ADDR
     } adafruit_vector_type_t;
 
+    /* Everything from one burst read, in the default (power on) units */
+    typedef struct
+    {
+      imu::Vector<3>  accel;        /* m/s^2 */
+      int16_t         accelRaw[3];  /* 100 LSB per m/s^2 */
+      imu::Vector<3>  mag;          /* uT */
+      imu::Vector<3>  gyro;         /* degrees/s */
+      imu::Vector<3>  euler;        /* degrees, heading/roll/pitch */
+      imu::Quaternion quat;         /* unit quaternion */
+      imu::Vector<3>  linearAccel;  /* m/s^2 */
+      imu::Vector<3>  gravity;      /* m/s^2 */
+      int8_t          temp;         /* degrees C */
+    } adafruit_bno055_motion_t;
+
 #ifdef ARDUINO_SAMD_ZERO
 //#error "On an arduino Zero, BNO055's ADR pin must be high. Fix that, then delete this line."
     Adafruit_BNO055 ( int32_t sensorID = -1, uint8_t address = BNO055_ADDRESS_B );
@@ -300,6 +318,9 @@ class Adafruit_BNO055 : public Adafruit_Sensor
     imu::Quaternion getQuat   ( void );
     int8_t          getTemp   ( void );
 
+    bool            readAllMotionData   ( adafruit_bno055_motion_t* data );
+    static void     decodeMotionData    ( const uint8_t* buffer, adafruit_bno055_motion_t* data );
+
     bool  getOspreyEvent  ( sensors_event_t* , adafruit_vector_type_t );
     /* Adafruit_Sensor implementation */
     bool  getEvent  ( sensors_event_t* a ) { return true; }
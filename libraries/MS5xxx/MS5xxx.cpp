@@ -21,7 +21,7 @@
 
 #include "MS5xxx.h"
 
-MS5xxx::MS5xxx() : i2caddr(I2C_MS5607) {
+MS5xxx::MS5xxx() : busError(false), busErrors(0), i2caddr(I2C_MS5607), state(MS5xxx_STATE_IDLE), osr(MS5xxx_CMD_ADC_4096), adcD1(0), adcD2(0) {
 }
 
 void MS5xxx::setWire(TwoWire* wire)
@@ -49,23 +49,58 @@ uint8_t MS5xxx::connect() {
 	return ret;
 }
 
-void MS5xxx::ReadProm() {
-	send_cmd(MS5xxx_CMD_RESET);
+bool MS5xxx::ReadProm() {
+	unsigned int prom[8];
+
+	busError = false;
+	if(send_cmd(MS5xxx_CMD_RESET) != 0) {
+	    busErrors++;
+	    busError = true;
+	    return false;
+	}
 	delay(3);
 	  
 	for(uint8_t i=0;i<8;i++) 
 	{
-	    C[i]=0x0000;
-	    send_cmd(MS5xxx_CMD_PROM_RD+2*i);
-	    _Wire->requestFrom(i2caddr, 2);
+	    if(send_cmd(MS5xxx_CMD_PROM_RD+2*i) != 0 || _Wire->requestFrom(i2caddr, 2) != 2) {
+	        busErrors++;
+	        busError = true;
+	        return false;
+	    }
 
 	    unsigned int c = _Wire->read();
-	    C[i] = (c << 8);
+	    prom[i] = (c << 8);
 	    c = _Wire->read();
-	    C[i] += c;
-	    _Wire->endTransmission(true);
+	    prom[i] += c;
+	}
+
+	// only take the new coefficients if they pass the CRC. a blank or
+	// disconnected PROM (all zeros or all ones) would pass, so reject those too.
+	// a mismatch is treated like any other failed transfer
+	unsigned int old[8];
+	memcpy(old, C, sizeof(C));
+	memcpy(C, prom, sizeof(C));
+
+	bool blank = true;
+	for(uint8_t i=1;i<7;i++) {
+	    if(C[i] != 0x0000 && C[i] != 0xFFFF) blank = false;
 	}
-	
+
+	if(blank || Calc_CRC4() != Read_CRC4()) {
+	    memcpy(C, old, sizeof(C));
+	    busErrors++;
+	    busError = true;
+	    return false;
+	}
+
+	cal.SENS_T1 = C[1];
+	cal.OFF_T1 = C[2];
+	cal.TCS = C[3];
+	cal.TCO = C[4];
+	cal.T_REF = C[5];
+	cal.TEMPSENS = C[6];
+
+	return true;
 }
 
 unsigned int MS5xxx::Calc_CRC4(unsigned char poly)
@@ -120,10 +155,7 @@ unsigned int MS5xxx::Read_C( unsigned int index)
 
 unsigned long MS5xxx::read_adc(unsigned char aCMD)
 {
-  unsigned long value=0;
-  unsigned long c=0;
-  
-  send_cmd(MS5xxx_CMD_ADC_CONV+aCMD); // start DAQ and conversion of ADC data
+  start_adc(aCMD); // start DAQ and conversion of ADC data
   switch (aCMD & 0x0f)
   {
     case MS5xxx_CMD_ADC_256 : delayMicroseconds(900);
@@ -137,52 +169,165 @@ unsigned long MS5xxx::read_adc(unsigned char aCMD)
     case MS5xxx_CMD_ADC_4096: delay(10);
     break;
   }
-  send_cmd(MS5xxx_CMD_ADC_READ); // read out values
-  _Wire->requestFrom(i2caddr, 3);
+  return read_adc_result();
+}
+
+void MS5xxx::start_adc(unsigned char aCMD)
+{
+  if(send_cmd(MS5xxx_CMD_ADC_CONV+aCMD) != 0) {
+    busErrors++;
+    busError = true;
+  }
+  convStart = micros();
+}
+
+unsigned long MS5xxx::read_adc_result()
+{
+  unsigned long value=0;
+  unsigned long c=0;
+  
+  // read out values. requestFrom ends with a stop, so no further transaction
+  // is needed afterwards
+  if(send_cmd(MS5xxx_CMD_ADC_READ) != 0 || _Wire->requestFrom(i2caddr, 3) != 3) {
+    busErrors++;
+    busError = true;
+    return 0;
+  }
   c = _Wire->read();
   value = (c<<16);
   c = _Wire->read();
   value += (c<<8);
   c = _Wire->read();
   value += c;
-  _Wire->endTransmission(true);
  
   return value;
 }
 
+// maximum conversion time from the MS5607 datasheet, in microseconds
+unsigned long MS5xxx::conv_time(unsigned char aOSR)
+{
+  switch (aOSR & 0x0f)
+  {
+    case MS5xxx_CMD_ADC_256 : return 600;
+    case MS5xxx_CMD_ADC_512 : return 1170;
+    case MS5xxx_CMD_ADC_1024: return 2280;
+    case MS5xxx_CMD_ADC_2048: return 4540;
+    default                 : return 9040;
+  }
+}
+
+void MS5xxx::startConversion(unsigned char aOSR)
+{
+  osr = aOSR;
+  adcD1 = 0;
+  adcD2 = 0;
+  start_adc(MS5xxx_CMD_ADC_D2+osr);
+  state = MS5xxx_STATE_D2;
+}
+
+void MS5xxx::stopConversion()
+{
+  state = MS5xxx_STATE_IDLE;
+}
+
+bool MS5xxx::poll()
+{
+  if(state == MS5xxx_STATE_IDLE) return false;
+  if(micros() - convStart < conv_time(osr)) return false;
+
+  // the ADC reads back as 0 if the conversion was interrupted, in which case
+  // the previous value is kept and the other conversion carries on
+  unsigned long value = read_adc_result();
+
+  // leave recovery to the caller, which has to reset the sensor
+  if(busError) {
+    state = MS5xxx_STATE_IDLE;
+    return false;
+  }
+
+  // start the other conversion straight away so the sensor is never idle.
+  // pressure and temperature alternate, and each finished pressure is
+  // combined with the most recent temperature. a finished temperature only
+  // waits for the next pressure, so each pressure is reported once.
+  if(state == MS5xxx_STATE_D2) {
+    if(value) adcD2 = value;
+    start_adc(MS5xxx_CMD_ADC_D1+osr);
+    state = MS5xxx_STATE_D1;
+    return false;
+  }
+
+  if(value) adcD1 = value;
+  start_adc(MS5xxx_CMD_ADC_D2+osr);
+  state = MS5xxx_STATE_D2;
+
+  if(value == 0 || !isReady()) return false;
+
+  calculate(adcD1, adcD2);
+  return true;
+}
+
+bool MS5xxx::isReady()
+{
+  return adcD1 != 0 && adcD2 != 0;
+}
+
+bool MS5xxx::BusError()
+{
+  return busError;
+}
+
+unsigned long MS5xxx::GetBusErrors()
+{
+  return busErrors;
+}
+
+const MS5xxx_Calibration& MS5xxx::GetCalibration() const
+{
+  return cal;
+}
+
 void MS5xxx::Readout() {
 	unsigned long D1=0, D2=0;
-	
-	double dT;
-	double OFF;
-	double SENS;
 
 	D2=read_adc(MS5xxx_CMD_ADC_D2+MS5xxx_CMD_ADC_4096);
 	D1=read_adc(MS5xxx_CMD_ADC_D1+MS5xxx_CMD_ADC_4096);
 
+	calculate(D1, D2);
+}
+
+void MS5xxx::calculate(unsigned long D1, unsigned long D2) {
+	Compensate(cal, D1, D2, &P, &TEMP);
+}
+
+// MS5607 first and second order compensation in integer arithmetic, exactly
+// as given in the datasheet. D1 and D2 are 24 bit ADC readings. Pressure comes
+// out in Pa and temperature in hundredths of a degree C.
+void MS5xxx::Compensate(const MS5xxx_Calibration &cal, uint32_t D1, uint32_t D2, int32_t *pressure, int32_t *temperature) {
 	// calculate 1st order pressure and temperature (MS5607 1st order algorithm)
-	dT=D2-C[5]*pow(2,8);
-	OFF=C[2]*pow(2,17)+dT*C[4]/pow(2,6);
-	SENS=C[1]*pow(2,16)+dT*C[3]/pow(2,7);
-	TEMP=(2000+(dT*C[6])/pow(2,23));
-	P=(((D1*SENS)/pow(2,21)-OFF)/pow(2,15));
-	 
+	int32_t dT = (int32_t)D2 - ((int32_t)cal.T_REF << 8);
+	int32_t temp = 2000 + (int32_t)(((int64_t)dT * cal.TEMPSENS) >> 23);
+	int64_t off = ((int64_t)cal.OFF_T1 << 17) + (((int64_t)cal.TCO * dT) >> 6);
+	int64_t sens = ((int64_t)cal.SENS_T1 << 16) + (((int64_t)cal.TCS * dT) >> 7);
+
 	// perform higher order corrections
-	double T2=0., OFF2=0., SENS2=0.;
-	if(TEMP<2000) {
-	  T2=dT*dT/pow(2,31);
-	  OFF2=61*(TEMP-2000)*(TEMP-2000)/pow(2,4);
-	  SENS2=2*(TEMP-2000)*(TEMP-2000);
-	  if(TEMP<-1500) {
-	    OFF2+=15*(TEMP+1500)*(TEMP+1500);
-	    SENS2+=8*(TEMP+1500)*(TEMP+1500);
+	if(temp < 2000) {
+	  int32_t t2 = (int32_t)(((int64_t)dT * dT) >> 31);
+	  int64_t low = (int64_t)(temp - 2000) * (temp - 2000);
+	  int64_t off2 = (61 * low) >> 4;
+	  int64_t sens2 = 2 * low;
+	  if(temp < -1500) {
+	    int64_t veryLow = (int64_t)(temp + 1500) * (temp + 1500);
+	    off2 += 15 * veryLow;
+	    sens2 += 8 * veryLow;
 	  }
+
+	  temp -= t2;
+	  off -= off2;
+	  sens -= sens2;
 	}
-	  
-	TEMP-=T2;
-	OFF-=OFF2;
-	SENS-=SENS2;
-	P=(((D1*SENS)/pow(2,21)-OFF)/pow(2,15));	
+
+	*temperature = temp;
+	*pressure = (int32_t)((((int64_t)D1 * sens >> 21) - off) >> 15);
 }
 
 double MS5xxx::GetTemp() {
@@ -193,6 +338,14 @@ double MS5xxx::GetPres() {
 	return P;
 }
 
+int32_t MS5xxx::GetTempCenti() {
+	return TEMP;
+}
+
+int32_t MS5xxx::GetPresPa() {
+	return P;
+}
+
 unsigned char MS5xxx::CRCcodeTest(){
 	unsigned int nprom[] = {0x3132,0x3334,0x3536,0x3738,0x3940,0x4142,0x4344,0x4500}; //expected output is 0xB
 	for(uint8_t i=0;i<8;i++) {
@@ -42,17 +42,45 @@
 #define MS5xxx_CMD_ADC_4096 0x08    // set ADC oversampling ratio to 4096
 #define MS5xxx_CMD_PROM_RD  0xA0    // initiate readout of PROM registers
 
+// states of the non-blocking conversion
+#define MS5xxx_STATE_IDLE   0       // no conversion running
+#define MS5xxx_STATE_D2     1       // temperature conversion running
+#define MS5xxx_STATE_D1     2       // pressure conversion running
+
+// calibration coefficients C1-C6 from the PROM, named as in the datasheet
+typedef struct MS5xxx_Calibration {
+	uint16_t SENS_T1;   // C1 pressure sensitivity
+	uint16_t OFF_T1;    // C2 pressure offset
+	uint16_t TCS;       // C3 temperature coefficient of pressure sensitivity
+	uint16_t TCO;       // C4 temperature coefficient of pressure offset
+	uint16_t T_REF;     // C5 reference temperature
+	uint16_t TEMPSENS;  // C6 temperature coefficient of the temperature
+} MS5xxx_Calibration;
+
 class MS5xxx
 {
   protected:
 	unsigned int C[8];
-	double P;
-	double TEMP;
+	MS5xxx_Calibration cal;
+	bool busError;
+	unsigned long busErrors;
+	int32_t P;        // Pa
+	int32_t TEMP;     // 0.01 degrees C
 	char i2caddr;
 	TwoWire *_Wire;
 	
+	unsigned char state;
+	unsigned char osr;
+	unsigned long convStart;
+	unsigned long adcD1;
+	unsigned long adcD2;
+	
 	unsigned char send_cmd(unsigned char aCMD);
 	unsigned long read_adc(unsigned char aCMD);
+	void start_adc(unsigned char aCMD);
+	unsigned long read_adc_result();
+	unsigned long conv_time(unsigned char aOSR);
+	void calculate(unsigned long D1, unsigned long D2);
 	
   public:
     MS5xxx();
@@ -60,9 +88,23 @@ class MS5xxx
     void setI2Caddr(char aAddr);
     byte connect();
     
-    void ReadProm();
+    bool ReadProm();
     void Readout();
 
+    // non-blocking readout: startConversion() kicks off a D2/D1 cycle and
+    // poll() advances it once the running conversion has had time to finish,
+    // returning true whenever a new pressure has been read and compensated
+    // with the latest temperature
+    void startConversion(unsigned char aOSR=MS5xxx_CMD_ADC_4096);
+    void stopConversion();
+    bool poll();
+    bool isReady();
+
+    // set when a transfer fails, cleared by a successful ReadProm()
+    bool BusError();
+    unsigned long GetBusErrors();
+    const MS5xxx_Calibration& GetCalibration() const;
+
     unsigned int Calc_CRC4(unsigned char poly=0x30);
     unsigned int Read_CRC4();
     unsigned char CRCcodeTest();
@@ -71,6 +113,10 @@ class MS5xxx
     
     double GetTemp();
     double GetPres();
+    int32_t GetTempCenti();
+    int32_t GetPresPa();
+
+    static void Compensate(const MS5xxx_Calibration &cal, uint32_t D1, uint32_t D2, int32_t *pressure, int32_t *temperature);
 };
 
 #endif
@@ -332,7 +332,7 @@ boolean callback_rmdir(SdFile& parentDir, char *filePathComponent,
 
 
 
-boolean SDClass::begin(uint8_t csPin) {
+boolean SDClass::begin(uint8_t csPin, uint8_t sckRateID) {
   /*
 
     Performs the initialisation required by the sdfatlib library.
@@ -340,7 +340,7 @@ boolean SDClass::begin(uint8_t csPin) {
     Return true if initialization succeeds, false otherwise.
 
    */
-  return card.init(SPI_HALF_SPEED, csPin) &&
+  return card.init(sckRateID, csPin) &&
          volume.init(card) &&
          root.openRoot(volume);
 }
@@ -562,6 +562,19 @@ boolean SDClass::remove(char *filepath) {
   return walkPath(filepath, root, callback_remove);
 }
 
+boolean SDClass::createContiguous(SdFile &file, const char *filename, uint32_t size) {
+  /*
+
+     Create and open a new file of `size` bytes in the root directory with
+     all of its clusters allocated back to back.
+
+     Fails if the file already exists or there is no free run of clusters
+     large enough.
+
+   */
+  return file.createContiguous(&root, filename, size);
+}
+
 
 // allows you to recurse into a directory
 File File::openNextFile(uint8_t mode) {
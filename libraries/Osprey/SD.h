@@ -64,8 +64,9 @@ private:
   SdFile getParentDir(const char *filepath, int *indx);
 public:
   // This needs to be called to set up the connection to the SD card
-  // before other methods are used.
-  boolean begin(uint8_t csPin = SD_CHIP_SELECT_PIN);
+  // before other methods are used. The card is always identified at a low
+  // clock rate, sckRateID sets the rate used afterwards.
+  boolean begin(uint8_t csPin = SD_CHIP_SELECT_PIN, uint8_t sckRateID = SPI_HALF_SPEED);
   
   // Open the specified file/directory with the supplied mode (e.g. read or
   // write, etc). Returns a File object for interacting with the file.
@@ -89,6 +90,13 @@ public:
   boolean rmdir(char *filepath);
   boolean rmdir(const String &filepath) { return rmdir(filepath.c_str()); }
 
+  // Create a new file in the root directory whose clusters are contiguous on
+  // the card, so that it can be written with raw multiple block writes.
+  boolean createContiguous(SdFile &file, const char *filename, uint32_t size);
+
+  // The underlying card, for raw block access to contiguous files.
+  Sd2Card &sdCard() { return card; }
+
 private:
 
   // This is used to determine the mode used to open a file
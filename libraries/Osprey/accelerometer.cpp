@@ -5,6 +5,14 @@
 
 Adafruit_BNO055 Accelerometer::bno = Adafruit_BNO055(55);
 
+static float accelerationMagnitude(kalman_value_t x, kalman_value_t y, kalman_value_t z) {
+#if FIXED_POINT_MATH
+  return Osprey::fixedNorm(x, y, z).toFloat();
+#else
+  return sqrt(x * x + y * y + z * z);
+#endif
+}
+
 Accelerometer::Accelerometer() : Sensor(KALMAN_PROCESS_NOISE, KALMAN_MEASUREMENT_NOISE, KALMAN_ERROR) {
   roll = kalmanInit(0);
   pitch = kalmanInit(90);
@@ -28,53 +36,103 @@ int Accelerometer::init() {
   return bno.begin();
 }
 
-float Accelerometer::getRoll() {
-  sensors_vec_t orientation;
-  getAccelOrientation(&orientation);
+void Accelerometer::sample(SensorFrame *frame) {
+  // The whole IMU state comes from one burst read, everything else is derived.
+  // If the read fails the frame keeps the previous IMU values.
+  Adafruit_BNO055::adafruit_bno055_motion_t motion;
+  if(!bno.readAllMotionData(&motion)) {
+    return;
+  }
+
+  // The filters and magnitude take the raw counts, so fixed point builds
+  // don't go through float on the way in
+  kalman_value_t x = kalmanRatio(motion.accelRaw[0], ACCEL_LSB);
+  kalman_value_t y = kalmanRatio(motion.accelRaw[1], ACCEL_LSB);
+  kalman_value_t z = kalmanRatio(motion.accelRaw[2], ACCEL_LSB);
+
+  imu::Vector<3> xyz = filterAcceleration(x, y, z, frame->timestamp);
+  frame->acceleration[0] = xyz[0];
+  frame->acceleration[1] = xyz[1];
+  frame->acceleration[2] = xyz[2];
+  frame->accelerationG = accelerationMagnitude(x, y, z) * MS2_TO_G;
+
+  sensors_event_t accel;
+  accel.acceleration.x = motion.accel.x();
+  accel.acceleration.y = motion.accel.y();
+  accel.acceleration.z = motion.accel.z();
+
+  // Attitude comes from the on-chip fusion and is only turned into angles
+  // if something asks for them (see attitude.h)
+  frame->quaternion[0] = motion.quat.w();
+  frame->quaternion[1] = motion.quat.x();
+  frame->quaternion[2] = motion.quat.y();
+  frame->quaternion[3] = motion.quat.z();
+  frame->gravity[0] = motion.gravity.x();
+  frame->gravity[1] = motion.gravity.y();
+  frame->gravity[2] = motion.gravity.z();
+  frame->derived = 0;
+
+  // The gravity vector points up like the accelerometer at rest, so the
+  // component of acceleration along it, less g, is the rocket's own
+  // vertical acceleration whatever its attitude
+  float g = motion.gravity.magnitude();
+  if(g > 0) {
+    frame->verticalAcceleration = (accel.acceleration.x * motion.gravity.x() +
+                                   accel.acceleration.y * motion.gravity.y() +
+                                   accel.acceleration.z * motion.gravity.z()) / g - g;
+  }
 
-  if(!orientation.roll) {
+  frame->fresh |= FRAME_IMU;
+}
+
+float Accelerometer::filterAngle(kalman_t *filter, float angle) {
+  if(!angle) {
     return NO_DATA;
   }
 
-  kalmanUpdate(&roll, orientation.roll);
-  return roll.value;
+  kalmanUpdate(filter, kalman_value_t(angle));
+  return kalmanValue(filter);
 }
 
-float Accelerometer::getPitch() {
+float Accelerometer::getRoll() {
   sensors_vec_t orientation;
   getAccelOrientation(&orientation);
 
-  if(!orientation.pitch) {
-    return NO_DATA;
-  }
+  return filterAngle(&roll, orientation.roll);
+}
 
-  kalmanUpdate(&pitch, orientation.pitch);
-  return pitch.value;
+float Accelerometer::getPitch() {
+  sensors_vec_t orientation;
+  getAccelOrientation(&orientation);
+
+  return filterAngle(&pitch, orientation.pitch);
 }
 
 float Accelerometer::getHeading() {
   sensors_vec_t orientation;
   getMagOrientation(&orientation);
 
-  if(!orientation.heading) {
-    return NO_DATA;
-  }
-
-  kalmanUpdate(&heading, orientation.heading);
-  return heading.value;
+  return filterAngle(&heading, orientation.heading);
 }
 
 
 imu::Vector<3> Accelerometer::getAccelerationVec(unsigned long const curTime) {
   sensors_event_t event;
   bno.getOspreyEvent(&event, Adafruit_BNO055::VECTOR_ACCELEROMETER);
-  kalmanUpdate(&accelerationX, event.acceleration.x);
-  kalmanUpdate(&accelerationY, event.acceleration.y);
-  kalmanUpdate(&accelerationZ, event.acceleration.z);
+
+  return filterAcceleration(kalman_value_t(event.acceleration.x),
+                            kalman_value_t(event.acceleration.y),
+                            kalman_value_t(event.acceleration.z), curTime);
+}
+
+imu::Vector<3> Accelerometer::filterAcceleration(kalman_value_t x, kalman_value_t y, kalman_value_t z, unsigned long const curTime) {
+  kalmanUpdate(&accelerationX, x);
+  kalmanUpdate(&accelerationY, y);
+  kalmanUpdate(&accelerationZ, z);
   imu::Vector<3> xyz;
-  xyz[0] = accelerationX.value;
-  xyz[1] = accelerationY.value;
-  xyz[2] = accelerationZ.value;
+  xyz[0] = kalmanValue(&accelerationX);
+  xyz[1] = kalmanValue(&accelerationY);
+  xyz[2] = kalmanValue(&accelerationZ);
 
 
   oldAccel = newAccel;
@@ -132,17 +190,23 @@ float Accelerometer::getAccelerationG() {
   sensors_event_t event;
   bno.getOspreyEvent(&event, Adafruit_BNO055::VECTOR_ACCELEROMETER);
 
-  return sqrt(pow(event.acceleration.x, 2) + pow(event.acceleration.y, 2) + pow(event.acceleration.z, 2)) * MS2_TO_G;
+  return accelerationMagnitude(kalman_value_t(event.acceleration.x),
+                               kalman_value_t(event.acceleration.y),
+                               kalman_value_t(event.acceleration.z)) * MS2_TO_G;
 }
 
 void Accelerometer::getAccelOrientation(sensors_vec_t *orientation) {
   sensors_event_t event;
   bno.getOspreyEvent(&event, Adafruit_BNO055::VECTOR_ACCELEROMETER);
 
+  accelOrientation(&event, orientation);
+}
+
+void Accelerometer::accelOrientation(sensors_event_t *event, sensors_vec_t *orientation) {
   float t_pitch;
   float t_roll;
   float t_heading;
-  float signOfZ = event.acceleration.z >= 0 ? 1.0F : -1.0F;
+  float signOfZ = event->acceleration.z >= 0 ? 1.0F : -1.0F;
 
   /* roll: Rotation around the longitudinal axis (the plane body, 'X axis'). -90<=roll<=90    */
   /* roll is positive and increasing when moving downward                                     */
@@ -152,8 +216,8 @@ void Accelerometer::getAccelOrientation(sensors_vec_t *orientation) {
   /*                          sqrt(x^2 + z^2)                                                 */
   /* where:  x, y, z are returned value from accelerometer sensor                             */
 
-  t_roll = event.acceleration.x * event.acceleration.x + event.acceleration.z * event.acceleration.z;
-  orientation->roll = (float)atan2(event.acceleration.y, sqrt(t_roll)) * 180 / PI;
+  t_roll = event->acceleration.x * event->acceleration.x + event->acceleration.z * event->acceleration.z;
+  orientation->roll = (float)atan2(event->acceleration.y, sqrt(t_roll)) * 180 / PI;
 
   /* pitch: Rotation around the lateral axis (the wing span, 'Y axis'). -180<=pitch<=180)     */
   /* pitch is positive and increasing when moving upwards                                     */
@@ -163,13 +227,18 @@ void Accelerometer::getAccelOrientation(sensors_vec_t *orientation) {
   /*                          sqrt(y^2 + z^2)                                                 */
   /* where:  x, y, z are returned value from accelerometer sensor                             */
 
-  t_pitch = event.acceleration.y * event.acceleration.y + event.acceleration.z * event.acceleration.z;
-  orientation->pitch = (float)atan2(event.acceleration.x, signOfZ * sqrt(t_pitch)) * 180 / PI;
+  t_pitch = event->acceleration.y * event->acceleration.y + event->acceleration.z * event->acceleration.z;
+  orientation->pitch = (float)atan2(event->acceleration.x, signOfZ * sqrt(t_pitch)) * 180 / PI;
 
 }
 
 void Accelerometer::getMagOrientation(sensors_vec_t *orientation) {
   sensors_event_t event;
   bno.getOspreyEvent(&event, Adafruit_BNO055::VECTOR_MAGNETOMETER);
-  orientation->heading = (float)atan2(event.magnetic.z, event.magnetic.y) * 180 / PI;
+
+  magOrientation(&event, orientation);
+}
+
+void Accelerometer::magOrientation(sensors_event_t *event, sensors_vec_t *orientation) {
+  orientation->heading = (float)atan2(event->magnetic.z, event->magnetic.y) * 180 / PI;
 }
@@ -6,6 +6,7 @@
 #include <math.h>
 
 #include "constants.h"
+#include "frame.h"
 #include "kalman.h"
 #include "sensor.h"
 
@@ -13,11 +14,15 @@
 #define KALMAN_MEASUREMENT_NOISE 0.25
 #define KALMAN_ERROR 1
 
+#define ACCEL_LSB 100 // BNO055 counts per m/s^2
+
 class Accelerometer : public virtual Sensor {
   public:
     Accelerometer();
     int init();
 
+    void sample(SensorFrame *frame);
+
     /* Begin externally used funcs */
     float getRoll();
     float getPitch();
@@ -44,6 +49,11 @@ class Accelerometer : public virtual Sensor {
 
     unsigned long getDt();
 
+    imu::Vector<3> filterAcceleration(kalman_value_t x, kalman_value_t y, kalman_value_t z, unsigned long const curTime);
+    float filterAngle(kalman_t *filter, float angle);
+    void accelOrientation(sensors_event_t *event, sensors_vec_t *orientation);
+    void magOrientation(sensors_event_t *event, sensors_vec_t *orientation);
+
     unsigned long const UL_MAX = 4294967295;
 
     kalman_t roll;
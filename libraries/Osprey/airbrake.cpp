@@ -1,107 +1,129 @@
-#include <math.h>
+#include "airbrake.h"
+#include "integrator.h"
 
-struct Vector3D
+/* Density model parameters: band start and end, reference height (km),
+*  reference density (kg/m^3) and scale height (km)
+*  Ref: Fundamentals of Spacecraft Attitude Determinal and Control
+*       Crassidis, pg 406 & 407 (Eq. 11.10 and Table 11.1) */
+static constexpr float parameters[36][5] =
+{{  0 , h_LOW_BAND_TOP, 0, RHO_SEA_LEVEL, SCALE_HEIGHT_LOW},
+ { 25 ,  30 ,  25 , 3.899e-2  , 6.49},
+ { 30 ,  35 ,  30 , 1.774e-2  , 6.75},
+ { 35 ,  40 ,  35 , 8.279e-3  , 7.07},
+ { 40 ,  45 ,  40 , 3.972e-3  , 7.47},
+ { 45 ,  50 ,  45 , 1.995e-3  , 7.83},
+ { 50 ,  55 ,  50 , 1.057e-3  , 7.95},
+ { 55 ,  60 ,  55 , 5.821e-4  , 7.73},
+ { 60 ,  65 ,  60 , 3.206e-4  , 7.29},
+ { 65 ,  70 ,  65 , 1.718e-4  , 6.81},
+ { 70 ,  75 ,  70 , 8.770e-5  , 6.33},
+ { 75 ,  80 ,  75 , 4.178e-5  , 6.00},
+ { 80 ,  85 ,  80 , 1.905e-5  , 5.70},
+ { 85 ,  90 ,  85 , 8.337e-6  , 5.41},
+ { 90 ,  95 ,  90 , 3.396e-6  , 5.38},
+ { 95 , 100 ,  95 , 1.343e-6  , 5.74},
+ { 100,  110,  100, 5.297e-7 ,  6.15},
+ { 110,  120,  110, 9.661e-8 ,  8.06},
+ { 120,  130,  120, 2.438e-8 ,  11.6},
+ { 130,  140,  130, 8.484e-9 ,  16.1},
+ { 140,  150,  140, 3.845e-9 ,  20.6},
+ { 150,  160,  150, 2.070e-9 ,  24.6},
+ { 160,  180,  160, 1.224e-9 ,  26.3},
+ { 180,  200,  180, 5.464e-10,  33.2},
+ { 200,  250,  200, 2.789e-10,  38.5},
+ { 250,  300,  250, 7.248e-11,  46.9},
+ { 300,  350,  300, 2.418e-11,  52.5},
+ { 350,  400,  350, 9.158e-12,  56.4},
+ { 400,  450,  400, 3.725e-12,  59.4},
+ { 450,  500,  450, 1.585e-12,  62.2},
+ { 500,  600,  500, 6.967e-13,  65.8},
+ { 600,  700,  600, 1.454e-13,  79.0},
+ { 700,  800,  700, 3.614e-14, 109.0},
+ { 800,  900,  800, 1.170e-14, 164.0},
+ { 900, 1000,  900, 5.245e-15, 225.0},
+ {1000 , 1000, 1000, 3.019e-15, 268.0}};
+
+/* e^x by its Taylor series, only ever evaluated at compile time */
+static constexpr double constexpr_exp(double x, int n = 1, double term = 1, double sum = 1)
 {
-  Vector3D(float a, float b, float c) : x(a), y(b), z(c) {}
-  Vector3D() {}
-  float x;
-  float y;
-  float z;
-  float norm()
-  { 
-    return sqrt((x*x)+(y*y)+(z*z)); 
-  }
-};
+  return n > 40 ? sum : constexpr_exp(x, n + 1, term * x / n, sum + term * x / n);
+}
 
-struct StateVector {
-  StateVector(float a, Vector3D s, float d) : height(a), vec(s), balCoeff(d) {}
-  StateVector() {}
-  float height;
-  Vector3D vec;
-  float balCoeff;
+/* Density through the lowest band, where the rocket actually flies, every
+*  DENSITY_STEP km. Between entries it is finished off with a short Taylor
+*  series, which is good to 4e-8 relative over half a step. */
+#define DENSITY_STEP 0.5f // in km
+#define DENSITY_ENTRIES 51
+#define DENSITY_EXP(i) ((float)(parameters[0][3] * constexpr_exp(-(i) * (double)DENSITY_STEP / parameters[0][4])))
+
+static constexpr float density_table[DENSITY_ENTRIES] = {
+  DENSITY_EXP(0), DENSITY_EXP(1), DENSITY_EXP(2), DENSITY_EXP(3), DENSITY_EXP(4),
+  DENSITY_EXP(5), DENSITY_EXP(6), DENSITY_EXP(7), DENSITY_EXP(8), DENSITY_EXP(9),
+  DENSITY_EXP(10), DENSITY_EXP(11), DENSITY_EXP(12), DENSITY_EXP(13), DENSITY_EXP(14),
+  DENSITY_EXP(15), DENSITY_EXP(16), DENSITY_EXP(17), DENSITY_EXP(18), DENSITY_EXP(19),
+  DENSITY_EXP(20), DENSITY_EXP(21), DENSITY_EXP(22), DENSITY_EXP(23), DENSITY_EXP(24),
+  DENSITY_EXP(25), DENSITY_EXP(26), DENSITY_EXP(27), DENSITY_EXP(28), DENSITY_EXP(29),
+  DENSITY_EXP(30), DENSITY_EXP(31), DENSITY_EXP(32), DENSITY_EXP(33), DENSITY_EXP(34),
+  DENSITY_EXP(35), DENSITY_EXP(36), DENSITY_EXP(37), DENSITY_EXP(38), DENSITY_EXP(39),
+  DENSITY_EXP(40), DENSITY_EXP(41), DENSITY_EXP(42), DENSITY_EXP(43), DENSITY_EXP(44),
+  DENSITY_EXP(45), DENSITY_EXP(46), DENSITY_EXP(47), DENSITY_EXP(48), DENSITY_EXP(49),
+  DENSITY_EXP(50)
 };
 
-Vector3D const I_Z = Vector3D(0,0,1);
-
-/* Preliminaries */
-float const TIME = 0; // in seconds
-float const DT = 0.1; // in seconds
-float const T_FINAL = 60; // in seconds
-float const GRAV = 9.81; // in m/s^2
-float const TOLERANCE = 1e-10;
-
-float const Cd_OPEN = 0.80;
-float const Cd_CLOSED = 0.75;
-float const AREA_BRAKES = 0.0332438045; // in sq. meters
-float const A_ref_CLOSED = 0.0192; // in sq. meters
-float const A_ref_OPEN = A_ref_CLOSED + AREA_BRAKES; // in sq. meters
-float const MASS_ROCKET = 17.9000; // in Kg
-
-float const h_TARGET = 3000; // in meters
-
+/* Which band of the parameter table a height falls in. The bands are evenly
+*  spaced up to 160 km so only the thin air above needs a search. A height on
+*  the boundary between two bands belongs to the upper one. */
+static int density_band(float h)
+{
+  if (h < h_LOW_BAND_TOP)
+  {
+    return 0;
+  }
+  if (h < 100)
+  {
+    return 1 + (int)((h - 25) / 5);
+  }
+  if (h < 160)
+  {
+    return 16 + (int)((h - 100) / 10);
+  }
 
+  int band = 22;
+  while (band < 35 && h >= parameters[band][1])
+  {
+    ++band;
+  }
+  return band;
+}
 
-/* Calculates whether or not the satellite is in eclipse.
-* input: h - height above the ellipsoid 
-* output: rho - atmospheric density, in kg/m^3
-*  Ref: Fundamentals of Spacecraft Attitude Determinal and Control
-*       Crassidis, pg 406 & 407 (Eq. 11.10 and Table 11.1) */
+/* Calculates the atmospheric density.
+* input: h - height above the ellipsoid, in km
+* output: rho - atmospheric density, in kg/m^3 */
 float Exponentially_Decaying_Density_Model(float h)
 {
-   float parameters[36][5] =
-   {{  0 ,  25 ,   0 , 1.225     , 8.44},
-    { 25 ,  30 ,  25 , 3.899e-2  , 6.49},
-    { 30 ,  35 ,  30 , 1.774e-2  , 6.75},
-    { 35 ,  40 ,  35 , 8.279e-3  , 7.07},
-    { 40 ,  45 ,  40 , 3.972e-3  , 7.47},
-    { 45 ,  50 ,  45 , 1.995e-3  , 7.83},
-    { 50 ,  55 ,  50 , 1.057e-3  , 7.95},
-    { 55 ,  60 ,  55 , 5.821e-4  , 7.73},
-    { 60 ,  65 ,  60 , 3.206e-4  , 7.29},
-    { 65 ,  70 ,  65 , 1.718e-4  , 6.81},
-    { 70 ,  75 ,  70 , 8.770e-5  , 6.33},
-    { 75 ,  80 ,  75 , 4.178e-5  , 6.00},
-    { 80 ,  85 ,  80 , 1.905e-5  , 5.70},
-    { 85 ,  90 ,  85 , 8.337e-6  , 5.41},
-    { 90 ,  95 ,  90 , 3.396e-6  , 5.38},
-    { 95 , 100 ,  95 , 1.343e-6  , 5.74},
-    { 100,  110,  100, 5.297e-7 ,  6.15},
-    { 110,  120,  110, 9.661e-8 ,  8.06},
-    { 120,  130,  120, 2.438e-8 ,  11.6},
-    { 130,  140,  130, 8.484e-9 ,  16.1},
-    { 140,  150,  140, 3.845e-9 ,  20.6},
-    { 150,  160,  150, 2.070e-9 ,  24.6},
-    { 160,  180,  160, 1.224e-9 ,  26.3},
-    { 180,  200,  180, 5.464e-10,  33.2},
-    { 200,  250,  200, 2.789e-10,  38.5},
-    { 250,  300,  250, 7.248e-11,  46.9},
-    { 300,  350,  300, 2.418e-11,  52.5},
-    { 350,  400,  350, 9.158e-12,  56.4},
-    { 400,  450,  400, 3.725e-12,  59.4},
-    { 450,  500,  450, 1.585e-12,  62.2},
-    { 500,  600,  500, 6.967e-13,  65.8},
-    { 600,  700,  600, 1.454e-13,  79.0},
-    { 700,  800,  700, 3.614e-14, 109.0},
-    { 800,  900,  800, 1.170e-14, 164.0},
-    { 900, 1000,  900, 5.245e-15, 225.0},
-    {1000 , 1000, 1000, 3.019e-15, 268.0}};
-
-  /* Initialize the atmosphere density model parameters */
-  float h_0   = 0.0; // reference height, in km
-  float rho_0 = 0.0; // reference density, in kg/m^3
-  float H     = 0.0; // scale height, in km
-
-  /* Compute the atmosphere density */
-  for (auto counter = 0u; counter < 36; ++counter)
-  { 
-      if( h >= parameters[counter][0] && h <= parameters[counter][1])
-      {
-          h_0 = parameters[counter][2]; // reference height, in km
-          rho_0 = parameters[counter][3]; //reference density, in kg/m^3
-          H = parameters[counter][4]; // scale height, in km
-      }
+  if (h < 0)
+  {
+    h = 0;
   }
 
+  if (h < h_LOW_BAND_TOP)
+  {
+    int i = (int)(h * (1 / DENSITY_STEP) + 0.5f);
+    float x = (i * DENSITY_STEP - h) * (1 / parameters[0][4]);
+    return density_table[i] * (1 + x * (1 + x * (0.5f + x * (1.0f / 6))));
+  }
+
+  /* Nothing is modelled above the last band */
+  if (h > parameters[35][1])
+  {
+    return 0;
+  }
+
+  int band = density_band(h);
+  float h_0 = parameters[band][2];   // reference height, in km
+  float rho_0 = parameters[band][3]; // reference density, in kg/m^3
+  float H = parameters[band][4];     // scale height, in km
+
   return rho_0*exp(-(h-h_0)/H); // atmospheric density, in kg/m^3
 }
 
@@ -170,30 +192,51 @@ StateVector Truth_prop_state_rk45(StateVector xold, float t, float dt)
   return add(y,mult(h6,(add(dydx,add(dyt,mult(2,dym))))));
 }
 
-void gen_traj_nom(StateVector* nominal_x, StateVector x, float t)
+static float componentError(float error, float x0, float x1, float rtol, float atol)
+{
+  float scale = atol + rtol * fmax(fabs(x0), fabs(x1));
+  return fabs(error) / scale;
+}
+
+float errorNorm(StateVector error, StateVector x0, StateVector x1, float rtol, float atol)
+{
+  float norm = componentError(error.height, x0.height, x1.height, rtol, atol);
+  norm = fmax(norm, componentError(error.vec.x, x0.vec.x, x1.vec.x, rtol, atol));
+  norm = fmax(norm, componentError(error.vec.y, x0.vec.y, x1.vec.y, rtol, atol));
+  norm = fmax(norm, componentError(error.vec.z, x0.vec.z, x1.vec.z, rtol, atol));
+  return fmax(norm, componentError(error.balCoeff, x0.balCoeff, x1.balCoeff, rtol, atol));
+}
+
+/* Samples the trajectory every DT until T_FINAL, or until capacity samples
+*  have been written. The integrator takes whatever steps the error allows and
+*  the samples come from its dense output.
+*  output: the number of samples written, starting with x itself */
+int gen_traj_nom(StateVector* nominal_x, int capacity, StateVector x, float t)
 {
-  float h = x.height;
-  Vector3D v = x.vec;
-  float beta = x.balCoeff;
-  float dt = DT;
-  unsigned int total_counter = 0;
-  nominal_x[0] = x;
-
-  while (t < T_FINAL)
+  if (capacity <= 0)
+  {
+    return 0;
+  }
+
+  Osprey::DormandPrince<StateVector, StateVector (*)(StateVector, float)> integrator(Truth_gravdiffeq_air_brake, RTOL, ATOL, DT);
+  float t_start = t;
+  int count = 0;
+  nominal_x[count++] = x;
+
+  while (count < capacity && t < T_FINAL)
   {
-    if (t + dt > T_FINAL)
+    if (!integrator.step(x, t, T_FINAL))
     {
-      dt = T_FINAL - t;
+      break;
     }
-    StateVector xold = x;
-    StateVector xnew = Truth_prop_state_rk45(xold, t, dt);
-    t += dt;
-    ++total_counter;
-    h = xnew.height;
-    v = xnew.vec;
-    beta = xnew.balCoeff;
-    nominal_x[total_counter] = xnew;
-  }
-}
 
+    float t_sample = t_start + count * DT;
+    while (count < capacity && t_sample <= t)
+    {
+      nominal_x[count++] = integrator.interpolate(t_sample);
+      t_sample = t_start + count * DT;
+    }
+  }
 
+  return count;
+}
@@ -0,0 +1,68 @@
+#ifndef AIRBRAKE_H
+#define AIRBRAKE_H
+
+// Point mass trajectory model for the air brakes: gravity plus drag in an
+// exponential atmosphere. Truth_prop_state_rk45 is a single fixed RK4 step;
+// gen_traj_nom uses the adaptive integrator in integrator.h.
+
+#include <math.h>
+
+struct Vector3D
+{
+  Vector3D(float a, float b, float c) : x(a), y(b), z(c) {}
+  Vector3D() {}
+  float x;
+  float y;
+  float z;
+  float norm()
+  { 
+    return sqrt((x*x)+(y*y)+(z*z)); 
+  }
+};
+
+struct StateVector {
+  StateVector(float a, Vector3D s, float d) : height(a), vec(s), balCoeff(d) {}
+  StateVector() {}
+  float height;
+  Vector3D vec;
+  float balCoeff;
+};
+
+Vector3D const I_Z = Vector3D(0,0,1);
+
+/* Preliminaries */
+float const TIME = 0; // in seconds
+float const DT = 0.1; // in seconds
+float const T_FINAL = 60; // in seconds
+float const GRAV = 9.81; // in m/s^2
+float const TOLERANCE = 1e-10;
+float const RTOL = 1e-5; // integrator error per step, relative
+float const ATOL = 1e-3; // and absolute, in the state's units
+
+float const Cd_OPEN = 0.80;
+float const Cd_CLOSED = 0.75;
+float const AREA_BRAKES = 0.0332438045; // in sq. meters
+float const A_ref_CLOSED = 0.0192; // in sq. meters
+float const A_ref_OPEN = A_ref_CLOSED + AREA_BRAKES; // in sq. meters
+float const MASS_ROCKET = 17.9000; // in Kg
+
+float const h_TARGET = 3000; // in meters
+
+/* The lowest band of the density model, which every flight stays inside */
+constexpr float RHO_SEA_LEVEL = 1.225; // in kg/m^3
+constexpr float SCALE_HEIGHT_LOW = 8.44; // in km
+constexpr float h_LOW_BAND_TOP = 25; // in km
+
+// Drag deceleration is rho v^2 times the ballistic coefficient
+float const BAL_COEFF_CLOSED = Cd_CLOSED * A_ref_CLOSED / (2 * MASS_ROCKET); // in m^2/kg
+float const BAL_COEFF_OPEN = Cd_OPEN * A_ref_OPEN / (2 * MASS_ROCKET); // in m^2/kg
+
+float Exponentially_Decaying_Density_Model(float h);
+StateVector Truth_gravdiffeq_air_brake(StateVector x, float t);
+StateVector mult(float c, StateVector v);
+StateVector add(StateVector a, StateVector b);
+StateVector Truth_prop_state_rk45(StateVector xold, float t, float dt);
+float errorNorm(StateVector error, StateVector x0, StateVector x1, float rtol, float atol);
+int gen_traj_nom(StateVector* nominal_x, int capacity, StateVector x, float t);
+
+#endif
@@ -0,0 +1,65 @@
+#include <math.h>
+
+#include "attitude.h"
+
+#define RAD_TO_DEGREES 57.2957795f
+
+static void deriveEuler(SensorFrame *frame) {
+  if(frame->derived & FRAME_EULER) return;
+
+  float w = frame->quaternion[0];
+  float x = frame->quaternion[1];
+  float y = frame->quaternion[2];
+  float z = frame->quaternion[3];
+
+  // Aerospace (z-y-x) sequence
+  float sinPitch = 2 * (w * y - z * x);
+  if(sinPitch > 1) sinPitch = 1;
+  if(sinPitch < -1) sinPitch = -1;
+
+  frame->roll = atan2f(2 * (w * x + y * z), 1 - 2 * (x * x + y * y)) * RAD_TO_DEGREES;
+  frame->pitch = asinf(sinPitch) * RAD_TO_DEGREES;
+  frame->heading = atan2f(2 * (w * z + x * y), 1 - 2 * (y * y + z * z)) * RAD_TO_DEGREES;
+
+  if(frame->heading < 0) {
+    frame->heading += 360;
+  }
+
+  frame->derived |= FRAME_EULER;
+}
+
+float attitudeRoll(SensorFrame *frame) {
+  deriveEuler(frame);
+  return frame->roll;
+}
+
+float attitudePitch(SensorFrame *frame) {
+  deriveEuler(frame);
+  return frame->pitch;
+}
+
+float attitudeHeading(SensorFrame *frame) {
+  deriveEuler(frame);
+  return frame->heading;
+}
+
+float attitudeTilt(SensorFrame *frame) {
+  if(frame->derived & FRAME_TILT) return frame->tilt;
+
+  // Angle between the body axis and straight up. The fused gravity vector
+  // points up in the sensor frame, like an accelerometer at rest.
+  float *g = frame->gravity;
+  float norm = sqrtf(g[0] * g[0] + g[1] * g[1] + g[2] * g[2]);
+
+  if(norm == 0) {
+    frame->tilt = 0;
+  } else {
+    float cosTilt = g[ATTITUDE_VERTICAL_AXIS] / norm;
+    if(cosTilt > 1) cosTilt = 1;
+    if(cosTilt < -1) cosTilt = -1;
+    frame->tilt = acosf(cosTilt) * RAD_TO_DEGREES;
+  }
+
+  frame->derived |= FRAME_TILT;
+  return frame->tilt;
+}
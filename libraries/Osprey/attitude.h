@@ -0,0 +1,19 @@
+#ifndef ATTITUDE_H
+#define ATTITUDE_H
+
+// Attitude from the BNO055's fused (NDOF) orientation. Unlike angles from the
+// raw accelerometer these stay valid under thrust. Nothing is worked out when
+// the frame is acquired; each value is computed the first time it is asked
+// for and then cached in the frame until the next IMU sample.
+
+#include "frame.h"
+
+// Sensor axis along the rocket body, pointing towards the nose
+#define ATTITUDE_VERTICAL_AXIS 0
+
+float attitudeRoll(SensorFrame *frame);
+float attitudePitch(SensorFrame *frame);
+float attitudeHeading(SensorFrame *frame);
+float attitudeTilt(SensorFrame *frame);
+
+#endif
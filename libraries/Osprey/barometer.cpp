@@ -1,4 +1,5 @@
 #include "barometer.h"
+#include "pressure_table.h"
 
 MS5xxx Barometer::baro = MS5xxx();
 
@@ -6,38 +7,98 @@ MS5xxx Barometer::baro = MS5xxx();
 Barometer::Barometer(TwoWire* wire) : Sensor(KALMAN_PROCESS_NOISE, KALMAN_MEASUREMENT_NOISE, KALMAN_ERROR) {
   baro.setWire(wire);
   altitude = kalmanInit(0);
+  groundLevel = 0;
+#if FIXED_POINT_MATH
+  groundLevelCm = 0;
+#endif
+  groundPressure = NO_DATA;
+  setSeaLevelPressure(DEFAULT_PRESSURE_SETTING * MERCURY_TO_HPA_CONVERSION * 100);
 }
 
 float Barometer::getTemperatureC()
 {
-  return baro.GetTemp() * 100.0;
+  // MS5xxx reports temperature in hundredths of a degree
+  return baro.GetTempCenti() / 100.0;
 }
 
 int Barometer::init() {
-  return (baro.connect() <= 0);
+  if(baro.connect() > 0) {
+    return 0;
+  }
+
+  // The calibration is read and checked once here rather than per sample.
+  // Reading the PROM resets the sensor, so it has to happen before any
+  // conversions are started.
+  if(!baro.ReadProm()) {
+    return 0;
+  }
+  baro.startConversion();
+
+  // Wait for a first sample so the getters have something to return
+  unsigned long start = millis();
+  while(!update()) {
+    if(millis() - start > BARO_INIT_TIMEOUT) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+int Barometer::update() {
+  // A failed transfer may have left the sensor mid-command, so reset it and
+  // reload the calibration before carrying on
+  if(baro.BusError()) {
+    reload();
+    return 0;
+  }
+
+  // Never blocks, the conversions run on the sensor between calls
+  if(!baro.poll()) {
+    return 0;
+  }
+
+#if FIXED_POINT_MATH
+  // Pascals don't fit in Q16.16, so the fixed point filter runs in hPa. The
+  // gain doesn't depend on the measurements, so the output is the same.
+  kalmanUpdate(&altitude, Osprey::Fixed::fromRatio(baro.GetPresPa(), 100));
+#else
+  kalmanUpdate(&altitude, baro.GetPresPa());
+#endif
+  return 1;
+}
+
+int Barometer::reload() {
+  if(!baro.ReadProm()) {
+    return 0;
+  }
+
+  baro.startConversion();
+  return 1;
 }
 
 float Barometer::getPressure() {
-  baro.ReadProm();
-  baro.Readout();
-  kalmanUpdate(&altitude, baro.GetPres());
-  return altitude.value;
+  if(!baro.isReady()) {
+    return NO_DATA;
+  }
+
+#if FIXED_POINT_MATH
+  return kalmanValue(&altitude) * 100;
+#else
+  return kalmanValue(&altitude);
+#endif
 }
 
-float const SEA_LEVEL_PRESSURE_Pa = 101325.0;
-float const EXPONENT = 0.19022256039566293;
 float const TO_KELVIN = 273.15;
-float const DENOM = 0.0065;
- 
+
 float Barometer::getAltitudeAboveSeaLevel() {
   float pressure = getPressure();
-  float temp = getTemperatureC();
 
   if(pressure == NO_DATA) {
     return NO_DATA;
   }
 
-  return (( (pow(SEA_LEVEL_PRESSURE_Pa/pressure,EXPONENT)-1.0)*(temp+TO_KELVIN) )/(DENOM))/1000.0;
+  return pressureToAltitude(pressure, getTemperatureC());
 }
 
 float Barometer::getAltitudeAboveGround() {
@@ -47,7 +108,130 @@ float Barometer::getAltitudeAboveGround() {
     return NO_DATA;
   }
 
-  return getAltitudeAboveSeaLevel() - groundLevel;
+  return pressureToAltitude(pressure, getTemperatureC()) - groundLevel;
+}
+
+float Barometer::pressureToAltitude(float pressure, float temp) {
+#if FIXED_POINT_MATH
+  // The temperature came from hundredths of a degree, so this gets them back
+  return altitudeCm(tablePressure(pressure), (int32_t)lroundf(temp * 100)) * 0.01f;
+#else
+  // ((p0 / p)^0.19 - 1) (T + 273.15) / L, rearranged in terms of the standard
+  // altitudes of p and the sea level pressure p0 so it needs no pow
+  return (standardAltitude(pressure) - seaLevelAltitude) * (temp + TO_KELVIN) * altitudeScale;
+#endif
+}
+
+// Pressure in fixed point, clamped to the table. Near 1 kPa the altitude
+// changes by 20 m/Pa, so it needs plenty of fraction bits.
+uint32_t Barometer::tablePressure(float pressure) {
+  if(pressure < (1UL << PRESSURE_TABLE_FIRST_BAND)) {
+    return 1UL << (PRESSURE_TABLE_FIRST_BAND + PRESSURE_FRACTION_BITS);
+  }
+  if(pressure >= (1UL << (PRESSURE_TABLE_FIRST_BAND + PRESSURE_TABLE_BANDS))) {
+    return (1UL << (PRESSURE_TABLE_FIRST_BAND + PRESSURE_TABLE_BANDS + PRESSURE_FRACTION_BITS)) - 1;
+  }
+  return pressure * (1UL << PRESSURE_FRACTION_BITS);
+}
+
+#if FIXED_POINT_MATH
+float Barometer::standardAltitude(float pressure) {
+  return standardAltitudeCm(tablePressure(pressure)) * 0.01f;
+}
+#else
+float Barometer::standardAltitude(float pressure) {
+  uint32_t scaled = tablePressure(pressure);
+
+  // The highest set bit picks the band, the bits below it the step and the
+  // position within the step
+  int band = 31 - __builtin_clz(scaled) - PRESSURE_FRACTION_BITS;
+  int shift = band + PRESSURE_FRACTION_BITS - PRESSURE_TABLE_STEP_BITS;
+  int entry = ((band - PRESSURE_TABLE_FIRST_BAND) << PRESSURE_TABLE_STEP_BITS) +
+              (int)(scaled >> shift) - (1 << PRESSURE_TABLE_STEP_BITS);
+  float fraction = (scaled & ((1UL << shift) - 1)) * (1.0f / (1UL << shift));
+
+  const float *step = &PRESSURE_TABLE[entry];
+  return step[0] + (step[1] - step[0]) * fraction;
+}
+#endif
+
+#if FIXED_POINT_MATH
+uint32_t Barometer::tablePressure(int32_t pressure) {
+  if(pressure < (1L << PRESSURE_TABLE_FIRST_BAND)) {
+    return 1UL << (PRESSURE_TABLE_FIRST_BAND + PRESSURE_FRACTION_BITS);
+  }
+  if(pressure >= (1L << (PRESSURE_TABLE_FIRST_BAND + PRESSURE_TABLE_BANDS))) {
+    return (1UL << (PRESSURE_TABLE_FIRST_BAND + PRESSURE_TABLE_BANDS + PRESSURE_FRACTION_BITS)) - 1;
+  }
+  return (uint32_t)pressure << PRESSURE_FRACTION_BITS;
+}
+
+// As standardAltitude, in whole centimetres from the integer table. The
+// position within the step is cut to PRESSURE_TABLE_POSITION_BITS so that
+// the product with the step's rise fits in 32 bits, which tools/pressuretable
+// checks.
+int32_t Barometer::standardAltitudeCm(uint32_t scaled) {
+  int band = 31 - __builtin_clz(scaled) - PRESSURE_FRACTION_BITS;
+  int shift = band + PRESSURE_FRACTION_BITS - PRESSURE_TABLE_STEP_BITS;
+  int entry = ((band - PRESSURE_TABLE_FIRST_BAND) << PRESSURE_TABLE_STEP_BITS) +
+              (int)(scaled >> shift) - (1 << PRESSURE_TABLE_STEP_BITS);
+  uint32_t position = scaled & ((1UL << shift) - 1);
+  if(shift >= PRESSURE_TABLE_POSITION_BITS) {
+    position >>= shift - PRESSURE_TABLE_POSITION_BITS;
+  } else {
+    position <<= PRESSURE_TABLE_POSITION_BITS - shift;
+  }
+
+  const int32_t *step = &PRESSURE_TABLE[entry];
+  return step[0] + (((step[1] - step[0]) * (int32_t)position + (1 << (PRESSURE_TABLE_POSITION_BITS - 1))) >>
+                    PRESSURE_TABLE_POSITION_BITS);
+}
+
+// pressureToAltitude in integers. The scale takes the temperature in
+// centikelvin, and the product stays under 2^60 for any altitude in the
+// table.
+int32_t Barometer::altitudeCm(uint32_t pressure, int32_t tempCenti) {
+  int64_t height = (int64_t)(standardAltitudeCm(pressure) - seaLevelAltitudeCm) * (tempCenti + 27315);
+  return (int32_t)((height * altitudeScaleFixed + ((int64_t)1 << (ALTITUDE_SCALE_BITS - 1))) >> ALTITUDE_SCALE_BITS);
+}
+#endif
+
+void Barometer::setSeaLevelPressure(float pressure) {
+  seaLevelAltitude = standardAltitude(pressure);
+  altitudeScale = 1 / (PRESSURE_TABLE_REFERENCE_TEMPERATURE + PRESSURE_TABLE_LAPSE_RATE * seaLevelAltitude);
+
+#if FIXED_POINT_MATH
+  seaLevelAltitudeCm = standardAltitudeCm(tablePressure(pressure));
+  altitudeScaleFixed = llroundf(altitudeScale * 0.01f * (float)((int64_t)1 << ALTITUDE_SCALE_BITS));
+#endif
+
+  // Keep the ground level where it was
+  if(groundPressure != NO_DATA) {
+    groundLevel = pressureToAltitude(groundPressure, getTemperatureC());
+#if FIXED_POINT_MATH
+    groundLevelCm = altitudeCm(tablePressure(groundPressure), baro.GetTempCenti());
+#endif
+  }
+}
+
+int Barometer::sample(SensorFrame *frame) {
+  // Between conversions the frame keeps the previous sample
+  if(!update()) {
+    return 0;
+  }
+
+  frame->pressure = getPressure();
+  frame->temperature = getTemperatureC();
+  // The altitude measurement is left unfiltered for the estimator
+#if FIXED_POINT_MATH
+  frame->altitude = (altitudeCm(tablePressure((int32_t)baro.GetPresPa()), baro.GetTempCenti()) - groundLevelCm) * 0.01f;
+#else
+  frame->altitude = pressureToAltitude(baro.GetPresPa(), frame->temperature) - groundLevel;
+#endif
+  frame->baroTimestamp = frame->timestamp;
+  frame->fresh |= FRAME_BARO;
+
+  return 1;
 }
 
 
@@ -56,6 +240,14 @@ void Barometer::zero() {
 }
 
 
+float Barometer::getGroundLevel() {
+  return groundLevel;
+}
+
 void Barometer::setGroundLevel() {
+  groundPressure = getPressure();
   groundLevel = getAltitudeAboveSeaLevel();
+#if FIXED_POINT_MATH
+  groundLevelCm = altitudeCm(tablePressure(groundPressure), baro.GetTempCenti());
+#endif
 }
@@ -3,6 +3,7 @@
 
 #include <MS5xxx.h>
 #include "constants.h"
+#include "frame.h"
 #include "sensor.h"
 #include <Wire.h>
 
@@ -10,25 +11,52 @@
 #define KALMAN_MEASUREMENT_NOISE 0.25
 #define KALMAN_ERROR 1
 
+#define BARO_INIT_TIMEOUT 100 // ms to wait for the first sample
+#define PRESSURE_FRACTION_BITS 12 // of the pressure used to index the altitude table
+#define ALTITUDE_SCALE_BITS 36 // fraction bits of the fixed point altitude scale
+
 
 class Barometer : public virtual Sensor 
 {
   public:
     Barometer(TwoWire*);
     int init();
+    int update();
+    int sample(SensorFrame *frame);
     float getPressure();
     float getAltitudeAboveSeaLevel(); //
     float getAltitudeAboveGround(); //
     void zero(); // 
     float getTemperatureC();
+    void setSeaLevelPressure(float pressure); // Pa
+    float getGroundLevel(); // m above sea level
 
   protected:
     static MS5xxx baro;
 
     float groundLevel;
+    float groundPressure;   // Pa, when zeroed
+    float seaLevelAltitude; // standard altitude of the sea level pressure
+    float altitudeScale;
     kalman_t altitude;
 
+#if FIXED_POINT_MATH
+    int32_t groundLevelCm;
+    int32_t seaLevelAltitudeCm;
+    int64_t altitudeScaleFixed; // per centikelvin, ALTITUDE_SCALE_BITS of fraction
+#endif
+
     void setGroundLevel();
+    int reload();
+    float pressureToAltitude(float pressure, float temp);
+    static float standardAltitude(float pressure);
+    static uint32_t tablePressure(float pressure);
+
+#if FIXED_POINT_MATH
+    int32_t altitudeCm(uint32_t pressure, int32_t tempCenti);
+    static uint32_t tablePressure(int32_t pressure);
+    static int32_t standardAltitudeCm(uint32_t pressure);
+#endif
 };
 
 #endif
@@ -47,6 +47,12 @@ void Osprey::processCommand() {
       break;
   }
 
+  // Tell the ground whether it worked
+  telemetry_ack_t ack;
+  ack.command = *message;
+  ack.status = commandStatus;
+  radio.sendPacket(TELEMETRY_ACK, &ack, sizeof(ack), RADIO_EVENT);
+
   // Clear the current command after we've processed it
   radio.clear();
 }
@@ -86,12 +92,23 @@ int Osprey::zeroSensors(char *arg) {
   barometer.zero();
   Osprey::clock.reset();
 
+  // The altitude reference just moved, so start the estimate over from it
+  estimator.reset();
+
   commandStatus = COMMAND_ACK;
   return commandStatus;
 }
 
 int Osprey::setPressure(char *arg) {
+  // Altimeter setting in inches of mercury, e.g. "29.92"
+  float setting = atof(arg);
+
+  if(setting < MIN_PRESSURE_SETTING || setting > MAX_PRESSURE_SETTING) {
+    commandStatus = COMMAND_ERR;
+    return commandStatus;
+  }
 
+  barometer.setSeaLevelPressure(setting * MERCURY_TO_HPA_CONVERSION * 100);
   commandStatus = COMMAND_ACK;
   return commandStatus;
 }
@@ -151,6 +168,14 @@ int Osprey::fireEvent(char *arg) {
 int Osprey::armIgniter(char *arg) {
   event.arm();
 
+  // The log file was allocated and erased at start up, so opening it only
+  // starts the card's write. The igniters stay armed even if it fails, since
+  // recovery matters more than the log.
+  if(!radio.enableLogging()) {
+    commandStatus = COMMAND_ERR;
+    return commandStatus;
+  }
+
   commandStatus = COMMAND_ACK;
   return commandStatus;
 }
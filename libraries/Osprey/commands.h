@@ -5,6 +5,7 @@
 #include "barometer.h"
 #include "clock.h"
 #include "constants.h"
+#include "estimator.h"
 #include "event.h"
 #include "gps.h"
 #include "radio.h"
@@ -14,6 +15,7 @@ namespace Osprey {
   extern Barometer barometer;
   extern Osprey::Clock clock;
   extern Event event;
+  extern AltitudeEstimator estimator;
   extern GPS gps;
   extern Radio radio;
 
@@ -0,0 +1,126 @@
+#include "estimator.h"
+
+AltitudeEstimator::AltitudeEstimator() {
+  reset();
+}
+
+void AltitudeEstimator::reset() {
+  // Nothing is estimated until the first altitude arrives
+  initialized = 0;
+  time = 0;
+
+  for(int i=0; i<ESTIMATOR_STATES; i++) {
+    x[i] = 0;
+  }
+}
+
+void AltitudeEstimator::initialize(float altitude, unsigned long time) {
+  x[ESTIMATOR_ALTITUDE] = altitude;
+  x[ESTIMATOR_VELOCITY] = 0;
+  x[ESTIMATOR_ACCELERATION] = 0;
+
+  P = Osprey::Matrix<float, ESTIMATOR_STATES, ESTIMATOR_STATES>::identity() * ESTIMATOR_INITIAL_VARIANCE;
+
+  this->time = time;
+  initialized = 1;
+}
+
+void AltitudeEstimator::update(SensorFrame *frame) {
+  if(frame->fresh & FRAME_BARO) {
+    updateAltitude(frame->altitude, frame->baroTimestamp);
+  }
+
+  if(frame->fresh & FRAME_IMU) {
+    updateAcceleration(frame->verticalAcceleration, frame->timestamp);
+  }
+
+  predict(frame->timestamp);
+
+  frame->estimatedAltitude = x[ESTIMATOR_ALTITUDE];
+  frame->velocity = x[ESTIMATOR_VELOCITY];
+  frame->estimatedAcceleration = x[ESTIMATOR_ACCELERATION];
+}
+
+void AltitudeEstimator::updateAltitude(float altitude, unsigned long time) {
+  if(!initialized) {
+    initialize(altitude, time);
+    return;
+  }
+
+  predict(time);
+  correct(ESTIMATOR_ALTITUDE, altitude, ESTIMATOR_BARO_VARIANCE);
+}
+
+void AltitudeEstimator::updateAcceleration(float acceleration, unsigned long time) {
+  // Acceleration alone can't anchor the altitude
+  if(!initialized) return;
+
+  predict(time);
+  correct(ESTIMATOR_ACCELERATION, acceleration, ESTIMATOR_ACCEL_VARIANCE);
+}
+
+void AltitudeEstimator::predict(unsigned long time) {
+  if(!initialized) return;
+
+  // A measurement from before the current state time is applied as if it
+  // were taken now rather than rewinding the filter
+  long elapsed = (long)(time - this->time);
+  if(elapsed <= 0) return;
+
+  float dt = elapsed / 1000000.0f;
+  float dt2 = dt * dt;
+  float dt3 = dt2 * dt;
+
+  Osprey::Matrix<float, ESTIMATOR_STATES, ESTIMATOR_STATES> F = Osprey::Matrix<float, ESTIMATOR_STATES, ESTIMATOR_STATES>::identity();
+  F(0, 1) = dt;
+  F(0, 2) = dt2 / 2;
+  F(1, 2) = dt;
+
+  // Process noise for white noise jerk over dt
+  float q = ESTIMATOR_JERK_NOISE;
+  Osprey::Matrix<float, ESTIMATOR_STATES, ESTIMATOR_STATES> Q;
+  Q(0, 0) = q * dt3 * dt2 / 20;
+  Q(0, 1) = Q(1, 0) = q * dt3 * dt / 8;
+  Q(0, 2) = Q(2, 0) = q * dt3 / 6;
+  Q(1, 1) = q * dt3 / 3;
+  Q(1, 2) = Q(2, 1) = q * dt2 / 2;
+  Q(2, 2) = q * dt;
+
+  x = F * x;
+  propagateCovariance(P, F, Q);
+
+  this->time = time;
+}
+
+void AltitudeEstimator::correct(int state, float measurement, float variance) {
+  // Every measurement observes a single state, so H is a unit row and the
+  // innovation covariance is a scalar
+  Osprey::Matrix<float, 1, ESTIMATOR_STATES> H;
+  H(0, state) = 1;
+
+  Osprey::Matrix<float, 1, 1> R;
+  R(0, 0) = variance;
+
+  float S = P(state, state) + variance;
+  float innovation = measurement - x[state];
+
+  Osprey::Vector<float, ESTIMATOR_STATES> K = P * transpose(H) * (1 / S);
+  x = x + K * innovation;
+  josephUpdate(P, K, H, R);
+}
+
+int AltitudeEstimator::isInitialized() {
+  return initialized;
+}
+
+float AltitudeEstimator::getAltitude() {
+  return x[ESTIMATOR_ALTITUDE];
+}
+
+float AltitudeEstimator::getVelocity() {
+  return x[ESTIMATOR_VELOCITY];
+}
+
+float AltitudeEstimator::getAcceleration() {
+  return x[ESTIMATOR_ACCELERATION];
+}
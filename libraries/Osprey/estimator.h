@@ -0,0 +1,49 @@
+#ifndef ESTIMATOR_H
+#define ESTIMATOR_H
+
+// Vertical state estimator
+//
+// A three state (altitude, velocity, acceleration) Kalman filter with a
+// white noise jerk process model. Barometric altitude and IMU vertical
+// acceleration are each applied at their own rate: the state is predicted
+// forward to the time of every measurement before it is used, so the two
+// streams don't need to line up. All matrices are fixed size on the stack.
+
+#include "fixed_matrix.h"
+#include "frame.h"
+
+#define ESTIMATOR_STATES 3
+#define ESTIMATOR_ALTITUDE 0
+#define ESTIMATOR_VELOCITY 1
+#define ESTIMATOR_ACCELERATION 2
+
+#define ESTIMATOR_JERK_NOISE 100.0f      // (m/s^3)^2/Hz
+#define ESTIMATOR_BARO_VARIANCE 1.0f     // m^2
+#define ESTIMATOR_ACCEL_VARIANCE 0.5f    // (m/s^2)^2
+#define ESTIMATOR_INITIAL_VARIANCE 1.0f
+
+class AltitudeEstimator {
+  public:
+    AltitudeEstimator();
+    void reset();
+    void update(SensorFrame *frame);
+    void updateAltitude(float altitude, unsigned long time);
+    void updateAcceleration(float acceleration, unsigned long time);
+    void predict(unsigned long time);
+
+    int isInitialized();
+    float getAltitude();
+    float getVelocity();
+    float getAcceleration();
+
+  protected:
+    void initialize(float altitude, unsigned long time);
+    void correct(int state, float measurement, float variance);
+
+    Osprey::Vector<float, ESTIMATOR_STATES> x;
+    Osprey::Matrix<float, ESTIMATOR_STATES, ESTIMATOR_STATES> P;
+    unsigned long time; // us
+    int initialized;
+};
+
+#endif
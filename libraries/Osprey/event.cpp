@@ -3,8 +3,8 @@
 using namespace Osprey;
 
 Event::Event() {
-  events[EVENT_APOGEE] = {APOGEE_PIN, APOGEE, 0};
-  events[EVENT_MAIN] = {MAIN_PIN, DEFAULT_MAIN_ALTITUDE, 0};
+  events[EVENT_APOGEE] = {APOGEE_PIN, APOGEE, 0, 0, 0};
+  events[EVENT_MAIN] = {MAIN_PIN, DEFAULT_MAIN_ALTITUDE, 0, 0, 0};
 
   reset();
 }
@@ -19,26 +19,26 @@ int Event::init() {
   return 1;
 }
 
-void Event::check() {
-  //FIXME
-  float acceleration = accelerometer.getAccelerationG();
-  float altitude = barometer.getAltitudeAboveGround();
+void Event::check(const SensorFrame &frame) {
+  float acceleration = frame.accelerationG;
+  float altitude = frame.estimatedAltitude;
+  float velocity = frame.velocity;
 
   switch(phase) {
     case PAD:
-      phasePad(acceleration);
+      phasePad(acceleration, altitude);
       break;
     case BOOST:
       phaseBoost(acceleration);
       break;
     case COAST:
-      phaseCoast(acceleration, altitude);
+      phaseCoast(acceleration, altitude, velocity);
       break;
     case DROGUE:
       phaseDrogue(acceleration, altitude);
       break;
     case MAIN:
-      phaseMain(altitude);
+      phaseMain(velocity);
       break;
     case LANDED:
       phaseLanded();
@@ -50,7 +50,10 @@ void Event::check() {
   previousAltitude = altitude;
 }
 
-void Event::phasePad(float acceleration) {
+void Event::phasePad(float acceleration, float altitude) {
+  // Where the climb is measured from, whichever way the pad is left
+  launchAltitude = altitude;
+
   // Move to boost after motor ignition
   if(acceleration >= BOOST_ACCELERATION) {
     phase = BOOST;
@@ -70,12 +73,17 @@ void Event::phaseBoost(float acceleration) {
   }
 }
 
-void Event::phaseCoast(float acceleration, float altitude) {
-  // If apogee is pending, as soon as the altitude decreases, fire it
-  if(pendingApogee) {
-    if(previousAltitude - altitude > APOGEE_ALTITUDE_DELTA) {
-      atApogee(APOGEE_CAUSE_ALTITUDE);
-    }
+void Event::phaseCoast(float acceleration, float altitude, float velocity) {
+  if(velocity > peakVelocity) {
+    peakVelocity = velocity;
+  }
+
+  // Apogee is where the estimated vertical velocity goes through zero, but
+  // only once the rocket has really climbed. Handling on the pad can also
+  // land us in coast, and there the velocity sits at zero.
+  if(hasAscended(altitude) && velocity <= APOGEE_VELOCITY) {
+    atApogee(APOGEE_CAUSE_VELOCITY);
+    return;
   }
 
   // If the apogee countdown is finished, fire it
@@ -85,10 +93,9 @@ void Event::phaseCoast(float acceleration, float altitude) {
     return;
   }
 
-  // Anything less than the ideal acceleration means we're basically at apogee, but should start paying attention to altitude to get as close as possible
+  // Anything less than the ideal acceleration means we're basically at apogee, so the
+  // velocity check above has until the countdown runs out to find it
   if(acceleration < APOGEE_IDEAL) {
-    pendingApogee = 1;
-
     // Only start the countdown if it's not already started
     if(apogeeCountdownStart == 0) {
       apogeeCountdownStart = Osprey::clock.getSeconds();
@@ -120,7 +127,7 @@ void Event::phaseDrogue(float acceleration, float altitude) {
   // If we're in the drogue phase and still in free fall fire everything in a desperate attempt to save our ass
   if(isInFreeFall(altitude)) {
     panic();
-    phase = MAIN;
+    atMain();
     return;
   }
 
@@ -130,32 +137,33 @@ void Event::phaseDrogue(float acceleration, float altitude) {
 
     if(event->altitude > 0 && altitude < event->altitude) {
       fire(i);
-      phase = MAIN;
+      atMain();
     }
   }
 }
 
-void Event::phaseMain(float altitude) {
-  // Increase the landed altitude in range counter for each time the altitude differs less than the set delta
-  if(abs(previousAltitude - altitude) < LANDED_ALTITUDE_DELTA) {
-    landedAltitudeInRange++;
+void Event::phaseMain(float velocity) {
+  // Under the main the altitude changes by only a few tenths of a metre
+  // between checks, so that says nothing about landing. Wait until the
+  // estimated vertical speed has stayed near zero for a run of checks, and
+  // start counting again on any miss.
+  if(fabs(velocity) < LANDED_VELOCITY) {
+    landedChecks++;
+  } else {
+    landedChecks = 0;
   }
 
-  // Once the altitude stops changing and is stable, go to landed
-  if(landedAltitudeInRange >= LANDED_ALTITUDE_LIMIT) {
+  // Once the rocket has had time to come down and is still, go to landed
+  if(millis() - mainAt >= LANDED_MIN_TIME && landedChecks >= LANDED_CHECKS) {
     phase = LANDED;
   }
 }
 
 void Event::phaseLanded() {
   // Flush the log so that all data is written to disk in case the end
-  // flight command is not sent and the log file isn't cleanly closed
-  static int landed = 0;
-
-  if(landed == 0) {
+  // flight command is not sent. Logging carries on until that command.
+  if(!landed) {
     radio.flushLog();
-    radio.disableLogging();
-    radio.enableLogging();
     landed = 1;
   }
 }
@@ -178,19 +186,36 @@ void Event::atApogee(int apogeeCause) {
   freeFallAltitudeInRange = 0;
 }
 
+void Event::atMain() {
+  phase = MAIN;
+  mainAt = millis();
+  landedChecks = 0;
+}
+
 void Event::fire(int eventNum) {
   // Don't fire if not armed
   if(armed != 1) return;
 
   event_t *event = &events[eventNum];
 
+  // Lowered again by update() rather than waiting here, which would hold up
+  // every other task for the whole pulse
   digitalWrite(event->pin, HIGH);
-  delay(FIRE_DURATION);
-  digitalWrite(event->pin, LOW);
+  event->firing = 1;
+  event->firedAt = millis();
 
   event->fired = 1;
 }
 
+void Event::update() {
+  for(int i=0; i<numEvents(); i++) {
+    if(events[i].firing && millis() - events[i].firedAt >= FIRE_DURATION) {
+      digitalWrite(events[i].pin, LOW);
+      events[i].firing = 0;
+    }
+  }
+}
+
 int Event::checkApogeeCountdowns() {
   // If the apogee countdown is finished, fire it
   if(apogeeCountdownStart > 0 && abs(apogeeCountdownStart - Osprey::clock.getSeconds()) >= APOGEE_COUNTDOWN) {
@@ -208,7 +233,11 @@ int Event::checkApogeeCountdowns() {
 void Event::disableApogeeCountdowns() {
   apogeeCountdownStart = 0;
   safetyApogeeCountdownStart = 0;
-  pendingApogee = 0;
+}
+
+int Event::hasAscended(float altitude) {
+  return (peakVelocity >= APOGEE_MIN_VELOCITY &&
+          altitude - launchAltitude >= APOGEE_MIN_ALTITUDE);
 }
 
 int Event::isInFreeFall(float altitude) {
@@ -272,9 +301,12 @@ void Event::reset() {
   phase = PAD;
   armed = 0;
   previousAltitude = 0;
-  pendingApogee = 0;
+  launchAltitude = 0;
+  peakVelocity = 0;
   apogeeCause = APOGEE_CAUSE_NONE;
-  landedAltitudeInRange = 0;
+  landedChecks = 0;
+  mainAt = 0;
+  landed = 0;
   freeFallAltitudeInRange = 0;
 
   apogeeCountdownStart = 0;
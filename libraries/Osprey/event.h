@@ -5,11 +5,12 @@
 #include "barometer.h"
 #include "clock.h"
 #include "constants.h"
+#include "frame.h"
 #include "radio.h"
 #include "sensor.h"
 
 #define NUM_EVENTS 2
-#define FIRE_DURATION 100 // ms
+#define FIRE_DURATION 100 // ms the pin is held high, lowered by update()
 #define DEFAULT_MAIN_ALTITUDE 152.4f // m
 #define APOGEE -1
 
@@ -25,6 +26,7 @@
 #define APOGEE_CAUSE_SAFETY_COUNTDOWN 3
 #define APOGEE_CAUSE_FREE_FALL 4
 #define APOGEE_CAUSE_MANUAL 5
+#define APOGEE_CAUSE_VELOCITY 6
 
 #define APOGEE_COUNTDOWN 6 // seconds
 #define SAFETY_APOGEE_COUNTDOWN 12 // seconds
@@ -32,16 +34,21 @@
 #define COAST_ACCELERATION 0.75 // g
 #define APOGEE_IDEAL 0.15 // g
 #define APOGEE_OKAY 0.3 // g
-#define APOGEE_ALTITUDE_DELTA 1 // meters
+#define APOGEE_VELOCITY 0 // m/s
+#define APOGEE_MIN_VELOCITY 20 // m/s, peak climb rate before velocity apogee can fire
+#define APOGEE_MIN_ALTITUDE 30 // meters above the launch altitude, likewise
 #define FREE_FALL_ALTITUDE_DELTA 10 // meters
 #define FREE_FALL_ALTITUDE_LIMIT 3
-#define LANDED_ALTITUDE_DELTA 1.5 // meters
-#define LANDED_ALTITUDE_LIMIT 5
+#define LANDED_VELOCITY 1 // m/s, estimated vertical speed on the ground
+#define LANDED_CHECKS 20 // in a row, 1 s at the event task's 20 Hz
+#define LANDED_MIN_TIME 10000 // ms after main before landing can be called
 
 typedef struct event_t {
   int pin;
   float altitude;
   int fired;
+  int firing;
+  unsigned long firedAt; // ms
 } event_t;
 
 namespace Osprey {
@@ -55,8 +62,9 @@ class Event : public virtual Sensor {
   public:
     Event();
     int init();
-    void check();
+    void check(const SensorFrame &frame);
     void fire(int eventNum);
+    void update();
     int didFire(int eventNum);
     float getAltitude(int eventNum);
     int setAltitude(int eventNum, float altitude);
@@ -70,17 +78,19 @@ class Event : public virtual Sensor {
     void reset();
 
   protected:
-    void phasePad(float acceleration);
+    void phasePad(float acceleration, float altitude);
     void phaseBoost(float acceleration);
-    void phaseCoast(float acceleration, float altitude);
+    void phaseCoast(float acceleration, float altitude, float velocity);
     void phaseDrogue(float acceleration, float altitude);
-    void phaseMain(float acceleration);
+    void phaseMain(float velocity);
     void phaseLanded();
     void atApogee(int apogeeCause);
+    void atMain();
 
     int checkApogeeCountdowns();
     void disableApogeeCountdowns();
 
+    int hasAscended(float altitude);
     int isInFreeFall(float altitude);
     void panic();
 
@@ -91,11 +101,14 @@ class Event : public virtual Sensor {
     int apogeeCountdownStart;
     int safetyApogeeCountdownStart;
 
-    int pendingApogee;
     int apogeeCause;
     float previousAltitude;
+    float launchAltitude;
+    float peakVelocity;
     int freeFallAltitudeInRange;
-    int landedAltitudeInRange;
+    int landedChecks;
+    unsigned long mainAt; // ms
+    int landed;
 };
 
 #endif
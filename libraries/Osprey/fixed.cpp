@@ -0,0 +1,219 @@
+#include "fixed.h"
+
+namespace Osprey {
+
+// The transcendental functions work internally in Q2.30 and round to Q16.16
+// once at the end
+#define Q30_ONE 0x40000000
+#define Q30_LN2 744261118LL       // ln(2)
+#define Q30_PI 3373259426LL       // pi
+#define Q30_SQRT2 1518500250      // sqrt(2)
+#define Q16_INV_LN2 94548         // 1 / ln(2)
+#define EXP_MAX 681391            // ln(32768), anything above saturates
+#define EXP_MIN -772243           // ln(2^-17), anything below rounds to 0
+
+#define CORDIC_ITERATIONS 20
+
+// atan(2^-i)
+static const int32_t CORDIC_ANGLES[CORDIC_ITERATIONS] = {
+  843314857, 497837829, 263043837, 133525159, 67021687, 33543516, 16775851,
+  8388437, 4194283, 2097149, 1048576, 524288, 262144, 131072, 65536, 32768,
+  16384, 8192, 4096, 2048
+};
+
+// 1 / n, for the series below
+static const int32_t RECIPROCALS[10] = {
+  0, 1073741824, 536870912, 357913941, 268435456, 214748365, 178956971,
+  153391689, 134217728, 119304647
+};
+
+static int64_t mulQ30(int64_t a, int64_t b) {
+  return (a * b) >> 30;
+}
+
+static int32_t roundQ30(int64_t value) {
+  return Fixed::saturate((value + (1 << 13)) >> 14);
+}
+
+// Bit by bit square root, rounded to nearest
+static uint64_t isqrt64(uint64_t value) {
+  uint64_t root = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+
+  while(bit > value) {
+    bit >>= 2;
+  }
+
+  while(bit) {
+    if(value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  if(value > root) {
+    root++;
+  }
+
+  return root;
+}
+
+static int highestBit(uint32_t value) {
+  int bit = 0;
+  while(value >>= 1) {
+    bit++;
+  }
+  return bit;
+}
+
+Fixed Fixed::fromRatio(int32_t num, int32_t den) {
+  if(!den) {
+    return num < 0 ? min() : max();
+  }
+  return fromRaw(saturate(((int64_t)num * FIXED_ONE) / den));
+}
+
+Fixed fixedSqrt(Fixed x) {
+  if(x.toRaw() <= 0) {
+    return Fixed();
+  }
+
+  // sqrt(raw * 2^16) = sqrt(x) * 2^16
+  return Fixed::fromRaw((int32_t)isqrt64((uint64_t)x.toRaw() << FIXED_FRACTION_BITS));
+}
+
+Fixed fixedNorm(Fixed x, Fixed y, Fixed z) {
+  // Squares of the raw values are Q32.32, whose root is Q16.16 again
+  uint64_t sum = (uint64_t)((int64_t)x.toRaw() * x.toRaw()) +
+                 (uint64_t)((int64_t)y.toRaw() * y.toRaw()) +
+                 (uint64_t)((int64_t)z.toRaw() * z.toRaw());
+
+  uint64_t root = isqrt64(sum);
+  return Fixed::fromRaw(root > INT32_MAX ? INT32_MAX : (int32_t)root);
+}
+
+Fixed fixedAtan2(Fixed y, Fixed x) {
+  int32_t X = x.toRaw();
+  int32_t Y = y.toRaw();
+  if(!X && !Y) {
+    return Fixed();
+  }
+
+  // Rotate the left half plane onto the right, where CORDIC converges
+  int64_t angle = 0;
+  if(X < 0) {
+    angle = Y < 0 ? -Q30_PI : Q30_PI;
+    X = X == INT32_MIN ? INT32_MAX : -X;
+    Y = Y == INT32_MIN ? INT32_MAX : -Y;
+  }
+
+  // Scale up for precision, leaving headroom for the CORDIC gain of 1.65
+  // and the 45 degree worst case of sqrt(2)
+  uint32_t magnitude = (uint32_t)X | (uint32_t)(Y < 0 ? -(int64_t)Y : Y);
+  int shift = 28 - highestBit(magnitude);
+  if(shift > 0) {
+    X <<= shift;
+    Y = (int32_t)((int64_t)Y * (1 << shift));
+  } else if(shift < 0) {
+    X >>= -shift;
+    Y >>= -shift;
+  }
+
+  // Rotate (X, Y) onto the X axis, adding up the angles turned through
+  for(int i=0; i<CORDIC_ITERATIONS; i++) {
+    int32_t dx = Y >> i;
+    int32_t dy = X >> i;
+    if(Y > 0) {
+      X += dx;
+      Y -= dy;
+      angle += CORDIC_ANGLES[i];
+    } else {
+      X -= dx;
+      Y += dy;
+      angle -= CORDIC_ANGLES[i];
+    }
+  }
+
+  return Fixed::fromRaw(roundQ30(angle));
+}
+
+// e^x for x in Q30, rounded to Q16
+static Fixed expQ30(int64_t x) {
+  if(x >= (int64_t)EXP_MAX * (1 << 14)) {
+    return Fixed::max();
+  }
+  if(x < (int64_t)EXP_MIN * (1 << 14)) {
+    return Fixed();
+  }
+
+  // e^x = 2^k e^r with |r| <= ln(2) / 2
+  int32_t k = (int32_t)(((x >> 14) * Q16_INV_LN2 + ((int64_t)1 << 31)) >> 32);
+  int64_t r = x - k * Q30_LN2;
+
+  // Taylor series to r^7 / 7!, 1e-7 at the ends of the range
+  int64_t sum = Q30_ONE;
+  for(int n=7; n>=1; n--) {
+    sum = Q30_ONE + mulQ30(mulQ30(sum, r), RECIPROCALS[n]);
+  }
+
+  // Q30 to Q16 is a shift of 14, less k for the power of two
+  int shift = 14 - k;
+  if(shift <= 0) {
+    return Fixed::fromRaw(Fixed::saturate(sum << -shift));
+  }
+  if(shift >= 62) {
+    return Fixed();
+  }
+  return Fixed::fromRaw((int32_t)((sum + ((int64_t)1 << (shift - 1))) >> shift));
+}
+
+// ln(x) in Q30 for x > 0
+static int64_t logQ30(int32_t raw) {
+  // x = m 2^e with m in [sqrt(2)/2, sqrt(2))
+  int bit = highestBit(raw);
+  int32_t e = bit - FIXED_FRACTION_BITS;
+  int64_t m = (int64_t)raw << (30 - bit);
+  if(m > Q30_SQRT2) {
+    m >>= 1;
+    e++;
+  }
+
+  // ln(m) = 2 atanh(s) with s = (m - 1) / (m + 1), |s| < 0.172. The series to
+  // s^9 / 9 is good to 3e-9.
+  int64_t s = ((m - Q30_ONE) << 30) / (m + Q30_ONE);
+  int64_t s2 = mulQ30(s, s);
+  int64_t sum = RECIPROCALS[9];
+  for(int n=7; n>=1; n-=2) {
+    sum = RECIPROCALS[n] + mulQ30(sum, s2);
+  }
+
+  return 2 * mulQ30(s, sum) + e * Q30_LN2;
+}
+
+Fixed fixedExp(Fixed x) {
+  return expQ30((int64_t)x.toRaw() * (1 << 14));
+}
+
+Fixed fixedLog(Fixed x) {
+  if(x.toRaw() <= 0) {
+    return Fixed::min();
+  }
+  return Fixed::fromRaw(roundQ30(logQ30(x.toRaw())));
+}
+
+Fixed fixedPow(Fixed x, Fixed y) {
+  if(x.toRaw() <= 0) {
+    return Fixed();
+  }
+
+  // The exponent stays in Q30 so only the result is rounded. The product is
+  // split in two so it can't overflow 64 bits.
+  int64_t log = logQ30(x.toRaw());
+  int64_t exponent = (log >> 16) * y.toRaw() + (((log & 0xFFFF) * y.toRaw()) >> 16);
+  return expQ30(exponent);
+}
+
+}
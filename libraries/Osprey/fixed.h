@@ -0,0 +1,124 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+// Q16.16 fixed point
+//
+// The SAMD21 has no FPU, so every float operation is a library call. Fixed
+// keeps a value as a 32 bit integer in 1/65536ths, giving a range of
+// +-32768 with a resolution of 1.5e-5. Arithmetic saturates at the ends of
+// the range instead of wrapping, so an overflow shows up as a pinned value
+// rather than a sign flip.
+//
+// Conversions from float are constexpr so constants cost nothing at run time.
+// Only ints convert implicitly; a float has to be converted explicitly so a
+// soft float conversion can't sneak into a hot path unnoticed.
+
+#include <stdint.h>
+
+// Set to 1 to run the sensor Kalman filters and acceleration magnitude in
+// fixed point instead of float
+#ifndef FIXED_POINT_MATH
+#define FIXED_POINT_MATH 0
+#endif
+
+#define FIXED_FRACTION_BITS 16
+#define FIXED_ONE 0x10000
+
+namespace Osprey {
+
+class Fixed {
+  public:
+    constexpr Fixed() : raw(0) {}
+    constexpr Fixed(int value) : raw(fromInteger(value)) {}
+    constexpr Fixed(long value) : raw(fromInteger(value)) {}
+    constexpr explicit Fixed(float value) : raw(fromReal(value)) {}
+    constexpr explicit Fixed(double value) : raw(fromReal(value)) {}
+
+    static constexpr Fixed fromRaw(int32_t raw) { return Fixed(raw, 0); }
+    // num / den without going through float
+    static Fixed fromRatio(int32_t num, int32_t den);
+
+    constexpr int32_t toRaw() const { return raw; }
+    float toFloat() const { return raw * (1.0f / FIXED_ONE); }
+    // Rounded to the nearest integer
+    int32_t toInt() const { return (int32_t)(((int64_t)raw + FIXED_ONE / 2) >> FIXED_FRACTION_BITS); }
+
+    static constexpr Fixed max() { return fromRaw(INT32_MAX); }
+    static constexpr Fixed min() { return fromRaw(INT32_MIN); }
+
+    Fixed& operator+=(Fixed b) { raw = saturate((int64_t)raw + b.raw); return *this; }
+    Fixed& operator-=(Fixed b) { raw = saturate((int64_t)raw - b.raw); return *this; }
+    Fixed& operator*=(Fixed b) { raw = multiply(raw, b.raw); return *this; }
+    Fixed& operator/=(Fixed b) { raw = divide(raw, b.raw); return *this; }
+
+    friend Fixed operator+(Fixed a, Fixed b) { return a += b; }
+    friend Fixed operator-(Fixed a, Fixed b) { return a -= b; }
+    friend Fixed operator*(Fixed a, Fixed b) { return a *= b; }
+    friend Fixed operator/(Fixed a, Fixed b) { return a /= b; }
+    friend Fixed operator-(Fixed a) { return fromRaw(a.raw == INT32_MIN ? INT32_MAX : -a.raw); }
+
+    friend constexpr bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+    friend constexpr bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+    friend constexpr bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+    friend constexpr bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+    friend constexpr bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+    friend constexpr bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+
+    static int32_t saturate(int64_t value) {
+      if(value > INT32_MAX) return INT32_MAX;
+      if(value < INT32_MIN) return INT32_MIN;
+      return (int32_t)value;
+    }
+
+  protected:
+    int32_t raw;
+
+    constexpr Fixed(int32_t raw, int) : raw(raw) {}
+
+    template<typename T>
+    static constexpr int32_t fromInteger(T value) {
+      return value >= T(32768) ? INT32_MAX :
+             value < T(-32768) ? INT32_MIN :
+             (int32_t)(value * FIXED_ONE);
+    }
+
+    template<typename T>
+    static constexpr int32_t fromReal(T value) {
+      return value >= T(32768) ? INT32_MAX :
+             value <= T(-32768) ? INT32_MIN :
+             (int32_t)(value * T(FIXED_ONE) + (value < 0 ? T(-0.5) : T(0.5)));
+    }
+
+    // Rounded to nearest
+    static int32_t multiply(int32_t a, int32_t b) {
+      return saturate(((int64_t)a * b + FIXED_ONE / 2) >> FIXED_FRACTION_BITS);
+    }
+
+    // Division by zero saturates towards the sign of the dividend
+    static int32_t divide(int32_t a, int32_t b) {
+      if(!b) return a < 0 ? INT32_MIN : INT32_MAX;
+      return saturate(((int64_t)a * FIXED_ONE) / b);
+    }
+};
+
+// Approximations, with the worst case error over the whole input range as
+// measured by tools/fixedtest. Results that don't fit saturate.
+
+// Square root, within 0.5 LSB (worked out bit by bit and rounded to
+// nearest). Zero for negative inputs.
+Fixed fixedSqrt(Fixed x);
+// sqrt(x^2 + y^2 + z^2), within 0.5 LSB. The sum of squares is kept in 64
+// bits so it can't overflow.
+Fixed fixedNorm(Fixed x, Fixed y, Fixed z);
+// Radians in (-pi, pi], within 0.65 LSB, 1e-5 rad (CORDIC, 20 iterations)
+Fixed fixedAtan2(Fixed y, Fixed x);
+// e^x, within 0.5 LSB plus 1e-8 relative
+Fixed fixedExp(Fixed x);
+// Natural log, within 0.51 LSB. Fixed::min() for x <= 0.
+Fixed fixedLog(Fixed x);
+// x^y as e^(y ln x), within 0.5 LSB plus 1e-4 relative. Zero for x <= 0.
+Fixed fixedPow(Fixed x, Fixed y);
+
+}
+
+#endif
@@ -0,0 +1,292 @@
+#ifndef FIXED_MATRIX_H
+#define FIXED_MATRIX_H
+
+// Small fixed size matrices for the on-board filters
+//
+// Header only, no heap and no dependencies so the same code runs on the
+// flight computer and the host. Sizes are template parameters, so every loop
+// has a compile time trip count and is unrolled by template recursion.
+//
+// Arithmetic builds expression objects that are only evaluated when assigned
+// to a Matrix, straight into the destination. The one exception is an
+// operand of a product that is itself an expression: it is evaluated once into
+// a small stack matrix when the product is built, rather than once per element
+// of the result. So, for example,
+//
+//   P = F * P * transpose(F) + Q;
+//
+// works out F P once, then writes (F P) F' + Q directly into P with no other
+// temporaries. Assignment falls back to a temporary only when the destination
+// is also read lazily by a product on the right hand side (P = F * P).
+//
+// The element type only needs +, -, * and construction from an int, so a
+// fixed point type can be dropped in for float.
+
+#define FIXED_MATRIX_INLINE inline __attribute__((always_inline))
+
+namespace Osprey {
+
+template<typename T, int M, int N> class Matrix;
+
+// Base of every matrix and matrix expression
+template<typename E>
+struct MatrixExpr {
+  FIXED_MATRIX_INLINE const E& derived() const { return static_cast<const E&>(*this); }
+};
+
+// Compile time loops. Visit every (i, j) of an M x N block, and sum
+// a(i, k) * b(k, j) over k.
+template<int I, int J, int M, int N>
+struct MatrixLoop {
+  template<typename F>
+  static FIXED_MATRIX_INLINE void run(F &f) {
+    f.template at<I, J>();
+    MatrixLoop<(J + 1 == N ? I + 1 : I), (J + 1 == N ? 0 : J + 1), M, N>::run(f);
+  }
+};
+
+template<int J, int M, int N>
+struct MatrixLoop<M, J, M, N> {
+  template<typename F>
+  static FIXED_MATRIX_INLINE void run(F &) {}
+};
+
+template<int K>
+struct MatrixDot {
+  template<typename T, typename A, typename B>
+  static FIXED_MATRIX_INLINE T sum(const A &a, const B &b, int i, int j) {
+    return MatrixDot<K - 1>::template sum<T>(a, b, i, j) + a(i, K - 1) * b(K - 1, j);
+  }
+};
+
+template<>
+struct MatrixDot<1> {
+  template<typename T, typename A, typename B>
+  static FIXED_MATRIX_INLINE T sum(const A &a, const B &b, int i, int j) {
+    return a(i, 0) * b(0, j);
+  }
+};
+
+template<typename T, int M, int N>
+class Matrix : public MatrixExpr<Matrix<T, M, N> > {
+  public:
+    typedef T value_type;
+    enum { rows = M, cols = N };
+
+    constexpr Matrix() : m() {}
+
+    template<typename E>
+    Matrix(const MatrixExpr<E> &e) {
+      Assign<E> assign(*this, e.derived());
+      MatrixLoop<0, 0, M, N>::run(assign);
+    }
+
+    static Matrix identity() {
+      Matrix result;
+      for(int i=0; i<M && i<N; i++) {
+        result.m[i][i] = T(1);
+      }
+      return result;
+    }
+
+    FIXED_MATRIX_INLINE T& operator()(int i, int j) { return m[i][j]; }
+    constexpr const T& operator()(int i, int j) const { return m[i][j]; }
+    FIXED_MATRIX_INLINE T& operator[](int i) { return m[i][0]; }
+    constexpr const T& operator[](int i) const { return m[i][0]; }
+
+    template<typename E>
+    Matrix& operator=(const MatrixExpr<E> &e) {
+      if(e.derived().aliases(this)) {
+        Matrix result(e);
+        *this = result;
+      } else {
+        Assign<E> assign(*this, e.derived());
+        MatrixLoop<0, 0, M, N>::run(assign);
+      }
+      return *this;
+    }
+
+    // Only the upper triangle of a result known to be symmetric is worked
+    // out, and mirrored into the lower one. Also makes sure rounding can't
+    // leave a covariance slightly asymmetric.
+    template<typename E>
+    Matrix& setSymmetric(const MatrixExpr<E> &e) {
+      if(e.derived().aliases(this)) {
+        Matrix result;
+        result.setSymmetric(e);
+        *this = result;
+      } else {
+        AssignSymmetric<E> assign(*this, e.derived());
+        MatrixLoop<0, 0, M, N>::run(assign);
+      }
+      return *this;
+    }
+
+    FIXED_MATRIX_INLINE bool aliases(const void *) const { return false; }
+
+  protected:
+    T m[M][N];
+
+    template<typename E>
+    struct Assign {
+      Matrix &dst;
+      const E &src;
+      FIXED_MATRIX_INLINE Assign(Matrix &dst, const E &src) : dst(dst), src(src) {}
+      template<int I, int J> FIXED_MATRIX_INLINE void at() { dst.m[I][J] = src(I, J); }
+    };
+
+    template<typename E>
+    struct AssignSymmetric {
+      Matrix &dst;
+      const E &src;
+      FIXED_MATRIX_INLINE AssignSymmetric(Matrix &dst, const E &src) : dst(dst), src(src) {}
+      template<int I, int J> FIXED_MATRIX_INLINE void at() {
+        if(J < I) return;
+        T value = src(I, J);
+        dst.m[I][J] = value;
+        dst.m[J][I] = value;
+      }
+    };
+};
+
+template<typename T, int N>
+using Vector = Matrix<T, N, 1>;
+
+// How a product holds each operand. Plain matrices (and their transposes) are
+// read in place; anything else is evaluated once up front.
+template<typename E>
+struct MatrixOperand {
+  typedef Matrix<typename E::value_type, E::rows, E::cols> type;
+  static FIXED_MATRIX_INLINE bool aliases(const type &, const void *) { return false; }
+};
+
+template<typename T, int M, int N>
+struct MatrixOperand<Matrix<T, M, N> > {
+  typedef const Matrix<T, M, N>& type;
+  static FIXED_MATRIX_INLINE bool aliases(type m, const void *p) { return &m == p; }
+};
+
+template<typename A>
+class MatrixTranspose : public MatrixExpr<MatrixTranspose<A> > {
+  public:
+    typedef typename A::value_type value_type;
+    enum { rows = A::cols, cols = A::rows };
+
+    FIXED_MATRIX_INLINE explicit MatrixTranspose(const A &a) : a(a) {}
+    FIXED_MATRIX_INLINE value_type operator()(int i, int j) const { return a(j, i); }
+
+    // Transposing reads other elements than the one being written
+    FIXED_MATRIX_INLINE bool aliases(const void *p) const { return MatrixOperand<A>::aliases(a, p); }
+
+  protected:
+    typename MatrixOperand<A>::type a;
+};
+
+template<typename T, int M, int N>
+struct MatrixOperand<MatrixTranspose<Matrix<T, M, N> > > {
+  typedef MatrixTranspose<Matrix<T, M, N> > type;
+  static FIXED_MATRIX_INLINE bool aliases(const type &t, const void *p) { return t.aliases(p); }
+};
+
+template<typename A, typename B>
+class MatrixProduct : public MatrixExpr<MatrixProduct<A, B> > {
+  public:
+    typedef typename A::value_type value_type;
+    enum { rows = A::rows, cols = B::cols };
+
+    FIXED_MATRIX_INLINE MatrixProduct(const A &a, const B &b) : a(a), b(b) {}
+
+    FIXED_MATRIX_INLINE value_type operator()(int i, int j) const {
+      return MatrixDot<A::cols>::template sum<value_type>(a, b, i, j);
+    }
+
+    FIXED_MATRIX_INLINE bool aliases(const void *p) const {
+      return MatrixOperand<A>::aliases(a, p) || MatrixOperand<B>::aliases(b, p);
+    }
+
+  protected:
+    typename MatrixOperand<A>::type a;
+    typename MatrixOperand<B>::type b;
+};
+
+// Element-wise nodes only ever read the element being written, so they alias
+// only through a product or transpose further down
+template<typename A, typename B, int Sign>
+class MatrixSum : public MatrixExpr<MatrixSum<A, B, Sign> > {
+  public:
+    typedef typename A::value_type value_type;
+    enum { rows = A::rows, cols = A::cols };
+
+    FIXED_MATRIX_INLINE MatrixSum(const A &a, const B &b) : a(a), b(b) {}
+
+    FIXED_MATRIX_INLINE value_type operator()(int i, int j) const {
+      return (Sign > 0 ? a(i, j) + b(i, j) : a(i, j) - b(i, j));
+    }
+
+    FIXED_MATRIX_INLINE bool aliases(const void *p) const { return a.aliases(p) || b.aliases(p); }
+
+  protected:
+    const A &a;
+    const B &b;
+};
+
+template<typename A>
+class MatrixScale : public MatrixExpr<MatrixScale<A> > {
+  public:
+    typedef typename A::value_type value_type;
+    enum { rows = A::rows, cols = A::cols };
+
+    FIXED_MATRIX_INLINE MatrixScale(const A &a, value_type s) : a(a), s(s) {}
+    FIXED_MATRIX_INLINE value_type operator()(int i, int j) const { return a(i, j) * s; }
+    FIXED_MATRIX_INLINE bool aliases(const void *p) const { return a.aliases(p); }
+
+  protected:
+    const A &a;
+    value_type s;
+};
+
+template<typename A, typename B>
+FIXED_MATRIX_INLINE MatrixProduct<A, B> operator*(const MatrixExpr<A> &a, const MatrixExpr<B> &b) {
+  static_assert((int)A::cols == (int)B::rows, "matrix dimensions don't agree");
+  return MatrixProduct<A, B>(a.derived(), b.derived());
+}
+
+template<typename A, typename B>
+FIXED_MATRIX_INLINE MatrixSum<A, B, 1> operator+(const MatrixExpr<A> &a, const MatrixExpr<B> &b) {
+  static_assert((int)A::rows == (int)B::rows && (int)A::cols == (int)B::cols, "matrix dimensions don't agree");
+  return MatrixSum<A, B, 1>(a.derived(), b.derived());
+}
+
+template<typename A, typename B>
+FIXED_MATRIX_INLINE MatrixSum<A, B, -1> operator-(const MatrixExpr<A> &a, const MatrixExpr<B> &b) {
+  static_assert((int)A::rows == (int)B::rows && (int)A::cols == (int)B::cols, "matrix dimensions don't agree");
+  return MatrixSum<A, B, -1>(a.derived(), b.derived());
+}
+
+template<typename A>
+FIXED_MATRIX_INLINE MatrixScale<A> operator*(const MatrixExpr<A> &a, typename A::value_type s) {
+  return MatrixScale<A>(a.derived(), s);
+}
+
+template<typename A>
+FIXED_MATRIX_INLINE MatrixTranspose<A> transpose(const MatrixExpr<A> &a) {
+  return MatrixTranspose<A>(a.derived());
+}
+
+// P = F P F' + Q
+template<typename T, int N>
+FIXED_MATRIX_INLINE void propagateCovariance(Matrix<T, N, N> &P, const Matrix<T, N, N> &F, const Matrix<T, N, N> &Q) {
+  P.setSymmetric(F * P * transpose(F) + Q);
+}
+
+// Joseph form measurement update, P = (I - K H) P (I - K H)' + K R K'. Costs
+// more than P - K H P but stays symmetric and positive definite under rounding.
+template<typename T, int N, int Z>
+FIXED_MATRIX_INLINE void josephUpdate(Matrix<T, N, N> &P, const Matrix<T, N, Z> &K, const Matrix<T, Z, N> &H, const Matrix<T, Z, Z> &R) {
+  Matrix<T, N, N> A = Matrix<T, N, N>::identity() - K * H;
+  P.setSymmetric(A * P * transpose(A) + K * R * transpose(K));
+}
+
+}
+
+#endif
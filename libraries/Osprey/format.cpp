@@ -0,0 +1,178 @@
+#include "format.h"
+
+#include <string.h>
+
+namespace Osprey {
+
+static const char DIGIT_PAIRS[] =
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+static const uint32_t POWERS_OF_TEN[FORMAT_MAX_PRECISION + 1] = {
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// The M0 has no divide instruction, so divide by multiplying with the
+// reciprocal. The 32 bit product is exact below 43699.
+static inline uint32_t divide100(uint32_t value) {
+  if(value < 43699) return (value * 5243) >> 19;
+  return ((uint64_t)value * 1374389535) >> 37;
+}
+
+// Writes value backwards so that it ends just before end, zero padded to at
+// least width digits, and returns where it starts
+static char* writeDigits(uint32_t value, char *end, int width) {
+  char *start = end;
+
+  while(value >= 100) {
+    uint32_t quotient = divide100(value);
+    start -= 2;
+    memcpy(start, DIGIT_PAIRS + 2 * (value - quotient * 100), 2);
+    value = quotient;
+  }
+
+  if(value >= 10) {
+    start -= 2;
+    memcpy(start, DIGIT_PAIRS + 2 * value, 2);
+  } else {
+    *--start = '0' + value;
+  }
+
+  while(end - start < width) *--start = '0';
+  return start;
+}
+
+// Only whole parts of 2^32 and over, which no flight value gets near, need
+// the 64 bit division
+static char* writeDigits64(uint64_t value, char *end) {
+  while(value > UINT32_MAX) {
+    end = writeDigits(value % 1000000000, end, 9);
+    value /= 1000000000;
+  }
+
+  return writeDigits(value, end, 0);
+}
+
+static int finish(const char *start, const char *end, char *buffer) {
+  int length = end - start;
+  memcpy(buffer, start, length);
+  buffer[length] = '\0';
+  return length;
+}
+
+int formatUnsigned(uint32_t value, char *buffer) {
+  char digits[FORMAT_INT_LENGTH];
+  char *end = digits + sizeof(digits);
+
+  return finish(writeDigits(value, end, 0), end, buffer);
+}
+
+int formatInt(int32_t value, char *buffer) {
+  char digits[FORMAT_INT_LENGTH];
+  char *end = digits + sizeof(digits);
+
+  // Negated as unsigned so INT32_MIN doesn't overflow
+  char *start = writeDigits(value < 0 ? 0 - (uint32_t)value : value, end, 0);
+  if(value < 0) *--start = '-';
+
+  return finish(start, end, buffer);
+}
+
+int formatFixed(float value, int precision, char *buffer) {
+  char digits[FORMAT_FIXED_LENGTH];
+  char *end = digits + sizeof(digits);
+  char *start;
+
+  if(precision < 0) precision = 0;
+  if(precision > FORMAT_MAX_PRECISION) precision = FORMAT_MAX_PRECISION;
+
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  bool negative = bits >> 31;
+  int exponent = (bits >> 23) & 0xFF;
+  uint32_t mantissa = bits & 0x7FFFFF;
+
+  // Infinity and NaN, and anything too big for the whole part to fit in 64
+  // bits
+  if(exponent == 0xFF || exponent > 150 + 40) {
+    start = end - 3;
+    memcpy(start, (exponent == 0xFF && mantissa ? "nan" : "inf"), 3);
+  } else {
+    // value is mantissa * 2^exponent from here on
+    if(exponent == 0) {
+      exponent = -149;
+    } else {
+      mantissa |= 0x800000;
+      exponent -= 150;
+    }
+
+    uint32_t scale = POWERS_OF_TEN[precision];
+    uint64_t whole = 0;
+    uint32_t fraction = 0;
+
+    if(exponent >= 0) {
+      whole = (uint64_t)mantissa << exponent;
+    } else if(exponent > -64) {
+      // Scale the fractional bits exactly, then round what's left over half
+      // to even like printf
+      int shift = -exponent;
+      uint64_t mask = ((uint64_t)1 << shift) - 1;
+      uint64_t scaled = (mantissa & mask) * (uint64_t)scale;
+      uint64_t remainder = scaled & mask;
+      uint64_t half = (uint64_t)1 << (shift - 1);
+
+      whole = (shift < 32 ? mantissa >> shift : 0);
+      fraction = scaled >> shift;
+
+      bool odd = (precision > 0 ? fraction : (uint32_t)whole) & 1;
+      if(remainder > half || (remainder == half && odd)) {
+        if(++fraction == scale) {
+          fraction = 0;
+          whole++;
+        }
+      }
+    }
+
+    start = end;
+    if(precision > 0) {
+      start = writeDigits(fraction, start, precision);
+      *--start = '.';
+    }
+    start = writeDigits64(whole, start);
+  }
+
+  if(negative) *--start = '-';
+  return finish(start, end, buffer);
+}
+
+static void writePair(char *at, int value) {
+  uint32_t pair = (uint32_t)value - divide100(value) * 100;
+  memcpy(at, DIGIT_PAIRS + 2 * pair, 2);
+}
+
+int formatIso8601(int year, int month, int day, int hour, int minute, int second, int millis, char *buffer) {
+  writePair(buffer, divide100(year));
+  writePair(buffer + 2, year);
+  buffer[4] = '-';
+  writePair(buffer + 5, month);
+  buffer[7] = '-';
+  writePair(buffer + 8, day);
+  buffer[10] = 'T';
+  writePair(buffer + 11, hour);
+  buffer[13] = ':';
+  writePair(buffer + 14, minute);
+  buffer[16] = ':';
+  writePair(buffer + 17, second);
+  buffer[19] = '.';
+  writeDigits(millis, buffer + 23, 3);
+  buffer[23] = 'Z';
+  buffer[24] = '\0';
+
+  return FORMAT_ISO_8601_LENGTH - 1;
+}
+
+}
@@ -0,0 +1,37 @@
+#ifndef FORMAT_H
+#define FORMAT_H
+
+// Number formatting without sprintf
+//
+// printf and Print::print(float) go through soft float (and double) on the
+// SAMD21. These work on the integer bits instead: a float is split into its
+// mantissa and exponent and scaled exactly in 64 bit integers, and digits are
+// written two at a time from a table of pairs. Output matches printf's %d, %u
+// and %.Nf, rounding ties to even like glibc.
+//
+// Each writes a terminated string into the caller's buffer and returns its
+// length. Nothing here is Arduino specific, so it can be checked on the host.
+
+#include <stdint.h>
+
+#define FORMAT_MAX_PRECISION 9
+#define FORMAT_INT_LENGTH 12     // "-2147483648" and the terminator
+#define FORMAT_FIXED_LENGTH 32   // sign, 20 digits, point, 9 decimals and the terminator
+#define FORMAT_ISO_8601_LENGTH 25 // "2024-06-21T14:03:07.250Z" and the terminator
+
+namespace Osprey {
+
+int formatUnsigned(uint32_t value, char *buffer);
+int formatInt(int32_t value, char *buffer);
+
+// value with precision decimals, which is clamped to FORMAT_MAX_PRECISION.
+// Magnitudes of 2^64 and over come out as "inf", like infinity.
+int formatFixed(float value, int precision, char *buffer);
+
+// UTC with milliseconds, e.g. "2024-06-21T14:03:07.250Z". year is the full
+// year and millis 0 to 999.
+int formatIso8601(int year, int month, int day, int hour, int minute, int second, int millis, char *buffer);
+
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+// One snapshot of every sensor, acquired once per tick. Each physical sensor
+// is read (and its filters updated) exactly once per frame and everything
+// downstream (events, the logger, telemetry) works off the same frame.
+
+// Bits in SensorFrame::fresh for measurements taken in this frame as opposed
+// to carried over from an earlier one
+#define FRAME_IMU 0x01
+#define FRAME_BARO 0x02
+
+// Bits in SensorFrame::derived for attitude values already worked out from
+// this frame's quaternion (see attitude.h)
+#define FRAME_EULER 0x01
+#define FRAME_TILT 0x02
+
+typedef struct SensorFrame {
+  unsigned long timestamp; // us, when acquisition started
+  unsigned char fresh;
+
+  // IMU
+  float acceleration[3];   // m/s^2, filtered
+  float accelerationG;     // magnitude of the raw acceleration
+  float quaternion[4];     // w, x, y, z from the BNO055 fusion
+  float gravity[3];        // m/s^2, from the BNO055 fusion
+  float verticalAcceleration; // m/s^2, up, gravity removed
+
+  // Attitude, only valid for the bits set in derived
+  unsigned char derived;
+  float roll;              // degrees
+  float pitch;             // degrees
+  float heading;           // degrees
+  float tilt;              // degrees from vertical
+
+  // Barometer
+  unsigned long baroTimestamp; // us, frame the latest sample arrived in
+  float pressure;          // Pa, filtered
+  float temperature;       // degrees C
+  float altitude;          // m above ground, from this sample alone
+
+  // Fused vertical state (see estimator.h)
+  float estimatedAltitude;     // m above ground
+  float velocity;              // m/s, up
+  float estimatedAcceleration; // m/s^2, up
+} SensorFrame;
+
+#endif
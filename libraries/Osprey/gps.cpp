@@ -1,7 +1,8 @@
 #include "gps.h"
+#include "format.h"
 
 Uart GPS::GPSSerial(&sercom1, GPS_RX_PIN, GPS_TX_PIN, SERCOM_RX_PAD_0, UART_TX_PAD_2);
-Adafruit_GPS GPS::gps = Adafruit_GPS(&GPS::GPSSerial);
+Osprey::Ring<char, GPS_RX_BUFFER_SIZE> GPS::rxRing;
 
 GPS::GPS() : Sensor(KALMAN_PROCESS_NOISE, KALMAN_MEASUREMENT_NOISE, KALMAN_ERROR) {
   latitude = 0;
@@ -22,13 +23,18 @@ int GPS::init() {
   pinPeripheral(GPS_TX_PIN, PIO_SERCOM);
 
   // Get RMC (recommended minimum) and GGA (fix data) data
-  gps.sendCommand(PMTK_SET_NMEA_OUTPUT_RMCGGA);
+  GPSSerial.println(PMTK_SET_NMEA_OUTPUT_RMCGGA);
 
   // Refresh data 5 times per second
-  gps.sendCommand(PMTK_SET_NMEA_UPDATE_5HZ);
-  gps.sendCommand(PMTK_API_SET_FIX_CTL_5HZ);
-
-  delay(1000);
+  GPSSerial.println(PMTK_SET_NMEA_UPDATE_5HZ);
+  GPSSerial.println(PMTK_API_SET_FIX_CTL_5HZ);
+
+  // Give the receiver a second to take the commands, parsing what it sends
+  // meanwhile so the buffer doesn't overflow before the tasks start
+  for(int i=0; i<GPS_INIT_WAIT; i++) {
+    delay(1);
+    update();
+  }
 
   return 1;
 }
@@ -36,16 +42,30 @@ int GPS::init() {
 void SERCOM1_Handler() {
   // Call the interrupt handler for the serial object before trying to read from it
   GPS::GPSSerial.IrqHandler();
-  GPS::gps.read();
 
-  // After reading available data, if a new NMEA sentence is available, parse it
-  if(GPS::gps.newNMEAreceived()) {
-    GPS::gps.parse(GPS::gps.lastNMEA());
+  // Only pass the bytes on. Parsing them here would hold off every other
+  // interrupt, so it waits for update() in task context.
+  while(GPS::GPSSerial.available()) {
+    GPS::rxRing.push(GPS::GPSSerial.read());
   }
 }
 
-float GPS::getLatitude() {
-  float newLatitude = gps.latitudeDegrees;
+void GPS::update() {
+  char c;
+
+  // At most what was buffered when it started, so a fast stream can't keep
+  // it here
+  for(unsigned i=0; i<rxRing.capacity() && rxRing.pop(&c); i++) {
+    nmea.feed(c);
+  }
+}
+
+const gps_fix_t& GPS::getFix() {
+  return nmea.getFix();
+}
+
+int32_t GPS::getLatitude() {
+  int32_t newLatitude = nmea.getFix().latitude;
 
   // Return the previous coordinate if the next one isn't valid
   if(validCoordinate(latitude, newLatitude, &latitudeOutOfRange) == 0) {
@@ -56,8 +76,8 @@ float GPS::getLatitude() {
   return latitude;
 }
 
-float GPS::getLongitude() {
-  float newLongitude = gps.longitudeDegrees;
+int32_t GPS::getLongitude() {
+  int32_t newLongitude = nmea.getFix().longitude;
 
   // Return the previous coordinate if the next one isn't valid
   if(validCoordinate(longitude, newLongitude, &longitudeOutOfRange) == 0) {
@@ -68,7 +88,9 @@ float GPS::getLongitude() {
   return longitude;
 }
 
-int GPS::validCoordinate(float previous, float next, int *outOfRange) {
+// In the fix's 1e-7 degrees, since a float only holds them to 32 units (about
+// 0.35 m) at 40 degrees
+int GPS::validCoordinate(int32_t previous, int32_t next, int *outOfRange) {
   // If we keep reading seemingly invali coordinates over and over, they're probably valid
   if(*outOfRange > OUT_OF_RANGE_LIMIT) {
     *outOfRange = 0;
@@ -76,14 +98,15 @@ int GPS::validCoordinate(float previous, float next, int *outOfRange) {
   }
 
   // Ignore ~0.00 coordinates (obviously doesn't work if within 1 degree of the equator or meridian, but good enough for now)
-  if(next < 1 && next > -1) {
+  if(next < COORDINATE_DEGREE && next > -COORDINATE_DEGREE) {
     return 0;
   }
 
   // Ignore anything greater than the out of range delta from the previous coordinate as there's
   // no way to move that fast except in the case of initially acquiring a location when the
   // previous coordinate will be 0
-  if(previous != 0 && abs(next - previous) > OUT_OF_RANGE_DELTA) {
+  int64_t delta = (int64_t)next - previous;
+  if(previous != 0 && (delta > OUT_OF_RANGE_DELTA || delta < -OUT_OF_RANGE_DELTA)) {
     (*outOfRange)++;
     return 0;
   }
@@ -95,20 +118,33 @@ int GPS::validCoordinate(float previous, float next, int *outOfRange) {
 }
 
 float GPS::getSpeed() {
-  kalmanUpdate(&speed, gps.speed);
-  return speed.value;
+  kalmanUpdate(&speed, kalmanRatio(nmea.getFix().speed, 100));
+  return kalmanValue(&speed);
 }
 
 float GPS::getAltitude() {
-  kalmanUpdate(&altitude, gps.altitude);
-  return altitude.value;
+  kalmanUpdate(&altitude, kalmanRatio(nmea.getFix().altitude, 100));
+  return kalmanValue(&altitude);
 }
 
 int GPS::getQuality() {
-  return gps.fixquality;
+  return nmea.getFix().quality;
 }
 
 char* GPS::getIso8601() {
-  sprintf(iso8601, "20%02d-%02d-%02dT%02d:%02d:%02d.%02dZ", gps.year, gps.month, gps.day, gps.hour, gps.minute, gps.seconds, gps.milliseconds);
+  const gps_fix_t &fix = nmea.getFix();
+  Osprey::formatIso8601(2000 + fix.year, fix.month, fix.day, fix.hour, fix.minute, fix.second, fix.millis, iso8601);
   return iso8601;
 }
+
+unsigned long GPS::getSentences() {
+  return nmea.getSentences();
+}
+
+unsigned long GPS::getErrors() {
+  return nmea.getErrors();
+}
+
+unsigned long GPS::getDropped() {
+  return rxRing.getDropped();
+}
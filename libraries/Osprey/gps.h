@@ -1,19 +1,24 @@
 #ifndef GPS_H
 #define GPS_H
 
-#include <Adafruit_GPS.h>
+#include <Adafruit_GPS.h> // only for the PMTK commands
 #include <stdlib.h>
 #include <wiring_private.h>
 #include <Wire.h>
 
+#include "nmea.h"
+#include "ring.h"
 #include "sensor.h"
 
 #define GPS_RX_PIN 11
 #define GPS_TX_PIN 10
 #define GPS_BAUD 9600
 #define ISO_8601_LENGTH 32
+#define GPS_RX_BUFFER_SIZE 256 // bytes, over a quarter of a second at 9600 baud
+#define GPS_INIT_WAIT 1000 // ms
 
-#define OUT_OF_RANGE_DELTA 0.001
+#define OUT_OF_RANGE_DELTA 10000 // 1e-7 degrees, 0.001 degrees or about 100 m
+#define COORDINATE_DEGREE 10000000L // 1e-7 degrees
 #define OUT_OF_RANGE_LIMIT 5
 
 #define KALMAN_PROCESS_NOISE 0.01
@@ -25,23 +30,33 @@ class GPS : public virtual Sensor {
     GPS();
     int init();
 
-    float getLatitude();
-    float getLongitude();
+    // Parses whatever the receiver has sent since the last call
+    void update();
+    const gps_fix_t& getFix();
+
+    int32_t getLatitude();  // 1e-7 degrees, as the fix has it
+    int32_t getLongitude(); // 1e-7 degrees
     float getSpeed();
     float getAltitude();
     int getQuality();
     char* getIso8601();
 
+    unsigned long getSentences();
+    unsigned long getErrors();
+    static unsigned long getDropped();
+
     static Uart GPSSerial;
-    static Adafruit_GPS gps;
+    static Osprey::Ring<char, GPS_RX_BUFFER_SIZE> rxRing;
 
   protected:
-    int validCoordinate(float previous, float next, int *outOfRange);
+    Osprey::NmeaParser nmea;
+
+    int validCoordinate(int32_t previous, int32_t next, int *outOfRange);
 
     char iso8601[ISO_8601_LENGTH];
 
-    float latitude;
-    float longitude;
+    int32_t latitude;  // 1e-7 degrees
+    int32_t longitude;
 
     int latitudeOutOfRange;
     int longitudeOutOfRange;
@@ -0,0 +1,245 @@
+#ifndef INTEGRATOR_H
+#define INTEGRATOR_H
+
+// Adaptive step Dormand-Prince 5(4) integrator
+//
+// Every step makes a fifth order estimate and an embedded fourth order one.
+// Their difference is the local error, which decides whether the step is
+// kept and how long the next one should be. The last stage of a step is the
+// first of the next (FSAL), so an accepted step costs six derivative
+// evaluations. A fourth order dense output interpolates anywhere inside the
+// last step at no extra cost, which is used to sample on a fixed grid and to
+// locate events exactly.
+//
+// Templated on the state and the derivative function, which is called as
+// f(x, t) and returns dx/dt. The state needs these free functions, found by
+// argument dependent lookup:
+//
+//   State add(State a, State b);
+//   State mult(float c, State x);
+//   float errorNorm(State error, State x0, State x1, float rtol, float atol);
+//
+// where errorNorm scales each component of the error by atol + rtol |x| and
+// returns the largest, so a step is good when it is at most 1.
+
+#include <math.h>
+
+#define INTEGRATOR_SAFETY 0.9f
+#define INTEGRATOR_MIN_SHRINK 0.2f
+#define INTEGRATOR_MAX_GROW 5.0f
+#define INTEGRATOR_MAX_REJECTS 20
+#define INTEGRATOR_EVENT_ITERATIONS 8
+
+// Results of integrate()
+#define INTEGRATOR_FAILED -1    // the error couldn't be met
+#define INTEGRATOR_UNFINISHED 0 // took maxSteps steps, call again to carry on
+#define INTEGRATOR_END 1        // reached tEnd
+#define INTEGRATOR_EVENT 2      // the event fired
+
+namespace Osprey {
+
+template<typename State, typename Derivative>
+class DormandPrince {
+  public:
+    DormandPrince(Derivative f, float rtol, float atol, float initialStep)
+      : f(f), rtol(rtol), atol(atol), h(initialStep), minStep(initialStep * 1e-4f), maxStep(0) {
+      resetStats();
+    }
+
+    void setStepLimits(float minStep, float maxStep) {
+      this->minStep = minStep;
+      this->maxStep = maxStep;
+    }
+
+    void resetStats() {
+      steps = 0;
+      rejected = 0;
+      evaluations = 0;
+      haveDerivative = false;
+    }
+
+    // Call when the state was changed from outside between steps
+    void restart() {
+      haveDerivative = false;
+    }
+
+    // One accepted step from (x, t), not going past tEnd. Returns 0 and leaves
+    // x and t alone if the error can't be met with a step of at least the
+    // minimum size.
+    int step(State &x, float &t, float tEnd) {
+      if(!haveDerivative) {
+        k1 = evaluate(x, t);
+        haveDerivative = true;
+      }
+
+      for(int attempt=0; attempt<INTEGRATOR_MAX_REJECTS; attempt++) {
+        bool last = false;
+        if(t + h >= tEnd) {
+          h = tEnd - t;
+          last = true;
+        }
+
+        State k2 = evaluate(add(x, mult(h * A21, k1)), t + C2 * h);
+        State k3 = evaluate(add(x, add(mult(h * A31, k1), mult(h * A32, k2))), t + C3 * h);
+        State k4 = evaluate(add(x, add(add(mult(h * A41, k1), mult(h * A42, k2)), mult(h * A43, k3))), t + C4 * h);
+        State k5 = evaluate(add(x, add(add(mult(h * A51, k1), mult(h * A52, k2)), add(mult(h * A53, k3), mult(h * A54, k4)))), t + C5 * h);
+        State k6 = evaluate(add(x, add(add(add(mult(h * A61, k1), mult(h * A62, k2)), add(mult(h * A63, k3), mult(h * A64, k4))), mult(h * A65, k5))), t + h);
+
+        // Fifth order solution, which is also where the last stage is taken
+        State next = add(x, add(add(mult(h * B1, k1), mult(h * B3, k3)), add(add(mult(h * B4, k4), mult(h * B5, k5)), mult(h * B6, k6))));
+        State k7 = evaluate(next, t + h);
+
+        State error = add(add(mult(h * E1, k1), mult(h * E3, k3)), add(add(mult(h * E4, k4), mult(h * E5, k5)), add(mult(h * E6, k6), mult(h * E7, k7))));
+        float norm = errorNorm(error, x, next, rtol, atol);
+
+        float scale = norm > 0 ? INTEGRATOR_SAFETY * powf(norm, -0.2f) : INTEGRATOR_MAX_GROW;
+        if(scale < INTEGRATOR_MIN_SHRINK) scale = INTEGRATOR_MIN_SHRINK;
+        if(scale > INTEGRATOR_MAX_GROW) scale = INTEGRATOR_MAX_GROW;
+
+        if(norm <= 1) {
+          // Keep what the dense output needs before moving on
+          x0 = x;
+          t0 = t;
+          stepSize = h;
+          dense[0] = add(next, mult(-1, x));
+          dense[1] = add(mult(h, k1), mult(-1, dense[0]));
+          dense[2] = add(add(dense[0], mult(-h, k7)), mult(-1, dense[1]));
+          dense[3] = add(add(add(mult(h * D1, k1), mult(h * D3, k3)), add(mult(h * D4, k4), mult(h * D5, k5))), add(mult(h * D6, k6), mult(h * D7, k7)));
+
+          x = next;
+          t = last ? tEnd : t + h;
+          k1 = k7;
+          steps++;
+
+          // A step cut short to land on tEnd says nothing about the next one
+          if(!last) h *= scale;
+          if(maxStep > 0 && h > maxStep) h = maxStep;
+          return 1;
+        }
+
+        rejected++;
+        h *= scale;
+        if(h < minStep) {
+          return 0;
+        }
+      }
+
+      return 0;
+    }
+
+    // The solution at time t inside the last accepted step
+    State interpolate(float t) const {
+      float theta = (t - t0) / stepSize;
+      float eta = 1 - theta;
+      return add(x0, mult(theta, add(dense[0], mult(eta, add(dense[1], mult(theta, add(dense[2], mult(eta, dense[3]))))))));
+    }
+
+    // Integrates until tEnd, or until event(x) falls from above zero to zero
+    // or below, in which case x and t are moved back to where it crossed. At
+    // most maxSteps steps are taken, so a caller with a time budget can
+    // integrate a few steps at a time.
+    template<typename Event>
+    int integrate(State &x, float &t, float tEnd, Event event, int maxSteps) {
+      float before = event(x);
+
+      for(int i=0; i<maxSteps; i++) {
+        if(t >= tEnd) {
+          return INTEGRATOR_END;
+        }
+
+        if(!step(x, t, tEnd)) {
+          return INTEGRATOR_FAILED;
+        }
+
+        float after = event(x);
+        if(before > 0 && after <= 0) {
+          locate(x, t, event, before, after);
+          return INTEGRATOR_EVENT;
+        }
+        before = after;
+      }
+
+      return t >= tEnd ? INTEGRATOR_END : INTEGRATOR_UNFINISHED;
+    }
+
+    float getStep() const { return h; }
+    int getSteps() const { return steps; }
+    int getRejected() const { return rejected; }
+    int getEvaluations() const { return evaluations; }
+
+  protected:
+    Derivative f;
+    float rtol;
+    float atol;
+    float h;
+    float minStep;
+    float maxStep;
+
+    State k1;
+    bool haveDerivative;
+
+    // Dense output for the last step
+    State x0;
+    float t0;
+    float stepSize;
+    State dense[4];
+
+    int steps;
+    int rejected;
+    int evaluations;
+
+    State evaluate(State x, float t) {
+      evaluations++;
+      return f(x, t);
+    }
+
+    // Illinois false position on the dense output, between the start of the
+    // last step where the event was above zero and its end where it wasn't
+    template<typename Event>
+    void locate(State &x, float &t, Event event, float before, float after) {
+      float a = t0, b = t0 + stepSize;
+      float ga = before, gb = after;
+      int side = 0;
+
+      for(int i=0; i<INTEGRATOR_EVENT_ITERATIONS; i++) {
+        float c = b - gb * (b - a) / (gb - ga);
+        float gc = event(interpolate(c));
+
+        if(gc > 0) {
+          a = c;
+          ga = gc;
+          if(side == -1) gb /= 2;
+          side = -1;
+        } else {
+          b = c;
+          gb = gc;
+          if(side == 1) ga /= 2;
+          side = 1;
+        }
+      }
+
+      t = b;
+      x = interpolate(b);
+      haveDerivative = false;
+    }
+
+    // Dormand-Prince tableau
+    static constexpr float C2 = 1.0f / 5, C3 = 3.0f / 10, C4 = 4.0f / 5, C5 = 8.0f / 9;
+    static constexpr float A21 = 1.0f / 5;
+    static constexpr float A31 = 3.0f / 40, A32 = 9.0f / 40;
+    static constexpr float A41 = 44.0f / 45, A42 = -56.0f / 15, A43 = 32.0f / 9;
+    static constexpr float A51 = 19372.0f / 6561, A52 = -25360.0f / 2187, A53 = 64448.0f / 6561, A54 = -212.0f / 729;
+    static constexpr float A61 = 9017.0f / 3168, A62 = -355.0f / 33, A63 = 46732.0f / 5247, A64 = 49.0f / 176, A65 = -5103.0f / 18656;
+    static constexpr float B1 = 35.0f / 384, B3 = 500.0f / 1113, B4 = 125.0f / 192, B5 = -2187.0f / 6784, B6 = 11.0f / 84;
+
+    // Fifth minus fourth order weights
+    static constexpr float E1 = 71.0f / 57600, E3 = -71.0f / 16695, E4 = 71.0f / 1920, E5 = -17253.0f / 339200, E6 = 22.0f / 525, E7 = -1.0f / 40;
+
+    // Dense output (Hairer, Norsett and Wanner)
+    static constexpr float D1 = -12715105075.0f / 11282082432, D3 = 87487479700.0f / 32700410799, D4 = -10690763975.0f / 1880347072,
+                           D5 = 701980252875.0f / 199316789632, D6 = -1453857185.0f / 822651844, D7 = 69997945.0f / 29380423;
+};
+
+}
+
+#endif
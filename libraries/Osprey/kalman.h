@@ -1,12 +1,30 @@
 #ifndef KALMAN_H
 #define KALMAN_H
 
+#include "fixed.h"
+
+#if FIXED_POINT_MATH
+typedef Osprey::Fixed kalman_value_t;
+#else
+typedef float kalman_value_t;
+#endif
+
 typedef struct {
-  float processNoise;     // process noise covariance
-  float measurementNoise; // measurement noise covariance
-  float value;            // value
-  float error;            // estimation error covariance
-  float gain;             // kalman gain
+  kalman_value_t processNoise;     // process noise covariance
+  kalman_value_t measurementNoise; // measurement noise covariance
+  kalman_value_t value;            // value
+  kalman_value_t error;            // estimation error covariance
+  kalman_value_t gain;             // kalman gain
 } kalman_t;
 
+// num / den as a filter input. Integer sensor readings go in through this so
+// fixed point builds never pass through float.
+static inline kalman_value_t kalmanRatio(int32_t num, int32_t den) {
+#if FIXED_POINT_MATH
+  return Osprey::Fixed::fromRatio(num, den);
+#else
+  return num * (1.0f / den);
+#endif
+}
+
 #endif
@@ -1,42 +1,317 @@
 #include "logger.h"
 
-Logger::Logger() {}
+Logger::Logger() {
+  mode = LOGGER_MODE_FILE;
+  recording = 0;
+  currentBlock = 0;
+  blockPosition = 0;
+  lastSync = 0;
+  blocksWritten = 0;
+  writeErrors = 0;
+}
 
 int Logger::init() {
-  while(!SD.begin(SD_CHIP_SELECT)) {
+  while(!SD.begin(SD_CHIP_SELECT, SD_SCK_RATE)) {
     delay(25);
   }
 
   return 1;
 }
 
+void Logger::setMode(int mode) {
+  // Switching modes under an open or prepared log would orphan it
+  if(isOpen() || recorder.isOpen()) return;
+
+  this->mode = mode;
+}
+
+int Logger::getMode() {
+  return mode;
+}
+
 int Logger::open() {
-  char filename[20];
+  currentBlock = 0;
+  blockPosition = 0;
+  lastSync = millis();
+
+  int opened;
+  if(mode == LOGGER_MODE_RECORDER) {
+    opened = openRecorder();
+  } else {
+    char filename[20];
+    nextFilename(filename);
+    opened = openFile(filename);
+  }
+  if(!opened) {
+    return 0;
+  }
+
+  logHeader();
+  return 1;
+}
+
+// The first unused log name, returning its number
+int Logger::nextFilename(char *filename) {
   int logNumber = 0;
 
-  // Find the first unused log number
-  do {
+  while(true) {
     sprintf(filename, FILENAME_FORMAT, logNumber);
+    if(!SD.exists(filename)) return logNumber;
     logNumber++;
-  } while(SD.exists(filename));
+  }
+}
 
+int Logger::openFile(const char *filename) {
+  // The file stays open for the whole flight so the directory lookup and
+  // allocation only happen once rather than on every record
   file = SD.open(filename, FILE_WRITE);
 
   return (file ? 1 : 0);
 }
 
+// Allocates and erases the recorder file, which takes the card a long time
+// for 64 MB, so it's done at start up rather than when the log is opened. A
+// file prepared on an earlier power up that never logged anything is still
+// full size and has no log header, and is replaced rather than left to fill
+// the card.
+int Logger::prepare() {
+  if(mode != LOGGER_MODE_RECORDER) return 0;
+  if(recorder.isOpen()) return 1;
+
+  char filename[20];
+  int logNumber = nextFilename(filename);
+
+  if(logNumber > 0) {
+    char previous[20];
+    sprintf(previous, FILENAME_FORMAT, logNumber - 1);
+    if(isUnusedRecorder(previous) && SD.remove(previous)) {
+      strcpy(filename, previous);
+    }
+  }
+
+  if(!SD.createContiguous(recorder, filename, LOGGER_RECORDER_SIZE)) {
+    return 0;
+  }
+
+  if(!recorder.contiguousRange(&firstBlock, &lastBlock)) {
+    recorder.remove();
+    return 0;
+  }
+
+  // Erase now rather than letting the card do it during flight. Not every card
+  // supports it, in which case the pre-erase count given to writeStart is the
+  // best we can do.
+  SD.sdCard().erase(firstBlock, lastBlock);
+
+  return 1;
+}
+
+int Logger::isUnusedRecorder(const char *filename) {
+  File previous = SD.open(filename, FILE_READ);
+  if(!previous) return 0;
+
+  // Erased blocks read back as all zeros or all ones, never the magic
+  uint32_t magic = 0;
+  int unused = (previous.size() == LOGGER_RECORDER_SIZE);
+  for(unsigned i=0; unused && i<sizeof(magic); i++) {
+    magic |= (uint32_t)(uint8_t)previous.read() << (8 * i);
+  }
+  previous.close();
+
+  return unused && magic != RECORD_MAGIC;
+}
+
+// Only starts the multiple block write into the prepared file. If none was
+// prepared, say for a second flight without a power cycle, it's prepared here
+// and the erase holds up everything else until it's done.
+int Logger::openRecorder() {
+  if(!prepare()) {
+    return 0;
+  }
+
+  if(!SD.sdCard().writeStart(firstBlock, lastBlock - firstBlock + 1)) {
+    recorder.remove();
+    return 0;
+  }
+
+  nextBlock = firstBlock;
+  bytesLogged = 0;
+  pendingBytes = 0;
+  recording = 1;
+
+  return 1;
+}
+
 void Logger::close() {
+  if(mode == LOGGER_MODE_RECORDER) {
+    closeRecorder();
+    return;
+  }
+
+  // The tail that never filled a block only goes out now
+  if(blockPosition > 0) {
+    writeBlock(blocks[currentBlock], blockPosition);
+    blockPosition = 0;
+  }
+
   file.close();
 }
 
+void Logger::closeRecorder() {
+  if(!recording) return;
+
+  // The last block is padded out with zeros, which read back as RECORD_END
+  if(blockPosition > 0) {
+    memset(&blocks[currentBlock][blockPosition], 0, LOGGER_BLOCK_SIZE - blockPosition);
+    writeBlock(blocks[currentBlock], blockPosition);
+    blockPosition = 0;
+  }
+
+  finishBlock();
+  if(!SD.sdCard().writeStop()) {
+    writeErrors++;
+  }
+
+  // Only now does the FAT learn how much of the file was actually used
+  recorder.truncate(bytesLogged);
+  recorder.close();
+  recording = 0;
+}
+
 void Logger::flush() {
-  file.flush();
+  // Nothing can be committed mid-flight in recorder mode without padding a
+  // block, and there is no directory entry to update until the log is closed
+  if(mode == LOGGER_MODE_RECORDER) return;
+
+  // A partial block stays staged. Writing it would leave the file off a block
+  // boundary, and every full block after it would then straddle two card
+  // blocks and go through SdFile's cache instead of straight to the card.
+  sync();
+}
+
+int Logger::isOpen() {
+  if(mode == LOGGER_MODE_RECORDER) {
+    return recording;
+  }
+
+  return (file ? 1 : 0);
 }
 
 void Logger::log(const char* message) {
-  file.write(message);
+  write(message);
 }
 
 void Logger::log(float n) {
-  file.write(n);
+  write((const uint8_t*)&n, sizeof(n));
+}
+
+void Logger::log(uint8_t type, const void* record, uint8_t length) {
+  record_header_t header;
+  header.type = type;
+  header.length = length;
+  header.timestamp = millis();
+
+  write((const uint8_t*)&header, sizeof(header));
+  write((const uint8_t*)record, length);
+}
+
+void Logger::logHeader() {
+  log_header_t header;
+  header.magic = RECORD_MAGIC;
+  header.version = RECORD_VERSION;
+  header.schema = RECORD_SCHEMA;
+  header.startTime = millis();
+
+  write((const uint8_t*)&header, sizeof(header));
+}
+
+size_t Logger::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t Logger::write(const uint8_t *buffer, size_t size) {
+  // Nothing is kept between flights
+  if(!isOpen()) return 0;
+
+  size_t remaining = size;
+
+  while(remaining > 0) {
+    size_t space = LOGGER_BLOCK_SIZE - blockPosition;
+    size_t n = (remaining < space ? remaining : space);
+
+    memcpy(&blocks[currentBlock][blockPosition], buffer, n);
+    blockPosition += n;
+    buffer += n;
+    remaining -= n;
+
+    // Only full blocks go to the card, then move on to the next staging buffer
+    if(blockPosition == LOGGER_BLOCK_SIZE) {
+      writeBlock(blocks[currentBlock], LOGGER_BLOCK_SIZE);
+      currentBlock = (currentBlock + 1) % LOGGER_NUM_BLOCKS;
+      blockPosition = 0;
+
+      if(millis() - lastSync >= LOGGER_SYNC_INTERVAL) {
+        sync();
+      }
+    }
+  }
+
+  return size;
+}
+
+void Logger::writeBlock(const uint8_t *block, size_t size) {
+  if(mode == LOGGER_MODE_RECORDER) {
+    // The card always takes a whole block, but only size bytes of it are log
+    // data. Blocks past the end of the pre-allocated file are dropped.
+    if(!recording || nextBlock > lastBlock) {
+      writeErrors++;
+      return;
+    }
+
+    // The block is sent in the background while the next staging buffer
+    // fills. Finishing off the one before is what frees up that buffer for
+    // reuse.
+    finishBlock();
+    if(!SD.sdCard().writeDataStart(block)) {
+      writeErrors++;
+      return;
+    }
+
+    pendingBytes = (nextBlock - firstBlock) * LOGGER_BLOCK_SIZE + size;
+    nextBlock++;
+  } else if(!file || file.write(block, size) != size) {
+    writeErrors++;
+    return;
+  }
+
+  blocksWritten++;
+}
+
+// Waits for the block in flight, if any. Only once the card has accepted it
+// does it count towards what truncate() keeps.
+void Logger::finishBlock() {
+  Sd2Card &card = SD.sdCard();
+  if(!card.writePending()) return;
+
+  if(card.writeDataFinish()) {
+    bytesLogged = pendingBytes;
+  } else {
+    writeErrors++;
+  }
+}
+
+void Logger::sync() {
+  if(mode == LOGGER_MODE_FILE) {
+    file.flush();
+  }
+
+  lastSync = millis();
+}
+
+unsigned long Logger::getBlocksWritten() {
+  return blocksWritten;
+}
+
+unsigned long Logger::getWriteErrors() {
+  return writeErrors;
 }
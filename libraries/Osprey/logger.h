@@ -2,26 +2,83 @@
 #define LOGGER_H
 
 #define SD_CHIP_SELECT 4
+#define SD_SCK_RATE SPI_FULL_SPEED
 #define FILENAME_FORMAT "%d.log" // https://en.wikipedia.org/wiki/8.3_filename
 
+// Records are staged in RAM and only ever written to the card as whole blocks
+#define LOGGER_BLOCK_SIZE 512
+#define LOGGER_NUM_BLOCKS 2
+
+// Longest time written data can sit on the card before the directory entry is updated
+#define LOGGER_SYNC_INTERVAL 1000 // ms
+
+// In file mode every block goes through the FAT file system. In recorder mode
+// a contiguous file is allocated and erased up front by prepare() and blocks
+// are streamed straight to the card with one multiple block write, so nothing
+// touches the FAT until the log is closed.
+#define LOGGER_MODE_FILE 0
+#define LOGGER_MODE_RECORDER 1
+#define LOGGER_RECORDER_SIZE 67108864UL // 64 MB
+
 #include <SPI.h>
-#include "SD.h"
+#include <SD.h>
 
 #include "constants.h"
+#include "record.h"
 #include "sensor.h"
 
-class Logger : public virtual Sensor {
+class Logger : public virtual Sensor, public Print {
   public:
     Logger();
     int init();
+    int prepare();
+    void setMode(int mode);
+    int getMode();
     int open();
     void close();
     void flush();
+    int isOpen();
     void log(const char* message);
     void log(float n);
+    void log(uint8_t type, const void* record, uint8_t length);
+
+    virtual size_t write(uint8_t c);
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    using Print::write;
+
+    unsigned long getBlocksWritten();
+    unsigned long getWriteErrors();
 
   protected:
+    int nextFilename(char *filename);
+    int isUnusedRecorder(const char *filename);
+    int openFile(const char *filename);
+    int openRecorder();
+    void closeRecorder();
+    void finishBlock();
+    void logHeader();
+    void writeBlock(const uint8_t *block, size_t size);
+    void sync();
+
+    int mode;
     File file;
+
+    // Recorder mode state
+    SdFile recorder;       // open from prepare() until the log is closed
+    int recording;         // between open() and close()
+    uint32_t firstBlock;
+    uint32_t nextBlock;
+    uint32_t lastBlock;
+    uint32_t bytesLogged;  // up to the end of the last block the card accepted
+    uint32_t pendingBytes; // bytesLogged once the block in flight is accepted
+
+    uint8_t blocks[LOGGER_NUM_BLOCKS][LOGGER_BLOCK_SIZE];
+    int currentBlock;
+    int blockPosition;
+
+    unsigned long lastSync;
+    unsigned long blocksWritten;
+    unsigned long writeErrors;
 };
 
 #endif
@@ -0,0 +1,243 @@
+#include "nmea.h"
+
+#include <string.h>
+
+namespace Osprey {
+
+// Bits in NmeaParser::received
+#define NMEA_RMC 0x01
+#define NMEA_GGA 0x02
+
+// count digits as a number, or -1 if they aren't all there
+static int digits(const char *s, int count) {
+  int value = 0;
+
+  for(int i=0; i<count; i++) {
+    if(s[i] < '0' || s[i] > '9') return -1;
+    value = value * 10 + (s[i] - '0');
+  }
+
+  return value;
+}
+
+static int hexDigit(char c) {
+  if(c >= '0' && c <= '9') return c - '0';
+  if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// "-123.45" as an integer in 10^-decimals, with any further decimals dropped
+static bool parseScaled(const char *s, int decimals, int32_t *value) {
+  bool negative = (*s == '-');
+  if(negative) s++;
+  if(*s == '\0') return false;
+
+  int32_t result = 0;
+  while(*s >= '0' && *s <= '9') {
+    result = result * 10 + (*s++ - '0');
+  }
+
+  if(*s == '.') s++;
+  for(int i=0; i<decimals; i++) {
+    result *= 10;
+    if(*s >= '0' && *s <= '9') result += *s++ - '0';
+  }
+  while(*s >= '0' && *s <= '9') s++;
+
+  if(*s != '\0') return false;
+
+  *value = (negative ? -result : result);
+  return true;
+}
+
+// "ddmm.mmmmm" (or dddmm for longitude) and a hemisphere, in 1e-7 degrees
+static bool parseCoordinate(const char *s, const char *hemisphere, int32_t *value) {
+  int32_t scaled;
+  if(!parseScaled(s, 5, &scaled) || scaled < 0) return false;
+
+  // 1e-5 minutes are 5/3 of 1e-7 degrees
+  int32_t degrees = scaled / 10000000;
+  int32_t minutes = scaled - degrees * 10000000;
+  int32_t result = degrees * 10000000 + (minutes * 5 + 1) / 3;
+
+  if(*hemisphere == 'S' || *hemisphere == 'W') {
+    result = -result;
+  } else if(*hemisphere != 'N' && *hemisphere != 'E') {
+    return false;
+  }
+
+  *value = result;
+  return true;
+}
+
+NmeaParser::NmeaParser() {
+  memset(fixes, 0, sizeof(fixes));
+  front = 0;
+  received = 0;
+  epochTime = -1;
+
+  length = 0;
+  collecting = false;
+
+  sentences = 0;
+  errors = 0;
+  published = 0;
+}
+
+bool NmeaParser::feed(char c) {
+  if(c == '$') {
+    // A sentence cut short by lost bytes
+    if(collecting) errors++;
+
+    collecting = true;
+    length = 0;
+    return false;
+  }
+
+  if(!collecting) return false;
+
+  if(c == '\r' || c == '\n') {
+    collecting = false;
+    sentence[length] = '\0';
+    return parse();
+  }
+
+  if(length == NMEA_MAX_SENTENCE - 1) {
+    collecting = false;
+    errors++;
+    return false;
+  }
+
+  sentence[length++] = c;
+  return false;
+}
+
+// The sentence is everything between the "$" and the line ending
+bool NmeaParser::parse() {
+  sentences++;
+
+  if(length < 4 || sentence[length - 3] != '*') {
+    errors++;
+    return false;
+  }
+
+  uint8_t checksum = 0;
+  for(int i=0; i<length - 3; i++) {
+    checksum ^= sentence[i];
+  }
+
+  int high = hexDigit(sentence[length - 2]);
+  int low = hexDigit(sentence[length - 1]);
+  if(high < 0 || low < 0 || checksum != (high << 4 | low)) {
+    errors++;
+    return false;
+  }
+
+  // Split the fields in place
+  char *fields[NMEA_MAX_FIELDS];
+  int count = 1;
+
+  sentence[length - 3] = '\0';
+  fields[0] = sentence;
+  for(char *p = sentence; *p != '\0'; p++) {
+    if(*p == ',') {
+      *p = '\0';
+      if(count < NMEA_MAX_FIELDS) fields[count++] = p + 1;
+    }
+  }
+
+  // Any talker, so GPRMC and GNRMC are both RMC
+  if(strlen(fields[0]) != 5) return false;
+
+  if(strcmp(fields[0] + 2, "RMC") == 0) {
+    parseRmc(fields, count);
+  } else if(strcmp(fields[0] + 2, "GGA") == 0) {
+    parseGga(fields, count);
+  } else {
+    return false;
+  }
+
+  if(received != (NMEA_RMC | NMEA_GGA)) return false;
+
+  front ^= 1;
+  published++;
+  epochTime = -1;
+  return true;
+}
+
+// Sentences with a new time start a new fix from the last published one, so
+// anything they don't carry stays as it was
+bool NmeaParser::startEpoch(const char *time) {
+  int32_t value;
+  if(digits(time, 6) < 0 || !parseScaled(time, 3, &value)) return false;
+
+  gps_fix_t &fix = fixes[front ^ 1];
+  if(value != epochTime) {
+    fix = fixes[front];
+    received = 0;
+    epochTime = value;
+  }
+
+  fix.hour = digits(time, 2);
+  fix.minute = digits(time + 2, 2);
+  fix.second = digits(time + 4, 2);
+  fix.millis = value % 1000;
+  return true;
+}
+
+// $GPRMC,time,status,latitude,N/S,longitude,E/W,knots,course,ddmmyy,...
+void NmeaParser::parseRmc(char **fields, int count) {
+  if(count < 10 || !startEpoch(fields[1])) {
+    errors++;
+    return;
+  }
+
+  gps_fix_t &fix = fixes[front ^ 1];
+
+  if(digits(fields[9], 6) >= 0) {
+    fix.day = digits(fields[9], 2);
+    fix.month = digits(fields[9] + 2, 2);
+    fix.year = digits(fields[9] + 4, 2);
+  }
+
+  // Void until the receiver has a fix
+  int32_t latitude, longitude, speed;
+  if(*fields[2] == 'A' &&
+     parseCoordinate(fields[3], fields[4], &latitude) &&
+     parseCoordinate(fields[5], fields[6], &longitude) &&
+     parseScaled(fields[7], 2, &speed)) {
+    fix.latitude = latitude;
+    fix.longitude = longitude;
+    fix.speed = (speed > UINT16_MAX ? UINT16_MAX : speed);
+  }
+
+  received |= NMEA_RMC;
+}
+
+// $GPGGA,time,latitude,N/S,longitude,E/W,quality,satellites,hdop,altitude,M,...
+void NmeaParser::parseGga(char **fields, int count) {
+  if(count < 10 || !startEpoch(fields[1])) {
+    errors++;
+    return;
+  }
+
+  gps_fix_t &fix = fixes[front ^ 1];
+
+  int32_t quality, satellites;
+  fix.quality = (parseScaled(fields[6], 0, &quality) ? quality : 0);
+  fix.satellites = (parseScaled(fields[7], 0, &satellites) ? satellites : 0);
+
+  int32_t latitude, longitude, altitude;
+  if(fix.quality > 0 &&
+     parseCoordinate(fields[2], fields[3], &latitude) &&
+     parseCoordinate(fields[4], fields[5], &longitude) &&
+     parseScaled(fields[9], 2, &altitude)) {
+    fix.latitude = latitude;
+    fix.longitude = longitude;
+    fix.altitude = altitude;
+  }
+
+  received |= NMEA_GGA;
+}
+
+}
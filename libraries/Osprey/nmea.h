@@ -0,0 +1,77 @@
+#ifndef NMEA_H
+#define NMEA_H
+
+// NMEA 0183 parser for the RMC and GGA sentences
+//
+// Bytes are fed in one at a time from task context. A sentence is collected
+// into a fixed buffer, its checksum checked and its fields split in place, so
+// nothing is allocated or copied out. Numbers are read as scaled integers
+// rather than through atof, which would be soft float on the SAMD21.
+//
+// The receiver sends an RMC and a GGA sentence for every fix. They're
+// gathered into a back buffer and only published, by swapping it with the
+// front one, once both sentences for the same time have arrived, so a reader
+// never sees the position from one fix with the altitude from another.
+//
+// Nothing here is Arduino specific so it can be run on the host.
+
+#include <stdint.h>
+
+#define NMEA_MAX_SENTENCE 83 // 82 characters and the terminator
+#define NMEA_MAX_FIELDS 20
+
+typedef struct gps_fix_t {
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t second;
+  uint16_t millis;
+  uint8_t day;
+  uint8_t month;
+  uint8_t year;        // since 2000
+  int32_t latitude;    // 1e-7 degrees, north
+  int32_t longitude;   // 1e-7 degrees, east
+  int32_t altitude;    // cm above sea level
+  uint16_t speed;      // 1/100 knot
+  uint8_t quality;     // GGA fix quality, 0 for no fix
+  uint8_t satellites;
+} gps_fix_t;
+
+namespace Osprey {
+
+class NmeaParser {
+  public:
+    NmeaParser();
+
+    // Returns true when the byte completed a fix
+    bool feed(char c);
+
+    // The latest complete fix. Only valid until the next call to feed.
+    const gps_fix_t& getFix() const { return fixes[front]; }
+
+    unsigned long getSentences() const { return sentences; }
+    unsigned long getErrors() const { return errors; }
+    unsigned long getFixes() const { return published; }
+
+  protected:
+    bool parse();
+    void parseRmc(char **fields, int count);
+    void parseGga(char **fields, int count);
+    bool startEpoch(const char *time);
+
+    char sentence[NMEA_MAX_SENTENCE];
+    int length;
+    bool collecting;
+
+    gps_fix_t fixes[2];
+    int front;
+    uint8_t received;  // sentences of the fix being gathered
+    int32_t epochTime; // hhmmss.sss as an integer, -1 for none
+
+    unsigned long sentences;
+    unsigned long errors;
+    unsigned long published;
+};
+
+}
+
+#endif
@@ -0,0 +1,111 @@
+#include "predictor.h"
+#include "integrator.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+ApogeePredictor::ApogeePredictor() : ApogeePredictor(micros) {}
+#endif
+
+ApogeePredictor::ApogeePredictor(predictor_clock_t clock) {
+  this->clock = clock;
+  groundLevel = 0;
+  reset();
+}
+
+void ApogeePredictor::reset() {
+  dragScale = 1;
+  apogee = 0;
+  timeToApogee = 0;
+  steps = 0;
+  duration = 0;
+}
+
+void ApogeePredictor::setGroundLevel(float altitude) {
+  groundLevel = altitude;
+}
+
+void ApogeePredictor::calibrate(float altitude, float velocity, float acceleration, float balCoeff) {
+  if(velocity < PREDICTOR_CALIBRATION_VELOCITY) return;
+
+  // Coasting, a = -rho v^2 balCoeff - g
+  float rho = Exponentially_Decaying_Density_Model((altitude + groundLevel) / 1000.0);
+  float scale = -(acceleration + GRAV) / (rho * velocity * velocity * balCoeff);
+
+  if(scale < PREDICTOR_MIN_DRAG_SCALE) scale = PREDICTOR_MIN_DRAG_SCALE;
+  if(scale > PREDICTOR_MAX_DRAG_SCALE) scale = PREDICTOR_MAX_DRAG_SCALE;
+
+  dragScale += PREDICTOR_CALIBRATION_GAIN * (scale - dragScale);
+}
+
+static float verticalVelocity(StateVector x) {
+  return x.vec.z;
+}
+
+int ApogeePredictor::predict(float altitude, float velocity, float balCoeff) {
+  unsigned long start = clock();
+
+  steps = 0;
+  evaluations = 0;
+  timeToApogee = 0;
+  if(velocity < PREDICTOR_MIN_VELOCITY) {
+    apogee = altitude;
+    duration = clock() - start;
+    return 1;
+  }
+
+  // The model works in altitude above sea level for the air density
+  StateVector x(altitude + groundLevel, Vector3D(0, 0, velocity), balCoeff * dragScale);
+
+  // Time to apogee with quadratic drag in air of constant density, to size
+  // the first step. Without drag it would take v / g, which nothing exceeds.
+  float k = Exponentially_Decaying_Density_Model(x.height / 1000.0) * x.balCoeff;
+  float climb = atan(velocity * sqrt(k / GRAV)) / sqrt(k * GRAV);
+
+  Osprey::DormandPrince<StateVector, StateVector (*)(StateVector, float)> integrator(
+      Truth_gravdiffeq_air_brake, PREDICTOR_RTOL, PREDICTOR_ATOL, climb / PREDICTOR_FIRST_STEPS);
+
+  // A step at a time so the budget is checked between them
+  float t = 0;
+  int result = INTEGRATOR_UNFINISHED;
+  while(result == INTEGRATOR_UNFINISHED && integrator.getSteps() < PREDICTOR_MAX_STEPS &&
+        clock() - start <= PREDICTOR_BUDGET) {
+    result = integrator.integrate(x, t, velocity / GRAV + 1, verticalVelocity, 1);
+  }
+
+  steps = integrator.getSteps();
+  evaluations = integrator.getEvaluations();
+  duration = clock() - start;
+
+  if(result != INTEGRATOR_EVENT) {
+    return 0;
+  }
+
+  apogee = x.height - groundLevel;
+  timeToApogee = t;
+  return 1;
+}
+
+float ApogeePredictor::getApogee() {
+  return apogee;
+}
+
+float ApogeePredictor::getTimeToApogee() {
+  return timeToApogee;
+}
+
+float ApogeePredictor::getDragScale() {
+  return dragScale;
+}
+
+int ApogeePredictor::getSteps() {
+  return steps;
+}
+
+int ApogeePredictor::getEvaluations() {
+  return evaluations;
+}
+
+unsigned long ApogeePredictor::getDuration() {
+  return duration;
+}
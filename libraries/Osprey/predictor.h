@@ -0,0 +1,60 @@
+#ifndef PREDICTOR_H
+#define PREDICTOR_H
+
+// Apogee prediction for the air brakes
+//
+// Integrates the airbrake trajectory model (see airbrake.h) forward from the
+// current altitude and vertical velocity with the adaptive integrator (see
+// integrator.h), stopping exactly where the vertical velocity reaches zero.
+// A time budget stops a prediction that runs long; it is then reported as
+// failed rather than returning a partial answer.
+//
+// The drag model is calibrated in flight: while coasting the measured
+// deceleration gives the actual ballistic coefficient, and the ratio to the
+// nominal one scales every prediction.
+
+#include "airbrake.h"
+
+#define PREDICTOR_RTOL 1e-5f
+#define PREDICTOR_ATOL 1e-3f         // m, m/s
+#define PREDICTOR_FIRST_STEPS 4      // first step is this fraction of the climb
+#define PREDICTOR_MAX_STEPS 32
+#define PREDICTOR_BUDGET 2000UL      // us per prediction
+#define PREDICTOR_MIN_VELOCITY 1.0f  // m/s, slower than this is apogee already
+
+// Calibration only uses samples with enough drag to measure
+#define PREDICTOR_CALIBRATION_VELOCITY 50.0f // m/s
+#define PREDICTOR_CALIBRATION_GAIN 0.05f
+#define PREDICTOR_MIN_DRAG_SCALE 0.5f
+#define PREDICTOR_MAX_DRAG_SCALE 2.0f
+
+typedef unsigned long (*predictor_clock_t)(void);
+
+class ApogeePredictor {
+  public:
+    ApogeePredictor();
+    ApogeePredictor(predictor_clock_t clock);
+    void reset();
+    void setGroundLevel(float altitude);
+    void calibrate(float altitude, float velocity, float acceleration, float balCoeff);
+    int predict(float altitude, float velocity, float balCoeff);
+
+    float getApogee();
+    float getTimeToApogee();
+    float getDragScale();
+    int getSteps();
+    int getEvaluations();
+    unsigned long getDuration();
+
+  protected:
+    predictor_clock_t clock;
+    float groundLevel;  // m above sea level, for the air density
+    float dragScale;
+    float apogee;       // m, same reference as the altitude predicted from
+    float timeToApogee; // s
+    int steps;
+    int evaluations;
+    unsigned long duration; // us the last prediction took
+};
+
+#endif
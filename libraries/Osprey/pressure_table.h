@@ -0,0 +1,542 @@
+#ifndef PRESSURE_TABLE_H
+#define PRESSURE_TABLE_H
+
+// Generated by tools/pressuretable, don't edit by hand.
+//
+// Standard atmosphere altitude for pressures from 2^9 to 2^17 Pa. Band b
+// covers 2^b to 2^(b+1) Pa in 256 equal steps. Linear interpolation is within
+// 0.047 m of the formula between 1 and 110 kPa in metres, and 0.053 m in the
+// centimetres FIXED_POINT_MATH builds use.
+
+#define PRESSURE_TABLE_REFERENCE_PRESSURE 101325.0f
+#define PRESSURE_TABLE_REFERENCE_TEMPERATURE 288.15f
+#define PRESSURE_TABLE_LAPSE_RATE 0.0065f
+#define PRESSURE_TABLE_FIRST_BAND 9
+#define PRESSURE_TABLE_BANDS 8
+#define PRESSURE_TABLE_STEP_BITS 8
+#define PRESSURE_TABLE_ENTRIES 2049
+#define PRESSURE_TABLE_POSITION_BITS 16
+
+#if FIXED_POINT_MATH
+static const int32_t PRESSURE_TABLE[PRESSURE_TABLE_ENTRIES] = {
+  7688001, 7679015, 7670071, 7661167, 7652305, 7643483, 7634702, 7625960,
+  7617258, 7608594, 7599970, 7591384, 7582836, 7574326, 7565854, 7557419,
+  7549021, 7540660, 7532335, 7524046, 7515793, 7507575, 7499393, 7491245,
+  7483133, 7475054, 7467010, 7459000, 7451023, 7443080, 7435170, 7427292,
+  7419448, 7411635, 7403855, 7396107, 7388390, 7380704, 7373050, 7365427,
+  7357834, 7350272, 7342740, 7335238, 7327766, 7320324, 7312910, 7305527,
+  7298171, 7290845, 7283547, 7276278, 7269037, 7261823, 7254638, 7247480,
+  7240349, 7233245, 7226169, 7219119, 7212096, 7205099, 7198128, 7191183,
+  7184265, 7177372, 7170504, 7163662, 7156845, 7150053, 7143285, 7136543,
+  7129825, 7123131, 7116462, 7109816, 7103194, 7096596, 7090022, 7083471,
+  7076943, 7070438, 7063956, 7057497, 7051061, 7044647, 7038256, 7031886,
+  7025539, 7019214, 7012910, 7006628, 7000368, 6994129, 6987911, 6981714,
+  6975538, 6969384, 6963249, 6957136, 6951043, 6944970, 6938917, 6932885,
+  6926872, 6920880, 6914907, 6908954, 6903020, 6897105, 6891210, 6885334,
+  6879477, 6873639, 6867819, 6862019, 6856237, 6850473, 6844728, 6839001,
+  6833292, 6827601, 6821929, 6816274, 6810636, 6805017, 6799415, 6793830,
+  6788262, 6782712, 6777179, 6771663, 6766164, 6760682, 6755217, 6749768,
+  6744336, 6738920, 6733521, 6728138, 6722771, 6717420, 6712085, 6706766,
+  6701463, 6696176, 6690904, 6685648, 6680408, 6675183, 6669973, 6664779,
+  6659599, 6654435, 6649286, 6644152, 6639032, 6633928, 6628838, 6623762,
+  6618701, 6613655, 6608623, 6603605, 6598602, 6593612, 6588637, 6583676,
+  6578729, 6573795, 6568876, 6563970, 6559078, 6554199, 6549334, 6544482,
+  6539644, 6534819, 6530007, 6525209, 6520423, 6515651, 6510892, 6506145,
+  6501411, 6496691, 6491982, 6487287, 6482604, 6477934, 6473276, 6468630,
+  6463997, 6459377, 6454768, 6450172, 6445587, 6441015, 6436455, 6431906,
+  6427370, 6422846, 6418333, 6413832, 6409342, 6404864, 6400398, 6395943,
+  6391500, 6387068, 6382647, 6378238, 6373840, 6369453, 6365077, 6360712,
+  6356358, 6352015, 6347683, 6343362, 6339052, 6334753, 6330464, 6326186,
+  6321918, 6317662, 6313415, 6309179, 6304954, 6300739, 6296534, 6292339,
+  6288155, 6283981, 6279817, 6275663, 6271520, 6267386, 6263262, 6259148,
+  6255044, 6250950, 6246866, 6242791, 6238726, 6234671, 6230626, 6226590,
+  6222563, 6218546, 6214539, 6210541, 6206552, 6202573, 6198602, 6194642,
+  6190690, 6182814, 6174975, 6167172, 6159404, 6151672, 6143975, 6136313,
+  6128686, 6121093, 6113534, 6106008, 6098517, 6091058, 6083632, 6076239,
+  6068879, 6061550, 6054253, 6046989, 6039755, 6032552, 6025381, 6018240,
+  6011129, 6004049, 5996998, 5989978, 5982986, 5976024, 5969091, 5962187,
+  5955311, 5948464, 5941645, 5934853, 5928090, 5921354, 5914645, 5907964,
+  5901309, 5894681, 5888079, 5881504, 5874955, 5868432, 5861935, 5855463,
+  5849016, 5842595, 5836199, 5829827, 5823481, 5817158, 5810860, 5804586,
+  5798336, 5792110, 5785908, 5779729, 5773573, 5767441, 5761331, 5755244,
+  5749180, 5743139, 5737119, 5731122, 5725148, 5719195, 5713263, 5707354,
+  5701465, 5695599, 5689753, 5683928, 5678125, 5672342, 5666579, 5660837,
+  5655116, 5649415, 5643734, 5638073, 5632431, 5626810, 5621208, 5615625,
+  5610062, 5604518, 5598993, 5593487, 5588000, 5582532, 5577082, 5571651,
+  5566238, 5560843, 5555467, 5550109, 5544768, 5539445, 5534141, 5528853,
+  5523584, 5518331, 5513096, 5507878, 5502677, 5497494, 5492327, 5487176,
+  5482043, 5476926, 5471825, 5466741, 5461674, 5456622, 5451586, 5446567,
+  5441563, 5436575, 5431603, 5426647, 5421706, 5416781, 5411870, 5406976,
+  5402096, 5397232, 5392382, 5387547, 5382728, 5377923, 5373132, 5368357,
+  5363596, 5358849, 5354116, 5349398, 5344694, 5340005, 5335329, 5330667,
+  5326019, 5321385, 5316765, 5312158, 5307565, 5302985, 5298419, 5293866,
+  5289327, 5284800, 5280287, 5275787, 5271300, 5266826, 5262365, 5257916,
+  5253481, 5249058, 5244647, 5240249, 5235864, 5231491, 5227130, 5222782,
+  5218446, 5214122, 5209810, 5205510, 5201222, 5196946, 5192682, 5188430,
+  5184189, 5179960, 5175743, 5171537, 5167343, 5163160, 5158989, 5154828,
+  5150680, 5146542, 5142415, 5138300, 5134195, 5130102, 5126020, 5121948,
+  5117887, 5113837, 5109798, 5105769, 5101751, 5097744, 5093747, 5089761,
+  5085785, 5081819, 5077863, 5073918, 5069984, 5066059, 5062144, 5058240,
+  5054345, 5050461, 5046586, 5042721, 5038867, 5035022, 5031186, 5027361,
+  5023545, 5019738, 5015942, 5012154, 5008376, 5004608, 5000849, 4997100,
+  4993359, 4989628, 4985906, 4982194, 4978490, 4974796, 4971110, 4967434,
+  4963767, 4960108, 4956459, 4952818, 4949186, 4945563, 4941949, 4938343,
+  4934746, 4931158, 4927578, 4924007, 4920444, 4916890, 4913344, 4909806,
+  4906277, 4902757, 4899244, 4895740, 4892244, 4888756, 4885276, 4881805,
+  4878341, 4871438, 4864568, 4857728, 4850920, 4844143, 4837397, 4830682,
+  4823997, 4817341, 4810716, 4804120, 4797554, 4791017, 4784508, 4778029,
+  4771577, 4765154, 4758759, 4752391, 4746051, 4739738, 4733453, 4727194,
+  4720962, 4714756, 4708576, 4702423, 4696295, 4690193, 4684117, 4678065,
+  4672039, 4666037, 4660061, 4654108, 4648180, 4642276, 4636396, 4630540,
+  4624707, 4618898, 4613112, 4607349, 4601609, 4595892, 4590197, 4584525,
+  4578874, 4573246, 4567640, 4562056, 4556493, 4550952, 4545432, 4539933,
+  4534455, 4528998, 4523562, 4518146, 4512751, 4507376, 4502021, 4496686,
+  4491371, 4486076, 4480800, 4475544, 4470307, 4465089, 4459891, 4454711,
+  4449550, 4444408, 4439285, 4434180, 4429093, 4424024, 4418974, 4413941,
+  4408927, 4403930, 4398950, 4393988, 4389044, 4384117, 4379207, 4374314,
+  4369438, 4364579, 4359736, 4354911, 4350101, 4345308, 4340532, 4335772,
+  4331027, 4326299, 4321587, 4316891, 4312210, 4307545, 4302895, 4298261,
+  4293642, 4289039, 4284450, 4279877, 4275319, 4270775, 4266246, 4261732,
+  4257233, 4252748, 4248278, 4243822, 4239380, 4234952, 4230539, 4226139,
+  4221754, 4217382, 4213024, 4208680, 4204350, 4200033, 4195729, 4191439,
+  4187162, 4182898, 4178648, 4174411, 4170186, 4165975, 4161776, 4157591,
+  4153418, 4149257, 4145109, 4140974, 4136851, 4132741, 4128643, 4124557,
+  4120483, 4116421, 4112372, 4108334, 4104308, 4100294, 4096292, 4092302,
+  4088323, 4084356, 4080400, 4076456, 4072523, 4068602, 4064692, 4060793,
+  4056905, 4053028, 4049163, 4045308, 4041465, 4037632, 4033810, 4029999,
+  4026198, 4022408, 4018629, 4014860, 4011102, 4007354, 4003617, 3999890,
+  3996173, 3992467, 3988770, 3985084, 3981408, 3977742, 3974086, 3970439,
+  3966803, 3963176, 3959560, 3955952, 3952355, 3948767, 3945189, 3941621,
+  3938061, 3934512, 3930971, 3927440, 3923919, 3920406, 3916903, 3913409,
+  3909924, 3906449, 3902982, 3899524, 3896075, 3892635, 3889204, 3885782,
+  3882369, 3878964, 3875568, 3872181, 3868802, 3865432, 3862071, 3858718,
+  3855373, 3852037, 3848709, 3845390, 3842078, 3838776, 3835481, 3832195,
+  3828916, 3825646, 3822384, 3819130, 3815884, 3812646, 3809416, 3806194,
+  3802979, 3799773, 3796574, 3793383, 3790200, 3787024, 3783857, 3780696,
+  3777544, 3774399, 3771261, 3768131, 3765008, 3761893, 3758785, 3755685,
+  3752592, 3749506, 3746427, 3743356, 3740292, 3737235, 3734185, 3731142,
+  3728107, 3722056, 3716034, 3710040, 3704073, 3698133, 3692220, 3686334,
+  3680475, 3674642, 3668835, 3663054, 3657299, 3651569, 3645865, 3640185,
+  3634531, 3628901, 3623296, 3617715, 3612158, 3606625, 3601116, 3595630,
+  3590168, 3584729, 3579313, 3573919, 3568548, 3563200, 3557874, 3552570,
+  3547288, 3542028, 3536790, 3531573, 3526377, 3521202, 3516049, 3510916,
+  3505804, 3500712, 3495641, 3490590, 3485559, 3480548, 3475556, 3470585,
+  3465633, 3460700, 3455786, 3450892, 3446016, 3441159, 3436321, 3431502,
+  3426700, 3421917, 3417153, 3412406, 3407677, 3402966, 3398273, 3393597,
+  3388939, 3384297, 3379673, 3375067, 3370477, 3365903, 3361347, 3356807,
+  3352284, 3347777, 3343286, 3338812, 3334353, 3329911, 3325484, 3321074,
+  3316678, 3312299, 3307934, 3303585, 3299252, 3294933, 3290630, 3286341,
+  3282068, 3277809, 3273565, 3269335, 3265120, 3260919, 3256732, 3252560,
+  3248402, 3244258, 3240128, 3236011, 3231909, 3227820, 3223745, 3219683,
+  3215635, 3211600, 3207579, 3203570, 3199575, 3195593, 3191623, 3187667,
+  3183723, 3179793, 3175874, 3171969, 3168076, 3164195, 3160327, 3156471,
+  3152627, 3148795, 3144976, 3141168, 3137373, 3133589, 3129817, 3126057,
+  3122308, 3118571, 3114846, 3111132, 3107429, 3103738, 3100058, 3096390,
+  3092732, 3089086, 3085450, 3081826, 3078212, 3074610, 3071018, 3067436,
+  3063866, 3060306, 3056757, 3053218, 3049689, 3046171, 3042663, 3039166,
+  3035679, 3032202, 3028735, 3025278, 3021831, 3018394, 3014967, 3011549,
+  3008142, 3004744, 3001356, 2997978, 2994609, 2991249, 2987900, 2984559,
+  2981228, 2977906, 2974594, 2971291, 2967997, 2964712, 2961436, 2958170,
+  2954912, 2951663, 2948424, 2945193, 2941971, 2938758, 2935553, 2932357,
+  2929170, 2925991, 2922821, 2919660, 2916507, 2913362, 2910226, 2907098,
+  2903979, 2900868, 2897765, 2894670, 2891583, 2888505, 2885434, 2882372,
+  2879318, 2876271, 2873233, 2870202, 2867179, 2864164, 2861157, 2858158,
+  2855166, 2852182, 2849205, 2846237, 2843275, 2840321, 2837375, 2834436,
+  2831505, 2828581, 2825664, 2822755, 2819853, 2816958, 2814070, 2811190,
+  2808316, 2805450, 2802591, 2799739, 2796894, 2794056, 2791225, 2788401,
+  2785583, 2782773, 2779969, 2777173, 2774383, 2771599, 2768823, 2766053,
+  2763290, 2760533, 2757783, 2755040, 2752303, 2749572, 2746849, 2744131,
+  2741420, 2738715, 2736017, 2733325, 2730640, 2727960, 2725287, 2722620,
+  2719960, 2714657, 2709379, 2704125, 2698895, 2693689, 2688506, 2683347,
+  2678212, 2673099, 2668010, 2662943, 2657899, 2652877, 2647877, 2642899,
+  2637943, 2633009, 2628096, 2623205, 2618334, 2613485, 2608656, 2603848,
+  2599060, 2594293, 2589546, 2584819, 2580112, 2575424, 2570756, 2566107,
+  2561478, 2556868, 2552276, 2547704, 2543150, 2538614, 2534097, 2529598,
+  2525118, 2520655, 2516210, 2511783, 2507374, 2502982, 2498607, 2494249,
+  2489909, 2485585, 2481279, 2476989, 2472716, 2468459, 2464218, 2459994,
+  2455786, 2451594, 2447418, 2443257, 2439113, 2434984, 2430870, 2426772,
+  2422689, 2418621, 2414568, 2410530, 2406508, 2402499, 2398506, 2394527,
+  2390562, 2386612, 2382676, 2378754, 2374847, 2370953, 2367073, 2363207,
+  2359355, 2355516, 2351691, 2347879, 2344081, 2340296, 2336524, 2332765,
+  2329020, 2325287, 2321567, 2317860, 2314165, 2310483, 2306814, 2303157,
+  2299513, 2295881, 2292261, 2288653, 2285057, 2281473, 2277902, 2274342,
+  2270793, 2267257, 2263732, 2260219, 2256717, 2253227, 2249748, 2246280,
+  2242824, 2239379, 2235944, 2232521, 2229109, 2225708, 2222317, 2218938,
+  2215569, 2212210, 2208863, 2205526, 2202199, 2198882, 2195576, 2192281,
+  2188995, 2185720, 2182455, 2179200, 2175954, 2172719, 2169494, 2166278,
+  2163073, 2159877, 2156690, 2153514, 2150346, 2147189, 2144041, 2140902,
+  2137772, 2134652, 2131541, 2128439, 2125347, 2122263, 2119189, 2116124,
+  2113067, 2110020, 2106981, 2103951, 2100930, 2097917, 2094914, 2091918,
+  2088932, 2085954, 2082984, 2080023, 2077070, 2074126, 2071190, 2068262,
+  2065343, 2062431, 2059528, 2056633, 2053746, 2050867, 2047996, 2045133,
+  2042278, 2039430, 2036591, 2033759, 2030935, 2028118, 2025310, 2022509,
+  2019715, 2016929, 2014151, 2011380, 2008616, 2005860, 2003112, 2000370,
+  1997636, 1994909, 1992189, 1989477, 1986772, 1984073, 1981382, 1978698,
+  1976021, 1973351, 1970688, 1968032, 1965382, 1962740, 1960104, 1957475,
+  1954853, 1952237, 1949629, 1947027, 1944431, 1941842, 1939260, 1936684,
+  1934115, 1931552, 1928995, 1926446, 1923902, 1921365, 1918834, 1916309,
+  1913791, 1911279, 1908773, 1906273, 1903779, 1901292, 1898811, 1896335,
+  1893866, 1891403, 1888945, 1886494, 1884049, 1881609, 1879176, 1876748,
+  1874326, 1871910, 1869500, 1867095, 1864696, 1862303, 1859916, 1857534,
+  1855158, 1852787, 1850423, 1848063, 1845709, 1843361, 1841018, 1838681,
+  1836349, 1831701, 1827075, 1822470, 1817886, 1813323, 1808781, 1804259,
+  1799758, 1795277, 1790816, 1786375, 1781954, 1777553, 1773170, 1768808,
+  1764464, 1760139, 1755833, 1751546, 1747277, 1743027, 1738794, 1734580,
+  1730384, 1726206, 1722045, 1717902, 1713776, 1709667, 1705576, 1701502,
+  1697444, 1693403, 1689379, 1685371, 1681380, 1677405, 1673446, 1669503,
+  1665575, 1661664, 1657768, 1653888, 1650023, 1646174, 1642339, 1638520,
+  1634716, 1630927, 1627152, 1623392, 1619647, 1615916, 1612199, 1608496,
+  1604808, 1601134, 1597474, 1593827, 1590195, 1586576, 1582970, 1579378,
+  1575800, 1572234, 1568682, 1565143, 1561617, 1558104, 1554604, 1551116,
+  1547641, 1544179, 1540730, 1537292, 1533867, 1530455, 1527054, 1523666,
+  1520289, 1516925, 1513572, 1510231, 1506902, 1503585, 1500279, 1496984,
+  1493701, 1490430, 1487169, 1483920, 1480682, 1477455, 1474239, 1471034,
+  1467839, 1464656, 1461483, 1458321, 1455169, 1452028, 1448898, 1445778,
+  1442668, 1439568, 1436479, 1433399, 1430330, 1427271, 1424222, 1421183,
+  1418153, 1415134, 1412124, 1409123, 1406133, 1403151, 1400180, 1397218,
+  1394265, 1391321, 1388387, 1385462, 1382547, 1379640, 1376742, 1373854,
+  1370974, 1368103, 1365241, 1362388, 1359544, 1356709, 1353882, 1351063,
+  1348254, 1345452, 1342660, 1339875, 1337099, 1334332, 1331573, 1328821,
+  1326079, 1323344, 1320617, 1317899, 1315188, 1312486, 1309791, 1307104,
+  1304425, 1301754, 1299091, 1296435, 1293787, 1291147, 1288514, 1285889,
+  1283271, 1280661, 1278058, 1275463, 1272875, 1270295, 1267721, 1265155,
+  1262596, 1260045, 1257500, 1254962, 1252432, 1249909, 1247392, 1244883,
+  1242380, 1239885, 1237396, 1234914, 1232439, 1229970, 1227509, 1225053,
+  1222605, 1220163, 1217728, 1215299, 1212877, 1210462, 1208052, 1205650,
+  1203253, 1200863, 1198480, 1196102, 1193731, 1191366, 1189007, 1186655,
+  1184308, 1181968, 1179634, 1177306, 1174984, 1172668, 1170358, 1168053,
+  1165755, 1163463, 1161176, 1158896, 1156621, 1154352, 1152088, 1149831,
+  1147579, 1145332, 1143092, 1140857, 1138627, 1136404, 1134185, 1131973,
+  1129765, 1127564, 1125367, 1123176, 1120991, 1118810, 1116636, 1114466,
+  1112302, 1110143, 1107989, 1105841, 1103697, 1101559, 1099426, 1097299,
+  1095176, 1093058, 1090946, 1088838, 1086736, 1084638, 1082546, 1080458,
+  1078376, 1076298, 1074225, 1072157, 1070094, 1068036, 1065982, 1063934,
+  1061890, 1057816, 1053761, 1049725, 1045707, 1041708, 1037727, 1033764,
+  1029819, 1025892, 1021982, 1018089, 1014214, 1010357, 1006516, 1002692,
+  998885, 995094, 991320, 987562, 983821, 980096, 976386, 972693,
+  969015, 965353, 961706, 958074, 954458, 950857, 947271, 943700,
+  940144, 936602, 933075, 929562, 926064, 922580, 919110, 915654,
+  912212, 908784, 905369, 901968, 898581, 895207, 891846, 888499,
+  885165, 881843, 878535, 875239, 871957, 868687, 865429, 862184,
+  858951, 855731, 852523, 849327, 846143, 842971, 839811, 836663,
+  833526, 830401, 827288, 824186, 821096, 818016, 814949, 811892,
+  808846, 805812, 802788, 799776, 796774, 793783, 790802, 787832,
+  784873, 781924, 778986, 776057, 773140, 770232, 767334, 764447,
+  761569, 758702, 755844, 752996, 750158, 747330, 744511, 741702,
+  738902, 736112, 733331, 730559, 727797, 725044, 722300, 719566,
+  716840, 714123, 711415, 708717, 706027, 703345, 700673, 698009,
+  695354, 692707, 690069, 687439, 684818, 682205, 679601, 677004,
+  674416, 671836, 669265, 666701, 664145, 661598, 659058, 656526,
+  654003, 651486, 648978, 646477, 643985, 641499, 639022, 636551,
+  634089, 631634, 629186, 626745, 624312, 621887, 619468, 617057,
+  614653, 612256, 609866, 607484, 605108, 602739, 600377, 598022,
+  595674, 593333, 590999, 588671, 586350, 584036, 581729, 579428,
+  577134, 574846, 572565, 570290, 568022, 565760, 563504, 561255,
+  559013, 556776, 554546, 552322, 550104, 547892, 545687, 543487,
+  541294, 539107, 536925, 534750, 532580, 530417, 528259, 526107,
+  523962, 521821, 519687, 517558, 515435, 513318, 511207, 509101,
+  507000, 504905, 502816, 500732, 498654, 496581, 494514, 492452,
+  490396, 488344, 486299, 484258, 482223, 480193, 478168, 476149,
+  474134, 472125, 470121, 468122, 466128, 464139, 462156, 460177,
+  458203, 456234, 454271, 452312, 450358, 448409, 446464, 444525,
+  442590, 440660, 438735, 436815, 434899, 432989, 431082, 429181,
+  427284, 425392, 423504, 421621, 419742, 417868, 415999, 414134,
+  412274, 410418, 408566, 406719, 404876, 403038, 401204, 399374,
+  397549, 395727, 393911, 392098, 390290, 388486, 386686, 384891,
+  383099, 379529, 375975, 372437, 368916, 365411, 361921, 358448,
+  354990, 351548, 348121, 344710, 341313, 337932, 334566, 331214,
+  327877, 324555, 321247, 317954, 314674, 311409, 308158, 304921,
+  301697, 298487, 295291, 292108, 288939, 285783, 282640, 279510,
+  276393, 273288, 270197, 267118, 264052, 260998, 257957, 254928,
+  251911, 248906, 245914, 242933, 239964, 237007, 234061, 231127,
+  228205, 225294, 222394, 219506, 216628, 213762, 210907, 208063,
+  205230, 202407, 199595, 196794, 194004, 191223, 188454, 185694,
+  182945, 180206, 177478, 174759, 172050, 169351, 166663, 163984,
+  161314, 158654, 156004, 153364, 150733, 148111, 145499, 142896,
+  140302, 137718, 135142, 132576, 130018, 127470, 124930, 122399,
+  119877, 117364, 114859, 112363, 109876, 107397, 104926, 102464,
+  100010, 97565, 95127, 92698, 90277, 87864, 85459, 83062,
+  80673, 78292, 75919, 73553, 71196, 68846, 66503, 64168,
+  61841, 59521, 57209, 54904, 52607, 50317, 48034, 45759,
+  43490, 41229, 38975, 36728, 34488, 32255, 30029, 27810,
+  25598, 23393, 21194, 19003, 16818, 14639, 12468, 10303,
+  8144, 5992, 3847, 1708, -424, -2550, -4670, -6783,
+  -8891, -10991, -13086, -15174, -17257, -19333, -21403, -23467,
+  -25525, -27577, -29623, -31663, -33697, -35725, -37748, -39764,
+  -41775, -43780, -45780, -47773, -49761, -51744, -53721, -55692,
+  -57658, -59618, -61573, -63522, -65466, -67404, -69337, -71265,
+  -73188, -75105, -77017, -78923, -80825, -82721, -84612, -86498,
+  -88379, -90255, -92125, -93991, -95852, -97708, -99558, -101404,
+  -103245, -105081, -106912, -108739, -110560, -112377, -114189, -115996,
+  -117798, -119596, -121389, -123178, -124962, -126741, -128516, -130286,
+  -132051, -133812, -135569, -137321, -139068, -140811, -142550, -144284,
+  -146014, -147740, -149461, -151178, -152891, -154599, -156303, -158003,
+  -159699, -161390, -163077, -164760, -166439, -168114, -169785, -171451,
+  -173114, -174772, -176427, -178077, -179724, -181366, -183005, -184640,
+  -186270, -187897, -189520, -191139, -192754, -194365, -195973, -197576,
+  -199176, -200772, -202365, -203953, -205538, -207119, -208697, -210271,
+  -211841
+};
+#else
+static const float PRESSURE_TABLE[PRESSURE_TABLE_ENTRIES] = {
+  76880.008f, 76790.148f, 76700.703f, 76611.672f, 76523.055f, 76434.836f, 76347.016f, 76259.602f,
+  76172.578f, 76085.945f, 75999.703f, 75913.844f, 75828.359f, 75743.266f, 75658.539f, 75574.195f,
+  75490.211f, 75406.602f, 75323.352f, 75240.461f, 75157.930f, 75075.750f, 74993.930f, 74912.453f,
+  74831.328f, 74750.547f, 74670.102f, 74590.000f, 74510.234f, 74430.797f, 74351.695f, 74272.922f,
+  74194.477f, 74116.352f, 74038.547f, 73961.062f, 73883.898f, 73807.047f, 73730.500f, 73654.266f,
+  73578.344f, 73502.719f, 73427.398f, 73352.383f, 73277.664f, 73203.234f, 73129.102f, 73055.266f,
+  72981.719f, 72908.453f, 72835.477f, 72762.781f, 72690.367f, 72618.234f, 72546.375f, 72474.797f,
+  72403.492f, 72332.453f, 72261.688f, 72191.188f, 72120.953f, 72050.984f, 71981.281f, 71911.836f,
+  71842.648f, 71773.719f, 71705.039f, 71636.617f, 71568.445f, 71500.523f, 71432.852f, 71365.430f,
+  71298.250f, 71231.312f, 71164.617f, 71098.164f, 71031.945f, 70965.961f, 70900.219f, 70834.711f,
+  70769.430f, 70704.383f, 70639.562f, 70574.977f, 70510.609f, 70446.469f, 70382.555f, 70318.859f,
+  70255.391f, 70192.133f, 70129.102f, 70066.281f, 70003.680f, 69941.289f, 69879.109f, 69817.141f,
+  69755.383f, 69693.836f, 69632.492f, 69571.359f, 69510.430f, 69449.695f, 69389.172f, 69328.852f,
+  69268.727f, 69208.797f, 69149.070f, 69089.539f, 69030.195f, 68971.055f, 68912.102f, 68853.336f,
+  68794.766f, 68736.391f, 68678.195f, 68620.188f, 68562.367f, 68504.734f, 68447.281f, 68390.008f,
+  68332.922f, 68276.016f, 68219.289f, 68162.734f, 68106.359f, 68050.164f, 67994.148f, 67938.297f,
+  67882.625f, 67827.125f, 67771.797f, 67716.633f, 67661.641f, 67606.820f, 67552.164f, 67497.680f,
+  67443.359f, 67389.203f, 67335.203f, 67281.375f, 67227.703f, 67174.195f, 67120.852f, 67067.664f,
+  67014.633f, 66961.758f, 66909.047f, 66856.484f, 66804.078f, 66751.828f, 66699.734f, 66647.789f,
+  66595.992f, 66544.352f, 66492.859f, 66441.516f, 66390.320f, 66339.273f, 66288.375f, 66237.625f,
+  66187.016f, 66136.547f, 66086.227f, 66036.055f, 65986.016f, 65936.125f, 65886.375f, 65836.758f,
+  65787.289f, 65737.953f, 65688.758f, 65639.703f, 65590.773f, 65541.992f, 65493.340f, 65444.824f,
+  65396.441f, 65348.191f, 65300.074f, 65252.086f, 65204.234f, 65156.508f, 65108.914f, 65061.449f,
+  65014.113f, 64966.906f, 64919.824f, 64872.871f, 64826.039f, 64779.336f, 64732.758f, 64686.305f,
+  64639.973f, 64593.766f, 64547.680f, 64501.715f, 64455.871f, 64410.148f, 64364.547f, 64319.066f,
+  64273.699f, 64228.453f, 64183.328f, 64138.316f, 64093.422f, 64048.645f, 64003.980f, 63959.434f,
+  63915.000f, 63870.680f, 63826.473f, 63782.379f, 63738.395f, 63694.527f, 63650.770f, 63607.121f,
+  63563.582f, 63520.152f, 63476.836f, 63433.625f, 63390.523f, 63347.527f, 63304.641f, 63261.859f,
+  63219.184f, 63176.617f, 63134.152f, 63091.793f, 63049.539f, 63007.387f, 62965.340f, 62923.395f,
+  62881.551f, 62839.812f, 62798.172f, 62756.633f, 62715.195f, 62673.859f, 62632.621f, 62591.484f,
+  62550.445f, 62509.504f, 62468.660f, 62427.914f, 62387.266f, 62346.711f, 62306.258f, 62265.898f,
+  62225.633f, 62185.461f, 62145.387f, 62105.406f, 62065.520f, 62025.727f, 61986.023f, 61946.414f,
+  61906.898f, 61828.141f, 61749.750f, 61671.715f, 61594.039f, 61516.719f, 61439.750f, 61363.133f,
+  61286.859f, 61210.926f, 61135.336f, 61060.082f, 60985.164f, 60910.578f, 60836.324f, 60762.391f,
+  60688.785f, 60615.500f, 60542.535f, 60469.887f, 60397.551f, 60325.523f, 60253.809f, 60182.398f,
+  60111.293f, 60040.488f, 59969.984f, 59899.777f, 59829.863f, 59760.242f, 59690.910f, 59621.871f,
+  59553.113f, 59484.641f, 59416.445f, 59348.535f, 59280.898f, 59213.539f, 59146.453f, 59079.637f,
+  59013.090f, 58946.809f, 58880.793f, 58815.043f, 58749.551f, 58684.320f, 58619.344f, 58554.629f,
+  58490.164f, 58425.949f, 58361.988f, 58298.273f, 58234.805f, 58171.582f, 58108.602f, 58045.863f,
+  57983.363f, 57921.105f, 57859.078f, 57797.289f, 57735.730f, 57674.406f, 57613.312f, 57552.441f,
+  57491.801f, 57431.387f, 57371.195f, 57311.227f, 57251.477f, 57191.945f, 57132.633f, 57073.535f,
+  57014.652f, 56955.984f, 56897.527f, 56839.281f, 56781.246f, 56723.414f, 56665.793f, 56608.375f,
+  56551.160f, 56494.148f, 56437.336f, 56380.727f, 56324.312f, 56268.098f, 56212.074f, 56156.250f,
+  56100.617f, 56045.180f, 55989.930f, 55934.871f, 55880.000f, 55825.316f, 55770.820f, 55716.508f,
+  55662.379f, 55608.434f, 55554.668f, 55501.086f, 55447.680f, 55394.453f, 55341.406f, 55288.535f,
+  55235.836f, 55183.312f, 55130.961f, 55078.781f, 55026.773f, 54974.934f, 54923.266f, 54871.762f,
+  54820.430f, 54769.258f, 54718.254f, 54667.414f, 54616.734f, 54566.219f, 54515.863f, 54465.668f,
+  54415.633f, 54365.754f, 54316.035f, 54266.469f, 54217.059f, 54167.805f, 54118.703f, 54069.758f,
+  54020.961f, 53972.316f, 53923.820f, 53875.473f, 53827.277f, 53779.227f, 53731.324f, 53683.566f,
+  53635.957f, 53588.488f, 53541.164f, 53493.984f, 53446.945f, 53400.047f, 53353.289f, 53306.672f,
+  53260.191f, 53213.852f, 53167.645f, 53121.578f, 53075.648f, 53029.852f, 52984.191f, 52938.660f,
+  52893.266f, 52848.004f, 52802.871f, 52757.871f, 52713.000f, 52668.262f, 52623.648f, 52579.164f,
+  52534.809f, 52490.578f, 52446.473f, 52402.496f, 52358.641f, 52314.910f, 52271.305f, 52227.820f,
+  52184.461f, 52141.219f, 52098.102f, 52055.102f, 52012.223f, 51969.465f, 51926.824f, 51884.301f,
+  51841.895f, 51799.605f, 51757.430f, 51715.371f, 51673.430f, 51631.602f, 51589.887f, 51548.285f,
+  51506.797f, 51465.418f, 51424.152f, 51383.000f, 51341.953f, 51301.020f, 51260.195f, 51219.480f,
+  51178.871f, 51138.371f, 51097.980f, 51057.691f, 51017.512f, 50977.438f, 50937.469f, 50897.605f,
+  50857.844f, 50818.188f, 50778.637f, 50739.184f, 50699.836f, 50660.590f, 50621.441f, 50582.398f,
+  50543.453f, 50504.609f, 50465.863f, 50427.215f, 50388.668f, 50350.215f, 50311.863f, 50273.605f,
+  50235.445f, 50197.383f, 50159.414f, 50121.543f, 50083.766f, 50046.082f, 50008.492f, 49970.996f,
+  49933.594f, 49896.281f, 49859.062f, 49821.938f, 49784.902f, 49747.957f, 49711.105f, 49674.340f,
+  49637.668f, 49601.082f, 49564.590f, 49528.180f, 49491.863f, 49455.633f, 49419.488f, 49383.430f,
+  49347.461f, 49311.578f, 49275.781f, 49240.066f, 49204.441f, 49168.898f, 49133.438f, 49098.062f,
+  49062.773f, 49027.566f, 48992.441f, 48957.398f, 48922.438f, 48887.562f, 48852.766f, 48818.047f,
+  48783.414f, 48714.387f, 48645.676f, 48577.281f, 48509.203f, 48441.434f, 48373.973f, 48306.816f,
+  48239.965f, 48173.414f, 48107.160f, 48041.203f, 47975.539f, 47910.168f, 47845.086f, 47780.285f,
+  47715.773f, 47651.539f, 47587.590f, 47523.914f, 47460.512f, 47397.383f, 47334.527f, 47271.938f,
+  47209.617f, 47147.559f, 47085.766f, 47024.230f, 46962.953f, 46901.934f, 46841.164f, 46780.652f,
+  46720.387f, 46660.375f, 46600.605f, 46541.082f, 46481.801f, 46422.762f, 46363.961f, 46305.398f,
+  46247.074f, 46188.980f, 46131.121f, 46073.492f, 46016.090f, 45958.918f, 45901.969f, 45845.246f,
+  45788.746f, 45732.465f, 45676.402f, 45620.559f, 45564.930f, 45509.520f, 45454.316f, 45399.328f,
+  45344.551f, 45289.980f, 45235.617f, 45181.461f, 45127.508f, 45073.758f, 45020.211f, 44966.859f,
+  44913.711f, 44860.758f, 44808.004f, 44755.441f, 44703.070f, 44650.895f, 44598.910f, 44547.113f,
+  44495.504f, 44444.082f, 44392.848f, 44341.797f, 44290.930f, 44240.242f, 44189.738f, 44139.414f,
+  44089.266f, 44039.297f, 43989.504f, 43939.883f, 43890.441f, 43841.168f, 43792.070f, 43743.141f,
+  43694.379f, 43645.789f, 43597.363f, 43549.105f, 43501.012f, 43453.086f, 43405.320f, 43357.715f,
+  43310.273f, 43262.992f, 43215.871f, 43168.906f, 43122.098f, 43075.449f, 43028.953f, 42982.609f,
+  42936.422f, 42890.387f, 42844.504f, 42798.770f, 42753.188f, 42707.750f, 42662.465f, 42617.324f,
+  42572.332f, 42527.480f, 42482.777f, 42438.219f, 42393.801f, 42349.523f, 42305.391f, 42261.395f,
+  42217.539f, 42173.824f, 42130.242f, 42086.801f, 42043.496f, 42000.324f, 41957.289f, 41914.391f,
+  41871.621f, 41828.984f, 41786.480f, 41744.105f, 41701.863f, 41659.750f, 41617.762f, 41575.906f,
+  41534.176f, 41492.570f, 41451.094f, 41409.742f, 41368.512f, 41327.406f, 41286.426f, 41245.566f,
+  41204.828f, 41164.211f, 41123.715f, 41083.340f, 41043.082f, 41002.941f, 40962.922f, 40923.016f,
+  40883.230f, 40843.559f, 40804.004f, 40764.559f, 40725.234f, 40686.020f, 40646.918f, 40607.930f,
+  40569.051f, 40530.285f, 40491.629f, 40453.082f, 40414.645f, 40376.316f, 40338.098f, 40299.988f,
+  40261.980f, 40224.082f, 40186.289f, 40148.605f, 40111.023f, 40073.543f, 40036.172f, 39998.898f,
+  39961.730f, 39924.668f, 39887.703f, 39850.840f, 39814.078f, 39777.418f, 39740.855f, 39704.395f,
+  39668.027f, 39631.762f, 39595.594f, 39559.523f, 39523.551f, 39487.672f, 39451.891f, 39416.207f,
+  39380.613f, 39345.117f, 39309.715f, 39274.402f, 39239.188f, 39204.062f, 39169.031f, 39134.094f,
+  39099.242f, 39064.484f, 39029.816f, 38995.242f, 38960.754f, 38926.352f, 38892.043f, 38857.820f,
+  38823.688f, 38789.641f, 38755.680f, 38721.809f, 38688.023f, 38654.320f, 38620.707f, 38587.176f,
+  38553.730f, 38520.367f, 38487.090f, 38453.895f, 38420.785f, 38387.758f, 38354.809f, 38321.945f,
+  38289.164f, 38256.461f, 38223.840f, 38191.301f, 38158.840f, 38126.461f, 38094.160f, 38061.938f,
+  38029.793f, 37997.730f, 37965.742f, 37933.832f, 37902.000f, 37870.246f, 37838.566f, 37806.965f,
+  37775.438f, 37743.984f, 37712.609f, 37681.309f, 37650.082f, 37618.930f, 37587.852f, 37556.848f,
+  37525.914f, 37495.059f, 37464.273f, 37433.559f, 37402.918f, 37372.348f, 37341.848f, 37311.422f,
+  37281.066f, 37220.562f, 37160.340f, 37100.395f, 37040.727f, 36981.328f, 36922.203f, 36863.344f,
+  36804.750f, 36746.418f, 36688.352f, 36630.539f, 36572.988f, 36515.691f, 36458.648f, 36401.855f,
+  36345.309f, 36289.012f, 36232.961f, 36177.148f, 36121.582f, 36066.250f, 36011.160f, 35956.301f,
+  35901.680f, 35847.289f, 35793.125f, 35739.191f, 35685.484f, 35632.004f, 35578.742f, 35525.703f,
+  35472.883f, 35420.285f, 35367.898f, 35315.727f, 35263.770f, 35212.023f, 35160.488f, 35109.160f,
+  35058.039f, 35007.121f, 34956.410f, 34905.898f, 34855.590f, 34805.477f, 34755.562f, 34705.848f,
+  34656.324f, 34606.996f, 34557.863f, 34508.918f, 34460.160f, 34411.594f, 34363.211f, 34315.016f,
+  34267.004f, 34219.176f, 34171.527f, 34124.059f, 34076.773f, 34029.660f, 33982.727f, 33935.969f,
+  33889.387f, 33842.973f, 33796.734f, 33750.664f, 33704.766f, 33659.035f, 33613.469f, 33568.074f,
+  33522.840f, 33477.770f, 33432.863f, 33388.117f, 33343.535f, 33299.109f, 33254.844f, 33210.734f,
+  33166.781f, 33122.984f, 33079.344f, 33035.855f, 32992.520f, 32949.332f, 32906.297f, 32863.414f,
+  32820.676f, 32778.086f, 32735.645f, 32693.350f, 32651.197f, 32609.189f, 32567.324f, 32525.602f,
+  32484.021f, 32442.580f, 32401.277f, 32360.115f, 32319.090f, 32278.201f, 32237.449f, 32196.832f,
+  32156.350f, 32116.002f, 32075.785f, 32035.701f, 31995.748f, 31955.926f, 31916.234f, 31876.670f,
+  31837.234f, 31797.926f, 31758.744f, 31719.688f, 31680.758f, 31641.951f, 31603.268f, 31564.707f,
+  31526.270f, 31487.953f, 31449.758f, 31411.682f, 31373.727f, 31335.889f, 31298.170f, 31260.568f,
+  31223.082f, 31185.713f, 31148.459f, 31111.320f, 31074.295f, 31037.383f, 31000.584f, 30963.896f,
+  30927.322f, 30890.857f, 30854.502f, 30818.258f, 30782.123f, 30746.096f, 30710.176f, 30674.363f,
+  30638.658f, 30603.061f, 30567.566f, 30532.178f, 30496.893f, 30461.713f, 30426.635f, 30391.660f,
+  30356.787f, 30322.016f, 30287.346f, 30252.777f, 30218.307f, 30183.938f, 30149.666f, 30115.494f,
+  30081.418f, 30047.441f, 30013.561f, 29979.775f, 29946.088f, 29912.494f, 29878.996f, 29845.592f,
+  29812.281f, 29779.064f, 29745.941f, 29712.910f, 29679.971f, 29647.121f, 29614.365f, 29581.697f,
+  29549.121f, 29516.635f, 29484.236f, 29451.928f, 29419.707f, 29387.574f, 29355.529f, 29323.570f,
+  29291.699f, 29259.914f, 29228.213f, 29196.598f, 29165.068f, 29133.623f, 29102.262f, 29070.982f,
+  29039.789f, 29008.676f, 28977.646f, 28946.699f, 28915.832f, 28885.047f, 28854.344f, 28823.719f,
+  28793.176f, 28762.711f, 28732.326f, 28702.020f, 28671.793f, 28641.643f, 28611.570f, 28581.576f,
+  28551.658f, 28521.818f, 28492.055f, 28462.365f, 28432.752f, 28403.215f, 28373.752f, 28344.363f,
+  28315.049f, 28285.809f, 28256.641f, 28227.547f, 28198.527f, 28169.578f, 28140.701f, 28111.896f,
+  28083.164f, 28054.502f, 28025.912f, 27997.391f, 27968.939f, 27940.561f, 27912.248f, 27884.008f,
+  27855.834f, 27827.730f, 27799.695f, 27771.727f, 27743.826f, 27715.994f, 27688.229f, 27660.529f,
+  27632.898f, 27605.332f, 27577.832f, 27550.398f, 27523.029f, 27495.725f, 27468.486f, 27441.311f,
+  27414.201f, 27387.154f, 27360.172f, 27333.252f, 27306.395f, 27279.602f, 27252.871f, 27226.203f,
+  27199.596f, 27146.568f, 27093.785f, 27041.246f, 26988.945f, 26936.887f, 26885.062f, 26833.475f,
+  26782.119f, 26730.994f, 26680.100f, 26629.432f, 26578.988f, 26528.770f, 26478.771f, 26428.994f,
+  26379.434f, 26330.090f, 26280.963f, 26232.047f, 26183.342f, 26134.848f, 26086.561f, 26038.480f,
+  25990.605f, 25942.932f, 25895.461f, 25848.189f, 25801.117f, 25754.240f, 25707.561f, 25661.074f,
+  25614.779f, 25568.676f, 25522.762f, 25477.035f, 25431.496f, 25386.143f, 25340.973f, 25295.984f,
+  25251.178f, 25206.551f, 25162.104f, 25117.832f, 25073.736f, 25029.816f, 24986.068f, 24942.494f,
+  24899.090f, 24855.855f, 24812.789f, 24769.889f, 24727.156f, 24684.588f, 24642.184f, 24599.941f,
+  24557.859f, 24515.939f, 24474.178f, 24432.574f, 24391.127f, 24349.836f, 24308.701f, 24267.719f,
+  24226.889f, 24186.211f, 24145.684f, 24105.305f, 24065.074f, 24024.992f, 23985.057f, 23945.268f,
+  23905.623f, 23866.121f, 23826.762f, 23787.543f, 23748.467f, 23709.529f, 23670.732f, 23632.072f,
+  23593.549f, 23555.162f, 23516.912f, 23478.795f, 23440.811f, 23402.961f, 23365.242f, 23327.654f,
+  23290.197f, 23252.869f, 23215.670f, 23178.598f, 23141.654f, 23104.834f, 23068.141f, 23031.572f,
+  22995.129f, 22958.807f, 22922.607f, 22886.529f, 22850.570f, 22814.734f, 22779.016f, 22743.416f,
+  22707.934f, 22672.570f, 22637.322f, 22602.189f, 22567.172f, 22532.270f, 22497.479f, 22462.803f,
+  22428.238f, 22393.785f, 22359.443f, 22325.213f, 22291.092f, 22257.078f, 22223.174f, 22189.377f,
+  22155.688f, 22122.105f, 22088.627f, 22055.256f, 22021.988f, 21988.824f, 21955.766f, 21922.809f,
+  21889.953f, 21857.199f, 21824.549f, 21791.996f, 21759.545f, 21727.193f, 21694.939f, 21662.785f,
+  21630.727f, 21598.768f, 21566.904f, 21535.137f, 21503.465f, 21471.889f, 21440.406f, 21409.018f,
+  21377.723f, 21346.521f, 21315.412f, 21284.395f, 21253.469f, 21222.635f, 21191.891f, 21161.236f,
+  21130.670f, 21100.195f, 21069.809f, 21039.508f, 21009.297f, 20979.172f, 20949.135f, 20919.184f,
+  20889.318f, 20859.537f, 20829.842f, 20800.230f, 20770.705f, 20741.262f, 20711.900f, 20682.623f,
+  20653.428f, 20624.314f, 20595.281f, 20566.330f, 20537.461f, 20508.670f, 20479.959f, 20451.328f,
+  20422.775f, 20394.303f, 20365.906f, 20337.588f, 20309.348f, 20281.186f, 20253.098f, 20225.088f,
+  20197.152f, 20169.293f, 20141.510f, 20113.799f, 20086.164f, 20058.604f, 20031.115f, 20003.701f,
+  19976.359f, 19949.092f, 19921.895f, 19894.770f, 19867.717f, 19840.734f, 19813.822f, 19786.982f,
+  19760.211f, 19733.510f, 19706.879f, 19680.316f, 19653.822f, 19627.396f, 19601.041f, 19574.750f,
+  19548.529f, 19522.375f, 19496.287f, 19470.266f, 19444.311f, 19418.422f, 19392.598f, 19366.840f,
+  19341.146f, 19315.520f, 19289.955f, 19264.455f, 19239.020f, 19213.646f, 19188.338f, 19163.092f,
+  19137.908f, 19112.785f, 19087.727f, 19062.729f, 19037.793f, 19012.918f, 18988.105f, 18963.352f,
+  18938.660f, 18914.027f, 18889.455f, 18864.941f, 18840.488f, 18816.094f, 18791.758f, 18767.480f,
+  18743.262f, 18719.102f, 18694.998f, 18670.953f, 18646.965f, 18623.033f, 18599.160f, 18575.342f,
+  18551.580f, 18527.875f, 18504.225f, 18480.631f, 18457.092f, 18433.609f, 18410.180f, 18386.805f,
+  18363.486f, 18317.008f, 18270.746f, 18224.695f, 18178.857f, 18133.229f, 18087.807f, 18042.592f,
+  17997.580f, 17952.770f, 17908.162f, 17863.752f, 17819.541f, 17775.525f, 17731.703f, 17688.076f,
+  17644.639f, 17601.391f, 17558.330f, 17515.457f, 17472.770f, 17430.266f, 17387.943f, 17345.803f,
+  17303.840f, 17262.057f, 17220.449f, 17179.018f, 17137.760f, 17096.674f, 17055.760f, 17015.016f,
+  16974.441f, 16934.031f, 16893.789f, 16853.713f, 16813.799f, 16774.047f, 16734.457f, 16695.027f,
+  16655.756f, 16616.641f, 16577.684f, 16538.881f, 16500.232f, 16461.738f, 16423.395f, 16385.203f,
+  16347.159f, 16309.266f, 16271.520f, 16233.919f, 16196.465f, 16159.155f, 16121.988f, 16084.965f,
+  16048.082f, 16011.340f, 15974.737f, 15938.272f, 15901.946f, 15865.756f, 15829.701f, 15793.781f,
+  15757.995f, 15722.342f, 15686.821f, 15651.431f, 15616.171f, 15581.040f, 15546.038f, 15511.163f,
+  15476.415f, 15441.793f, 15407.296f, 15372.923f, 15338.673f, 15304.546f, 15270.541f, 15236.656f,
+  15202.893f, 15169.247f, 15135.722f, 15102.313f, 15069.021f, 15035.847f, 15002.788f, 14969.844f,
+  14937.013f, 14904.296f, 14871.692f, 14839.200f, 14806.818f, 14774.549f, 14742.388f, 14710.337f,
+  14678.394f, 14646.559f, 14614.831f, 14583.209f, 14551.693f, 14520.283f, 14488.978f, 14457.775f,
+  14426.677f, 14395.681f, 14364.787f, 14333.994f, 14303.303f, 14272.711f, 14242.220f, 14211.826f,
+  14181.532f, 14151.335f, 14121.235f, 14091.232f, 14061.326f, 14031.515f, 14001.799f, 13972.177f,
+  13942.649f, 13913.214f, 13883.872f, 13854.623f, 13825.465f, 13796.398f, 13767.423f, 13738.536f,
+  13709.740f, 13681.033f, 13652.415f, 13623.884f, 13595.441f, 13567.086f, 13538.816f, 13510.634f,
+  13482.536f, 13454.524f, 13426.597f, 13398.754f, 13370.995f, 13343.318f, 13315.726f, 13288.215f,
+  13260.786f, 13233.438f, 13206.172f, 13178.986f, 13151.881f, 13124.855f, 13097.908f, 13071.041f,
+  13044.252f, 13017.541f, 12990.907f, 12964.351f, 12937.871f, 12911.469f, 12885.142f, 12858.890f,
+  12832.713f, 12806.611f, 12780.585f, 12754.632f, 12728.752f, 12702.945f, 12677.212f, 12651.551f,
+  12625.962f, 12600.445f, 12574.999f, 12549.624f, 12524.320f, 12499.086f, 12473.923f, 12448.828f,
+  12423.803f, 12398.847f, 12373.958f, 12349.139f, 12324.387f, 12299.702f, 12275.085f, 12250.535f,
+  12226.051f, 12201.633f, 12177.281f, 12152.994f, 12128.772f, 12104.616f, 12080.524f, 12056.496f,
+  12032.532f, 12008.632f, 11984.795f, 11961.021f, 11937.310f, 11913.660f, 11890.073f, 11866.548f,
+  11843.084f, 11819.682f, 11796.340f, 11773.059f, 11749.838f, 11726.677f, 11703.576f, 11680.534f,
+  11657.552f, 11634.628f, 11611.763f, 11588.956f, 11566.207f, 11543.516f, 11520.883f, 11498.307f,
+  11475.787f, 11453.325f, 11430.919f, 11408.568f, 11386.275f, 11364.037f, 11341.854f, 11319.727f,
+  11297.653f, 11275.636f, 11253.672f, 11231.762f, 11209.906f, 11188.104f, 11166.356f, 11144.661f,
+  11123.019f, 11101.429f, 11079.892f, 11058.407f, 11036.975f, 11015.593f, 10994.264f, 10972.985f,
+  10951.759f, 10930.582f, 10909.457f, 10888.382f, 10867.356f, 10846.382f, 10825.457f, 10804.581f,
+  10783.755f, 10762.978f, 10742.250f, 10721.570f, 10700.939f, 10680.356f, 10659.822f, 10639.335f,
+  10618.896f, 10578.160f, 10537.612f, 10497.251f, 10457.074f, 10417.082f, 10377.271f, 10337.641f,
+  10298.189f, 10258.916f, 10219.817f, 10180.895f, 10142.145f, 10103.565f, 10065.157f, 10026.919f,
+  9988.847f, 9950.941f, 9913.201f, 9875.624f, 9838.209f, 9800.956f, 9763.862f, 9726.927f,
+  9690.148f, 9653.526f, 9617.059f, 9580.745f, 9544.583f, 9508.573f, 9472.713f, 9437.002f,
+  9401.438f, 9366.021f, 9330.751f, 9295.624f, 9260.641f, 9225.800f, 9191.100f, 9156.540f,
+  9122.120f, 9087.838f, 9053.692f, 9019.684f, 8985.810f, 8952.070f, 8918.463f, 8884.988f,
+  8851.646f, 8818.433f, 8785.349f, 8752.394f, 8719.566f, 8686.865f, 8654.290f, 8621.839f,
+  8589.513f, 8557.310f, 8525.229f, 8493.269f, 8461.429f, 8429.709f, 8398.108f, 8366.626f,
+  8335.261f, 8304.012f, 8272.878f, 8241.859f, 8210.955f, 8180.164f, 8149.486f, 8118.919f,
+  8088.463f, 8058.118f, 8027.882f, 7997.755f, 7967.736f, 7937.825f, 7908.021f, 7878.322f,
+  7848.729f, 7819.240f, 7789.855f, 7760.574f, 7731.396f, 7702.319f, 7673.343f, 7644.468f,
+  7615.693f, 7587.018f, 7558.441f, 7529.963f, 7501.582f, 7473.298f, 7445.110f, 7417.018f,
+  7389.021f, 7361.119f, 7333.310f, 7305.595f, 7277.973f, 7250.442f, 7223.003f, 7195.656f,
+  7168.399f, 7141.232f, 7114.154f, 7087.166f, 7060.265f, 7033.453f, 7006.728f, 6980.089f,
+  6953.537f, 6927.070f, 6900.688f, 6874.392f, 6848.180f, 6822.051f, 6796.006f, 6770.043f,
+  6744.163f, 6718.364f, 6692.647f, 6667.011f, 6641.455f, 6615.979f, 6590.582f, 6565.264f,
+  6540.025f, 6514.864f, 6489.781f, 6464.775f, 6439.846f, 6414.993f, 6390.216f, 6365.514f,
+  6340.888f, 6316.336f, 6291.858f, 6267.455f, 6243.125f, 6218.867f, 6194.683f, 6170.570f,
+  6146.530f, 6122.561f, 6098.663f, 6074.835f, 6051.078f, 6027.391f, 6003.773f, 5980.224f,
+  5956.744f, 5933.333f, 5909.989f, 5886.713f, 5863.505f, 5840.363f, 5817.289f, 5794.280f,
+  5771.337f, 5748.459f, 5725.647f, 5702.900f, 5680.218f, 5657.599f, 5635.044f, 5612.554f,
+  5590.125f, 5567.761f, 5545.458f, 5523.218f, 5501.040f, 5478.923f, 5456.867f, 5434.873f,
+  5412.939f, 5391.065f, 5369.252f, 5347.498f, 5325.804f, 5304.168f, 5282.592f, 5261.075f,
+  5239.615f, 5218.213f, 5196.870f, 5175.583f, 5154.354f, 5133.182f, 5112.065f, 5091.006f,
+  5070.002f, 5049.054f, 5028.162f, 5007.324f, 4986.542f, 4965.814f, 4945.141f, 4924.521f,
+  4903.957f, 4883.445f, 4862.986f, 4842.581f, 4822.229f, 4801.929f, 4781.681f, 4761.486f,
+  4741.342f, 4721.250f, 4701.209f, 4681.220f, 4661.282f, 4641.394f, 4621.556f, 4601.769f,
+  4582.031f, 4562.344f, 4542.705f, 4523.116f, 4503.576f, 4484.085f, 4464.643f, 4445.249f,
+  4425.902f, 4406.604f, 4387.354f, 4368.150f, 4348.995f, 4329.886f, 4310.824f, 4291.809f,
+  4272.840f, 4253.917f, 4235.041f, 4216.210f, 4197.425f, 4178.685f, 4159.990f, 4141.340f,
+  4122.735f, 4104.175f, 4085.659f, 4067.188f, 4048.760f, 4030.376f, 4012.036f, 3993.739f,
+  3975.485f, 3957.275f, 3939.107f, 3920.982f, 3902.900f, 3884.860f, 3866.862f, 3848.906f,
+  3830.991f, 3795.287f, 3759.748f, 3724.373f, 3689.160f, 3654.107f, 3619.214f, 3584.479f,
+  3549.902f, 3515.479f, 3481.211f, 3447.096f, 3413.133f, 3379.320f, 3345.656f, 3312.141f,
+  3278.772f, 3245.549f, 3212.470f, 3179.535f, 3146.743f, 3114.091f, 3081.579f, 3049.206f,
+  3016.971f, 2984.873f, 2952.910f, 2921.083f, 2889.388f, 2857.826f, 2826.396f, 2795.096f,
+  2763.926f, 2732.884f, 2701.970f, 2671.183f, 2640.521f, 2609.984f, 2579.570f, 2549.280f,
+  2519.111f, 2489.064f, 2459.137f, 2429.329f, 2399.639f, 2370.067f, 2340.612f, 2311.273f,
+  2282.048f, 2252.938f, 2223.941f, 2195.057f, 2166.285f, 2137.623f, 2109.072f, 2080.630f,
+  2052.297f, 2024.071f, 1995.953f, 1967.941f, 1940.035f, 1912.234f, 1884.537f, 1856.943f,
+  1829.452f, 1802.063f, 1774.776f, 1747.589f, 1720.502f, 1693.515f, 1666.626f, 1639.835f,
+  1613.142f, 1586.545f, 1560.044f, 1533.639f, 1507.328f, 1481.112f, 1454.989f, 1428.959f,
+  1403.021f, 1377.176f, 1351.421f, 1325.757f, 1300.182f, 1274.697f, 1249.301f, 1223.993f,
+  1198.773f, 1173.640f, 1148.593f, 1123.633f, 1098.758f, 1073.968f, 1049.262f, 1024.640f,
+  1000.101f, 975.646f, 951.272f, 926.981f, 902.770f, 878.641f, 854.592f, 830.623f,
+  806.733f, 782.921f, 759.189f, 735.534f, 711.956f, 688.456f, 665.032f, 641.684f,
+  618.412f, 595.215f, 572.092f, 549.044f, 526.070f, 503.169f, 480.341f, 457.585f,
+  434.902f, 412.290f, 389.750f, 367.280f, 344.881f, 322.552f, 300.293f, 278.103f,
+  255.981f, 233.929f, 211.944f, 190.027f, 168.177f, 146.394f, 124.678f, 103.028f,
+  81.443f, 59.924f, 38.471f, 17.082f, -4.243f, -25.504f, -46.701f, -67.835f,
+  -88.906f, -109.914f, -130.860f, -151.744f, -172.566f, -193.328f, -214.028f, -234.668f,
+  -255.247f, -275.767f, -296.227f, -316.627f, -336.969f, -357.252f, -377.476f, -397.642f,
+  -417.751f, -437.802f, -457.797f, -477.734f, -497.614f, -517.439f, -537.207f, -556.920f,
+  -576.578f, -596.180f, -615.727f, -635.220f, -654.659f, -674.044f, -693.375f, -712.652f,
+  -731.877f, -751.048f, -770.167f, -789.233f, -808.248f, -827.210f, -846.121f, -864.981f,
+  -883.790f, -902.548f, -921.255f, -939.912f, -958.519f, -977.076f, -995.583f, -1014.041f,
+  -1032.450f, -1050.811f, -1069.122f, -1087.386f, -1105.601f, -1123.768f, -1141.888f, -1159.960f,
+  -1177.985f, -1195.963f, -1213.894f, -1231.778f, -1249.617f, -1267.409f, -1285.155f, -1302.856f,
+  -1320.511f, -1338.121f, -1355.686f, -1373.206f, -1390.682f, -1408.113f, -1425.500f, -1442.843f,
+  -1460.143f, -1477.398f, -1494.611f, -1511.780f, -1528.906f, -1545.989f, -1563.030f, -1580.029f,
+  -1596.985f, -1613.899f, -1630.772f, -1647.603f, -1664.392f, -1681.140f, -1697.848f, -1714.514f,
+  -1731.140f, -1747.725f, -1764.270f, -1780.774f, -1797.239f, -1813.664f, -1830.049f, -1846.395f,
+  -1862.702f, -1878.969f, -1895.198f, -1911.388f, -1927.539f, -1943.652f, -1959.727f, -1975.763f,
+  -1991.762f, -2007.723f, -2023.646f, -2039.532f, -2055.381f, -2071.193f, -2086.968f, -2102.706f,
+  -2118.407f
+};
+#endif
+
+#endif
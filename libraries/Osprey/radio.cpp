@@ -1,6 +1,18 @@
 #include "radio.h"
 
+using namespace Osprey;
+
 Uart *Radio::RadioSerial = &Serial1;
+Ring<char, RADIO_RX_BUFFER_SIZE> Radio::rxRing;
+
+Ring<radio_packet_t, RADIO_TELEMETRY_PACKETS> Radio::telemetryQueue;
+Ring<radio_packet_t, RADIO_EVENT_PACKETS> Radio::eventQueue;
+radio_packet_t Radio::txPacket;
+int Radio::txPosition = 0;
+unsigned long Radio::txRejected = 0;
+uint8_t Radio::txSequence[TELEMETRY_TYPES];
+
+static_assert(TELEMETRY_MAX_FRAME <= RADIO_MAX_PACKET, "a telemetry packet must fit in one radio packet");
 
 char Radio::message1[RADIO_MAX_LINE_LENGTH];
 char Radio::message2[RADIO_MAX_LINE_LENGTH];
@@ -9,6 +21,8 @@ char Radio::mostRecentMessage[RADIO_MAX_LINE_LENGTH];
 char* Radio::previousMessage = message1;
 char* Radio::currentMessage = message2;
 int Radio::messagePosition = 0;
+bool Radio::overlong = false;
+unsigned long Radio::overlongLines = 0;
 
 int Radio::init() {
   RadioSerial->begin(RADIO_BAUD);
@@ -23,28 +37,77 @@ int Radio::init() {
   return 1;
 }
 
-void Radio::send(const char* const message) {
-  for(int i=0; message[i] != '\0'; i++) {
-    RadioSerial->write(message[i]);
-  }
-
+int Radio::send(const char* const message, int kind) {
   /*
   if(isLogging()) {
     logger.log(message);
   }
   */
+
+  return send((const uint8_t*)message, strlen(message), kind);
+}
+
+int Radio::send(const uint8_t *data, size_t length, int kind) {
+  radio_packet_t packet;
+  int queued = 1;
+
+  // An event goes whole or not at all. The tick interrupt only ever frees
+  // room, so what's free now is there for every packet.
+  if(kind == RADIO_EVENT && eventQueue.free() < (length + RADIO_MAX_PACKET - 1) / RADIO_MAX_PACKET) {
+    txRejected++;
+    return 0;
+  }
+
+  // Queued a packet at a time and sent from the tick interrupt, so this
+  // never waits on the UART
+  while(length > 0) {
+    packet.length = (length < RADIO_MAX_PACKET ? length : RADIO_MAX_PACKET);
+    memcpy(packet.data, data, packet.length);
+    queued &= queue(packet, kind);
+
+    data += packet.length;
+    length -= packet.length;
+  }
+
+  return queued;
+}
+
+int Radio::sendPacket(uint8_t type, const void *payload, size_t length, int kind) {
+  radio_packet_t packet;
+  uint8_t sequence = (type < TELEMETRY_TYPES ? txSequence[type]++ : 0);
+
+  // Encoded straight into the one radio packet, so if it's dropped it's
+  // dropped whole
+  packet.length = telemetryEncode(type, sequence, payload, length, (uint8_t*)packet.data);
+  return queue(packet, kind);
+}
+
+int Radio::queue(const radio_packet_t &packet, int kind) {
+  if(kind != RADIO_EVENT) {
+    telemetryQueue.pushOverwriting(packet);
+    return 1;
+  }
+
+  // Callers run from the flight loop, so a full event queue is refused at
+  // once rather than waited out
+  if(!eventQueue.push(packet)) {
+    txRejected++;
+    return 0;
+  }
+
+  return 1;
 }
 
 void Radio::send(float message, int precision) {
-  char buffer[RADIO_MAX_LINE_LENGTH];
-  floatToString(message, precision, buffer);
+  char buffer[FORMAT_FIXED_LENGTH];
+  formatFixed(message, precision, buffer);
 
   send(buffer);
 }
 
 void Radio::send(int message) {
-  char buffer[RADIO_MAX_LINE_LENGTH];
-  sprintf(buffer, "%d", message);
+  char buffer[FORMAT_INT_LENGTH];
+  formatInt(message, buffer);
 
   send(buffer);
 }
@@ -61,51 +124,100 @@ void Radio::clear() {
   previousMessage[0] = '\0';
 }
 
-void Radio::read() {
-  if(!RadioSerial->available()) {
-    return;
-  }
+void Radio::poll() {
+  receive();
+  transmit();
+}
 
-  char c = RadioSerial->read();
+void Radio::receive() {
+  // The core's own buffer is small, so empty it every tick
+  while(RadioSerial->available()) {
+    rxRing.push(RadioSerial->read());
+  }
+}
 
-  // If the end of the line, set a NUL terminator and swap the message buffers
-  if(c == '\n') {
-    currentMessage[messagePosition] = '\0';
+void Radio::transmit() {
+  int room = RadioSerial->availableForWrite();
 
-    if(currentMessage == message1) {
-      currentMessage = message2;
-      previousMessage = message1;
-    } else {
-      currentMessage = message1;
-      previousMessage = message2;
+  while(room > 0) {
+    // Events go ahead of telemetry, but never into the middle of a packet
+    if(txPosition == txPacket.length) {
+      if(!eventQueue.pop(&txPacket) && !telemetryQueue.pop(&txPacket)) {
+        return;
+      }
+      txPosition = 0;
     }
 
-    messagePosition = 0;
-  } else {
-    currentMessage[messagePosition] = c;
-    messagePosition++;
+    int length = txPacket.length - txPosition;
+    if(length > room) length = room;
+
+    RadioSerial->write((const uint8_t*)txPacket.data + txPosition, length);
+    txPosition += length;
+    room -= length;
   }
+}
 
-  // Keep putting new chars in the last index of the message if we hit the limit
-  // Hopefully a newline will come through and properly terminate the string
-  if(messagePosition >= RADIO_MAX_LINE_LENGTH) {
-    messagePosition--;
+void Radio::read() {
+  char c;
+
+  // A finished line waits in previousMessage until clear() and the bytes
+  // after it wait in the ring, so nothing is lost to a slow caller. Bytes
+  // that arrive meanwhile wait for the next call.
+  for(unsigned i=0; i<rxRing.capacity() && previousMessage[0] == '\0' && rxRing.pop(&c); i++) {
+    // If the end of the line, set a NUL terminator and swap the message buffers
+    if(c == '\n') {
+      if(overlong) {
+        overlong = false;
+        overlongLines++;
+      } else {
+        currentMessage[messagePosition] = '\0';
+
+        if(currentMessage == message1) {
+          currentMessage = message2;
+          previousMessage = message1;
+        } else {
+          currentMessage = message1;
+          previousMessage = message2;
+        }
+      }
+
+      messagePosition = 0;
+    } else if(messagePosition < RADIO_MAX_LINE_LENGTH - 1) {
+      currentMessage[messagePosition] = c;
+      messagePosition++;
+    } else {
+      // Too long for any command. Drop the whole line rather than act on
+      // what fitted.
+      overlong = true;
+    }
   }
+}
+
+unsigned long Radio::getRxDropped() {
+  return rxRing.getDropped();
+}
+
+unsigned long Radio::getOverlong() {
+  return overlongLines;
+}
+
+unsigned Radio::getTxQueued() {
+  return eventQueue.available() + telemetryQueue.available();
+}
+
+unsigned long Radio::getTxDropped() {
+  return telemetryQueue.getDropped();
+}
 
-  // Keep reading until there is no more data to read
-  return read();
+unsigned long Radio::getTxRejected() {
+  return txRejected;
 }
 
 int Radio::enableLogging() {
   // If already logging, do nothing
   if(isLogging()) return 1;
 
-  if(logger.open()) {
-    logging = true;
-    return 1;
-  }
-
-  return 0;
+  return logger.open();
 }
 
 int Radio::disableLogging() {
@@ -113,39 +225,18 @@ int Radio::disableLogging() {
   if(!isLogging()) return 1;
 
   logger.close();
-  logging = false;
   return 1;
 }
 
 int Radio::isLogging() {
-  return (logging ? 1 : 0);
+  // The logger is shared with the flight loop so its state is the source of truth
+  return logger.isOpen();
 }
 
 void Radio::flushLog() {
   logger.flush();
 }
 
-void Radio::floatToString(float num, int precision, char *buffer) {
-  // Get the whole part of the number
-  int characteristic = num;
-
-  // Subtract the whole part leaving only the fractional part
-  num -= characteristic;
-
-  // Move the decimal place by the amount of precision specified
-  int mantissa = num * powf(10, precision);
-
-  // If negative, make positive
-  if(mantissa < 0) {
-    mantissa = -mantissa;
-  }
-
-  // Combine the characteristic and mantissa in a string
-  char format[RADIO_MAX_LINE_LENGTH];
-  sprintf(format, "%%0%dd.%%0%dd", 1, precision);
-  sprintf(buffer, format, characteristic, mantissa);
-}
-
 char* Radio::getMostRecentMessage() {
   return mostRecentMessage;
 }
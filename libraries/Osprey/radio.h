@@ -4,16 +4,46 @@
 #include <Arduino.h>
 #include <avr/dtostrf.h>
 
+#include "format.h"
 #include "sensor.h"
 #include "logger.h"
+#include "ring.h"
+#include "telemetry.h"
 
 #define RADIO_BAUD 115200
 #define RADIO_MAX_LINE_LENGTH 64
+#define RADIO_RX_BUFFER_SIZE 1024 // bytes, 10 ms at 100 kB/s
+#define RADIO_MAX_LINES 64 // lines handled per radio task
+
+#define RADIO_MAX_PACKET 64 // bytes, longer messages go as several packets
+#define RADIO_TELEMETRY_PACKETS 8 // queued before the oldest are dropped
+#define RADIO_EVENT_PACKETS 8 // queued before further events are rejected
+
+// Telemetry is only worth having fresh, so when its queue is full the oldest
+// packet makes way. Events and acknowledgements are never dropped from the
+// queue, and go out ahead of any waiting telemetry. When there's no room for
+// one, send() returns 0 straight away and it counts as rejected.
+#define RADIO_TELEMETRY 0
+#define RADIO_EVENT 1
+
+typedef struct radio_packet_t {
+  uint8_t length;
+  char data[RADIO_MAX_PACKET];
+} radio_packet_t;
+
+namespace Osprey {
+  extern Logger logger;
+}
 
 class Radio : public virtual Sensor {
   public:
     int init();
-    void send(const char* const message);
+    int send(const char* const message, int kind=RADIO_TELEMETRY);
+    int send(const uint8_t *data, size_t length, int kind=RADIO_TELEMETRY);
+
+    // One binary packet of the given type (see telemetry.h)
+    int sendPacket(uint8_t type, const void *payload, size_t length, int kind=RADIO_TELEMETRY);
+
     void send(float message, int precision=2);
     void send(int message);
     char* recv();
@@ -24,14 +54,32 @@ class Radio : public virtual Sensor {
     void flushLog();
     char* getMostRecentMessage();
 
-    static void floatToString(float num, int precision, char *buffer);
     static void read();
 
+    // Moves bytes between the UART and the rings, without ever waiting on
+    // it. Runs in the scheduler's tick interrupt.
+    static void poll();
+
+    static unsigned long getRxDropped();
+    static unsigned long getOverlong();
+    static unsigned getTxQueued();
+    static unsigned long getTxDropped();
+    static unsigned long getTxRejected();
+
   protected:
-    bool logging;
-    Logger logger;
+    static void receive();
+    static void transmit();
+    static int queue(const radio_packet_t &packet, int kind);
 
     static Uart *RadioSerial;
+    static Osprey::Ring<char, RADIO_RX_BUFFER_SIZE> rxRing;
+
+    static Osprey::Ring<radio_packet_t, RADIO_TELEMETRY_PACKETS> telemetryQueue;
+    static Osprey::Ring<radio_packet_t, RADIO_EVENT_PACKETS> eventQueue;
+    static radio_packet_t txPacket;
+    static int txPosition;
+    static unsigned long txRejected;
+    static uint8_t txSequence[TELEMETRY_TYPES];
 
     static char message1[];
     static char message2[];
@@ -40,6 +88,8 @@ class Radio : public virtual Sensor {
     static char *currentMessage;
     static char *previousMessage;
     static int messagePosition;
+    static bool overlong;
+    static unsigned long overlongLines;
 };
 
 #endif
@@ -0,0 +1,77 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+// Binary flight log format
+//
+// A log starts with a log_header_t followed by a stream of records. Each record
+// is a record_header_t followed by a fixed size payload for its type. Everything
+// is little-endian and packed. This header is shared with the host-side decoder
+// in tools/logdecode so it must not depend on anything Arduino specific.
+
+#include <stdint.h>
+
+#define RECORD_MAGIC 0x5250534F // "OSPR" as bytes on disk
+#define RECORD_VERSION 1
+#define RECORD_SCHEMA 2
+#define RECORD_QUATERNION_SCALE 16384
+
+// Record types. Zero and 0xFF are never used so that zero padding and erased
+// flash both read back as the end of the log.
+#define RECORD_END 0x00
+#define RECORD_IMU 0x01
+#define RECORD_BARO 0x02
+#define RECORD_GPS 0x03
+#define RECORD_EVENT 0x04
+#define RECORD_ERASED 0xFF
+
+// Event record kinds
+#define RECORD_EVENT_PHASE 0
+#define RECORD_EVENT_FIRE 1
+#define RECORD_EVENT_APOGEE 2
+
+typedef struct __attribute__((packed)) log_header_t {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t schema;
+  uint32_t startTime; // ms since boot when the log was opened
+} log_header_t;
+
+typedef struct __attribute__((packed)) record_header_t {
+  uint8_t type;
+  uint8_t length;     // payload length in bytes, so unknown types can be skipped
+  uint32_t timestamp; // ms since boot
+} record_header_t;
+
+// Schema 1 logged roll, pitch and heading in centidegrees in place of the
+// quaternion. Attitude is now left as the fused quaternion so no trig is done
+// on board.
+typedef struct __attribute__((packed)) imu_record_t {
+  int16_t accelerationX; // cm/s^2
+  int16_t accelerationY; // cm/s^2
+  int16_t accelerationZ; // cm/s^2
+  int16_t quaternionW;   // 1/16384
+  int16_t quaternionX;   // 1/16384
+  int16_t quaternionY;   // 1/16384
+  int16_t quaternionZ;   // 1/16384
+} imu_record_t;
+
+typedef struct __attribute__((packed)) baro_record_t {
+  int32_t pressure;    // Pa
+  int16_t temperature; // centidegrees C
+  int32_t altitude;    // cm above ground
+} baro_record_t;
+
+typedef struct __attribute__((packed)) gps_record_t {
+  int32_t latitude;  // 1e-7 degrees
+  int32_t longitude; // 1e-7 degrees
+  int32_t altitude;  // cm above sea level
+  uint16_t speed;    // centiknots
+  uint8_t quality;
+} gps_record_t;
+
+typedef struct __attribute__((packed)) event_record_t {
+  uint8_t kind;
+  uint8_t value;
+} event_record_t;
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef RING_H
+#define RING_H
+
+// Lock free single producer, single consumer ring buffer
+//
+// One side, usually an interrupt handler, only ever pushes and the other only
+// ever pops, so neither needs to disable interrupts. Each index is written by
+// one side only, and the element is written before the index that publishes
+// it (and read before the index that frees it). The SAMD21 has one core, so
+// a compiler barrier is enough to keep that order.
+//
+// Indices run freely and wrap with the unsigned arithmetic. The size must be
+// a power of two so that they still map onto the buffer after wrapping. When
+// the buffer is full, push fails and counts the drop, so the oldest data is
+// never overwritten under the consumer.
+//
+// pushOverwriting instead makes room by discarding the oldest element. The
+// producer can't move the tail, so it moves a discard mark past the oldest
+// element and the consumer skips up to the mark before it next reads. That
+// is only safe when the consumer can't be interrupted by the producer, as
+// when the consumer is itself the interrupt handler.
+
+#include <stdint.h>
+
+#define RING_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+namespace Osprey {
+
+template<typename T, unsigned N>
+class Ring {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "ring size must be a power of two");
+
+  public:
+    Ring() : head(0), tail(0), discard(0), dropped(0), discarded(0) {}
+
+    // Producer side
+    bool push(const T &value) {
+      unsigned h = head;
+      unsigned o = follow();
+      if(h - o == N) {
+        dropped++;
+        return false;
+      }
+
+      buffer[h & (N - 1)] = value;
+      RING_BARRIER();
+      head = h + 1;
+      return true;
+    }
+
+    void pushOverwriting(const T &value) {
+      unsigned h = head;
+      unsigned o = follow();
+      if(h - o == N) {
+        discard = o + 1;
+        RING_BARRIER();
+      }
+
+      buffer[h & (N - 1)] = value;
+      RING_BARRIER();
+      head = h + 1;
+    }
+
+    unsigned free() const { return N - (head - oldest()); }
+
+    // Consumer side
+    bool pop(T *value) {
+      unsigned t = tail;
+      if((int)(discard - t) > 0) {
+        discarded += discard - t;
+        t = discard;
+        tail = t;
+      }
+      if(head == t) return false;
+
+      *value = buffer[t & (N - 1)];
+      RING_BARRIER();
+      tail = t + 1;
+      return true;
+    }
+
+    unsigned available() const { return head - oldest(); }
+
+    // Either side. Each counter is written by one side only.
+    unsigned long getDropped() const { return dropped + discarded; }
+    static unsigned capacity() { return N; }
+
+  protected:
+    // The first element the consumer will read
+    unsigned oldest() const {
+      unsigned t = tail;
+      unsigned d = discard;
+      return (int)(d - t) > 0 ? d : t;
+    }
+
+    // Producer side. Brings a stale discard mark up to the tail, so it can't
+    // fall so far behind that the wrapped comparison sees it ahead again.
+    unsigned follow() {
+      unsigned o = oldest();
+      discard = o;
+      return o;
+    }
+
+    T buffer[N];
+    volatile unsigned head;
+    volatile unsigned tail;
+    volatile unsigned discard;
+    volatile unsigned long dropped;
+    volatile unsigned long discarded;
+};
+
+}
+
+#endif
@@ -0,0 +1,164 @@
+#include "scheduler.h"
+
+#ifdef ARDUINO
+  #include <Arduino.h>
+#endif
+
+volatile unsigned long Scheduler::ticks = 0;
+task_callback_t volatile Scheduler::tickCallback = 0;
+
+// Wrap safe "a is at or after b" for the free running microsecond clock
+static inline int reached(unsigned long a, unsigned long b) {
+  return (long)(a - b) >= 0;
+}
+
+#ifdef ARDUINO
+Scheduler::Scheduler() : clock(micros), taskCount(0) {}
+#endif
+
+Scheduler::Scheduler(scheduler_clock_t clock) : clock(clock), taskCount(0) {}
+
+int Scheduler::init() {
+  startTimer();
+  start();
+
+  return 1;
+}
+
+int Scheduler::add(const char *name, task_callback_t callback, unsigned long period, unsigned long deadline) {
+  if(taskCount >= SCHEDULER_MAX_TASKS || period == 0) {
+    return 0;
+  }
+
+  task_t *task = &tasks[taskCount];
+  task->name = name;
+  task->callback = callback;
+  task->period = period;
+  // By default a task has until its next release to finish
+  task->deadline = (deadline == 0 ? period : deadline);
+
+  taskCount++;
+  resetStats();
+
+  return 1;
+}
+
+void Scheduler::start() {
+  unsigned long now = clock();
+
+  // Everything is released immediately and then at its own rate
+  for(int i=0; i<taskCount; i++) {
+    tasks[i].release = now;
+  }
+}
+
+int Scheduler::run() {
+  int ran = 0;
+
+  for(int i=0; i<taskCount; i++) {
+    task_t *task = &tasks[i];
+    unsigned long start = clock();
+
+    if(!reached(start, task->release)) {
+      continue;
+    }
+
+    unsigned long jitter = start - task->release;
+    task->callback();
+    unsigned long end = clock();
+
+    unsigned long duration = end - start;
+    if(duration > task->maxDuration) task->maxDuration = duration;
+    if(jitter > task->maxJitter) task->maxJitter = jitter;
+    task->totalJitter += jitter;
+    if(!reached(task->release + task->deadline, end)) task->overruns++;
+    task->runs++;
+
+    // Stay on the original time base, but don't try to catch up on releases
+    // that have already passed
+    task->release += task->period;
+    while(reached(end, task->release + task->period)) {
+      task->release += task->period;
+      task->missed++;
+    }
+
+    ran++;
+  }
+
+#ifdef __SAMD21G18A__
+  // Nothing was ready, so sleep until the next tick (or any other interrupt)
+  if(ran == 0) {
+    __WFI();
+  }
+#endif
+
+  return ran;
+}
+
+int Scheduler::numTasks() {
+  return taskCount;
+}
+
+const task_t* Scheduler::getTask(int index) {
+  if(index < 0 || index >= taskCount) {
+    return 0;
+  }
+
+  return &tasks[index];
+}
+
+void Scheduler::resetStats() {
+  for(int i=0; i<taskCount; i++) {
+    tasks[i].runs = 0;
+    tasks[i].overruns = 0;
+    tasks[i].missed = 0;
+    tasks[i].maxJitter = 0;
+    tasks[i].totalJitter = 0;
+    tasks[i].maxDuration = 0;
+  }
+}
+
+unsigned long Scheduler::getTicks() {
+  return ticks;
+}
+
+void Scheduler::tick() {
+  ticks++;
+
+  task_callback_t callback = tickCallback;
+  if(callback) callback();
+}
+
+void Scheduler::setTickCallback(task_callback_t callback) {
+  tickCallback = callback;
+}
+
+#ifdef __SAMD21G18A__
+void Scheduler::startTimer() {
+  // Clock TC3 from the 48 MHz main clock
+  GCLK->CLKCTRL.reg = (uint16_t)(GCLK_CLKCTRL_CLKEN | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_ID(GCM_TCC2_TC3));
+  while(GCLK->STATUS.bit.SYNCBUSY);
+
+  TcCount16 *tc = &TC3->COUNT16;
+  tc->CTRLA.reg &= ~TC_CTRLA_ENABLE;
+  while(tc->STATUS.bit.SYNCBUSY);
+
+  // Count up to CC0 and wrap, interrupting every tick
+  tc->CTRLA.reg = TC_CTRLA_MODE_COUNT16 | TC_CTRLA_WAVEGEN_MFRQ | TC_CTRLA_PRESCALER_DIV16;
+  tc->CC[0].reg = (SystemCoreClock / 16 / SCHEDULER_TICK_HZ) - 1;
+  while(tc->STATUS.bit.SYNCBUSY);
+
+  tc->INTENSET.reg = TC_INTENSET_MC0;
+  NVIC_EnableIRQ(TC3_IRQn);
+
+  tc->CTRLA.reg |= TC_CTRLA_ENABLE;
+  while(tc->STATUS.bit.SYNCBUSY);
+}
+
+void TC3_Handler() {
+  TC3->COUNT16.INTFLAG.reg = TC_INTFLAG_MC0;
+  Scheduler::tick();
+}
+#else
+void Scheduler::startTimer() {}
+#endif
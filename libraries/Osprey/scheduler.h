@@ -0,0 +1,68 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+// Fixed-rate cooperative scheduler
+//
+// Tasks register with a period and a deadline. Each call to run() starts
+// every task that has been released, in registration order, so tasks added
+// first have priority. Tasks must not block; a task that runs past its
+// deadline is counted as an overrun. Time comes from a clock function so the
+// scheduler can be driven by a simulated clock on the host. On the SAMD21 a
+// TC3 tick wakes the CPU between tasks.
+
+#include <stdint.h>
+
+#define SCHEDULER_MAX_TASKS 12
+#define SCHEDULER_TICK_HZ 1000
+
+typedef void (*task_callback_t)(void);
+typedef unsigned long (*scheduler_clock_t)(void);
+
+typedef struct task_t {
+  const char *name;
+  task_callback_t callback;
+  unsigned long period;      // us
+  unsigned long deadline;    // us after release
+  unsigned long release;     // time of the next release
+
+  // Instrumentation, all times in us
+  unsigned long runs;
+  unsigned long overruns;    // runs that finished after their deadline
+  unsigned long missed;      // releases skipped because the task was too late
+  unsigned long maxJitter;   // latest start after release
+  unsigned long totalJitter;
+  unsigned long maxDuration;
+} task_t;
+
+class Scheduler {
+  public:
+    Scheduler();
+    Scheduler(scheduler_clock_t clock);
+    int init();
+
+    int add(const char *name, task_callback_t callback, unsigned long period, unsigned long deadline=0);
+    void start();
+    int run();
+
+    int numTasks();
+    const task_t* getTask(int index);
+    void resetStats();
+
+    static unsigned long getTicks();
+    static void tick();
+
+    // Runs in the tick interrupt, so it has to be short
+    static void setTickCallback(task_callback_t callback);
+
+  protected:
+    scheduler_clock_t clock;
+    task_t tasks[SCHEDULER_MAX_TASKS];
+    int taskCount;
+
+    static volatile unsigned long ticks;
+    static task_callback_t volatile tickCallback;
+
+    void startTimer();
+};
+
+#endif
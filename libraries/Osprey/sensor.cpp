@@ -11,15 +11,16 @@ Sensor::Sensor(float processNoise, float measurementNoise, float error) {
 kalman_t Sensor::kalmanInit(float initialValue) {
   kalman_t kalman;
 
-  kalman.processNoise = processNoise;
-  kalman.measurementNoise = measurementNoise;
-  kalman.error = error;
-  kalman.value = initialValue;
+  kalman.processNoise = kalman_value_t(processNoise);
+  kalman.measurementNoise = kalman_value_t(measurementNoise);
+  kalman.error = kalman_value_t(error);
+  kalman.value = kalman_value_t(initialValue);
 
   return kalman;
 }
 
-void Sensor::kalmanUpdate(kalman_t* state, float measurement) {
+// Same code for float and Fixed, see FIXED_POINT_MATH
+void Sensor::kalmanUpdate(kalman_t* state, kalman_value_t measurement) {
   // Prediction update
   state->error = state->error + state->processNoise;
 
@@ -28,3 +29,11 @@ void Sensor::kalmanUpdate(kalman_t* state, float measurement) {
   state->value = state->value + state->gain * (measurement - state->value);
   state->error = (1 - state->gain) * state->error;
 }
+
+float Sensor::kalmanValue(const kalman_t* state) {
+#if FIXED_POINT_MATH
+  return state->value.toFloat();
+#else
+  return state->value;
+#endif
+}
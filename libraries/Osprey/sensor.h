@@ -18,7 +18,8 @@ class Sensor {
 
   protected:
     kalman_t kalmanInit(float intial_value);
-    void kalmanUpdate(kalman_t* state, float measurement);
+    void kalmanUpdate(kalman_t* state, kalman_value_t measurement);
+    float kalmanValue(const kalman_t* state);
 
   private:
     float processNoise;
@@ -0,0 +1,157 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+// Binary radio telemetry
+//
+// Every packet is a telemetry_header_t, a payload for its type and a CRC-16
+// of both, COBS encoded so that it contains no zero bytes and then ended with
+// a zero. A receiver can join the stream anywhere and resynchronises at the
+// next zero. Everything is little-endian and packed. This header is shared
+// with the host-side decoder in tools/teledecode so it must not depend on
+// anything Arduino specific.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define TELEMETRY_QUATERNION_SCALE 16384
+
+// A whole encoded packet, delimiter included, fits in one radio packet so
+// the transmit queue only ever drops whole packets
+#define TELEMETRY_MAX_FRAME 64
+#define TELEMETRY_OVERHEAD 6 // header, CRC, COBS code and delimiter
+#define TELEMETRY_MAX_PAYLOAD (TELEMETRY_MAX_FRAME - TELEMETRY_OVERHEAD)
+
+// Packet types
+#define TELEMETRY_STATE 0x01
+#define TELEMETRY_ACK 0x02
+#define TELEMETRY_TYPES 3 // one more than the highest type
+
+// Decode results
+#define TELEMETRY_OK 0
+#define TELEMETRY_BAD_FRAME 1
+#define TELEMETRY_BAD_CRC 2
+
+typedef struct __attribute__((packed)) telemetry_header_t {
+  uint8_t type;
+  uint8_t sequence; // counts packets of this type, so gaps show what was lost
+} telemetry_header_t;
+
+// One snapshot of the flight, 34 bytes
+typedef struct __attribute__((packed)) telemetry_state_t {
+  uint32_t time;          // ms since boot
+  uint8_t phase;
+  int32_t altitude;       // cm above ground
+  int16_t velocity;       // dm/s, up
+  int16_t acceleration;   // cm/s^2, up
+  int16_t quaternion[4];  // w, x, y, z in 1/16384
+  int32_t latitude;       // 1e-7 degrees
+  int32_t longitude;      // 1e-7 degrees
+  int16_t gpsAltitude;    // m above sea level
+  uint8_t gpsQuality;
+  uint16_t battery;       // mV
+} telemetry_state_t;
+
+// Answer to an uplinked command
+typedef struct __attribute__((packed)) telemetry_ack_t {
+  uint8_t command; // the command's character
+  uint8_t status;  // COMMAND_ACK or COMMAND_ERR
+} telemetry_ack_t;
+
+// CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF
+static inline uint16_t telemetryCrc(const uint8_t *data, size_t length) {
+  uint16_t crc = 0xFFFF;
+
+  for(size_t i=0; i<length; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for(int bit=0; bit<8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+
+  return crc;
+}
+
+// Consistent overhead byte stuffing. Each zero is replaced by the distance to
+// the next one, with a leading code byte for the first. Encodes into at most
+// length + length / 254 + 1 bytes and returns how many.
+static inline size_t cobsEncode(const uint8_t *in, size_t length, uint8_t *out) {
+  size_t code = 0;
+  size_t o = 1;
+  uint8_t run = 1;
+
+  for(size_t i=0; i<length; i++) {
+    if(in[i] != 0) {
+      out[o++] = in[i];
+      run++;
+    }
+
+    if(in[i] == 0 || run == 0xFF) {
+      out[code] = run;
+      code = o++;
+      run = 1;
+    }
+  }
+
+  out[code] = run;
+  return o;
+}
+
+// Returns the decoded length, which is never more than the encoded one, or
+// -1 if the input can't be COBS
+static inline int cobsDecode(const uint8_t *in, size_t length, uint8_t *out) {
+  size_t i = 0;
+  size_t o = 0;
+
+  while(i < length) {
+    uint8_t code = in[i++];
+    if(code == 0 || i + code - 1 > length) return -1;
+
+    for(int j=1; j<code; j++) {
+      if(in[i] == 0) return -1;
+      out[o++] = in[i++];
+    }
+
+    if(code != 0xFF && i < length) out[o++] = 0;
+  }
+
+  return (int)o;
+}
+
+// Builds a packet into out, which must hold TELEMETRY_MAX_FRAME bytes, and
+// returns its length including the delimiter
+static inline size_t telemetryEncode(uint8_t type, uint8_t sequence, const void *payload, size_t length, uint8_t *out) {
+  uint8_t raw[TELEMETRY_MAX_FRAME];
+
+  if(length > TELEMETRY_MAX_PAYLOAD) length = TELEMETRY_MAX_PAYLOAD;
+
+  raw[0] = type;
+  raw[1] = sequence;
+  memcpy(raw + sizeof(telemetry_header_t), payload, length);
+  length += sizeof(telemetry_header_t);
+
+  uint16_t crc = telemetryCrc(raw, length);
+  raw[length++] = crc & 0xFF;
+  raw[length++] = crc >> 8;
+
+  size_t encoded = cobsEncode(raw, length, out);
+  out[encoded++] = 0;
+  return encoded;
+}
+
+// Decodes one packet without its delimiter. On success the header and
+// payload are in out, which must hold length bytes, and *payloadLength is
+// set.
+static inline int telemetryDecode(const uint8_t *frame, size_t length, uint8_t *out, size_t *payloadLength) {
+  int decoded = cobsDecode(frame, length, out);
+  if(decoded < (int)(sizeof(telemetry_header_t) + 2)) return TELEMETRY_BAD_FRAME;
+
+  decoded -= 2;
+  uint16_t crc = out[decoded] | (out[decoded + 1] << 8);
+  if(crc != telemetryCrc(out, decoded)) return TELEMETRY_BAD_CRC;
+
+  *payloadLength = decoded - sizeof(telemetry_header_t);
+  return TELEMETRY_OK;
+}
+
+#endif
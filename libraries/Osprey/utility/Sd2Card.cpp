@@ -46,6 +46,129 @@ static  uint8_t spiRec(void) {
   return SPI.transfer(0xFF);
 #endif
 }
+#ifdef USE_SAMD_DMA
+//------------------------------------------------------------------------------
+// DMA transfers for the SAMD21. Two channels run together for every transfer:
+// TX feeds the SERCOM data register and RX empties it, so the receiver never
+// overflows. The transfer is complete when RX has taken the last byte.
+/** DMA channel that writes the SPI data register */
+#define SD_DMA_TX_CHANNEL 0
+/** DMA channel that reads the SPI data register */
+#define SD_DMA_RX_CHANNEL 1
+/** SERCOM used by the SPI library */
+#define SD_DMA_SERCOM SERCOM4
+#define SD_DMA_TX_TRIGGER SERCOM4_DMAC_ID_TX
+#define SD_DMA_RX_TRIGGER SERCOM4_DMAC_ID_RX
+
+static DmacDescriptor dmaDescriptorTable[2] __attribute__((aligned(16)));
+static DmacDescriptor dmaWritebackTable[2] __attribute__((aligned(16)));
+/** Descriptor table in use, ours or that of whoever enabled the DMAC first */
+static DmacDescriptor* dmaDescriptor = dmaDescriptorTable;
+static volatile uint8_t dmaBusy = 0;
+static uint8_t dmaReady = 0;
+static uint8_t dmaFill = 0XFF;
+static uint8_t dmaDiscard;
+
+/** Configure one channel to move a byte per SERCOM trigger */
+static void dmaChannelInit(uint8_t channel, uint8_t trigger) {
+  DMAC->CHID.reg = DMAC_CHID_ID(channel);
+  DMAC->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+  while (DMAC->CHCTRLA.reg & DMAC_CHCTRLA_ENABLE)
+    ;
+  DMAC->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+  while (DMAC->CHCTRLA.reg & DMAC_CHCTRLA_SWRST)
+    ;
+  DMAC->SWTRIGCTRL.reg &= ~(1UL << channel);
+  DMAC->CHCTRLB.reg = DMAC_CHCTRLB_LVL(0)
+                      | DMAC_CHCTRLB_TRIGSRC(trigger)
+                      | DMAC_CHCTRLB_TRIGACT_BEAT;
+}
+/**
+ * Set up our channels the first time a transfer is made. The controller is
+ * only configured if nobody has enabled it yet. Otherwise its owner's
+ * descriptor tables are used, which must cover our channels, and nothing but
+ * our own channels is reset.
+ */
+static void dmaInit(void) {
+  PM->AHBMASK.reg |= PM_AHBMASK_DMAC;
+  PM->APBBMASK.reg |= PM_APBBMASK_DMAC;
+
+  if (DMAC->CTRL.bit.DMAENABLE) {
+    dmaDescriptor = (DmacDescriptor*)DMAC->BASEADDR.reg;
+  } else {
+    DMAC->BASEADDR.reg = (uint32_t)dmaDescriptorTable;
+    DMAC->WRBADDR.reg = (uint32_t)dmaWritebackTable;
+    DMAC->CTRL.reg = DMAC_CTRL_DMAENABLE | DMAC_CTRL_LVLEN(0XF);
+  }
+
+  dmaChannelInit(SD_DMA_TX_CHANNEL, SD_DMA_TX_TRIGGER);
+  dmaChannelInit(SD_DMA_RX_CHANNEL, SD_DMA_RX_TRIGGER);
+
+  NVIC_EnableIRQ(DMAC_IRQn);
+  dmaReady = 1;
+}
+/** Fill in the single descriptor used by a channel */
+static void dmaDescriptorInit(uint8_t channel, const volatile void* src,
+        uint8_t srcInc, volatile void* dst, uint8_t dstInc, uint16_t count) {
+  DmacDescriptor* d = &dmaDescriptor[channel];
+  d->BTCTRL.reg = DMAC_BTCTRL_VALID | DMAC_BTCTRL_BEATSIZE_BYTE
+                  | (srcInc ? DMAC_BTCTRL_SRCINC : 0)
+                  | (dstInc ? DMAC_BTCTRL_DSTINC : 0);
+  d->BTCNT.reg = count;
+  // incrementing addresses are given as the end of the block
+  d->SRCADDR.reg = (uint32_t)src + (srcInc ? count : 0);
+  d->DSTADDR.reg = (uint32_t)dst + (dstInc ? count : 0);
+  d->DESCADDR.reg = 0;
+}
+/**
+ * Start moving count bytes over SPI in the background. If src is null 0XFF is
+ * sent, if dst is null received bytes are discarded.
+ */
+static void spiDmaStart(const uint8_t* src, uint8_t* dst, uint16_t count) {
+  if (!dmaReady) dmaInit();
+  volatile void* data = &SD_DMA_SERCOM->SPI.DATA.reg;
+
+  dmaDescriptorInit(SD_DMA_TX_CHANNEL, src ? src : &dmaFill, src != 0,
+                    data, 0, count);
+  dmaDescriptorInit(SD_DMA_RX_CHANNEL, data, 0,
+                    dst ? dst : &dmaDiscard, dst != 0, count);
+  dmaBusy = 1;
+
+  // RX must be listening before TX produces the first byte
+  DMAC->CHID.reg = DMAC_CHID_ID(SD_DMA_RX_CHANNEL);
+  DMAC->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL;
+  DMAC->CHCTRLA.reg |= DMAC_CHCTRLA_ENABLE;
+  DMAC->CHID.reg = DMAC_CHID_ID(SD_DMA_TX_CHANNEL);
+  DMAC->CHCTRLA.reg |= DMAC_CHCTRLA_ENABLE;
+}
+/** Wait for the transfer started by spiDmaStart() */
+static void spiDmaWait(void) {
+  while (dmaBusy)
+    ;
+}
+/** Send a buffer to the card */
+static void spiSend(const uint8_t* buf, uint16_t count) {
+  spiDmaStart(buf, 0, count);
+  spiDmaWait();
+}
+/** Receive a buffer from the card */
+static void spiRec(uint8_t* buf, uint16_t count) {
+  spiDmaStart(0, buf, count);
+  spiDmaWait();
+}
+/** DMA transfer complete interrupt */
+void DMAC_Handler(void) {
+  uint8_t channel = DMAC->CHID.reg;
+
+  DMAC->CHID.reg = DMAC_CHID_ID(SD_DMA_RX_CHANNEL);
+  if (DMAC->CHINTFLAG.reg & DMAC_CHINTFLAG_TCMPL) {
+    DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
+    dmaBusy = 0;
+  }
+
+  DMAC->CHID.reg = channel;
+}
+#endif  // USE_SAMD_DMA
 #else  // SOFTWARE_SPI
 //------------------------------------------------------------------------------
 /** nop to tune soft SPI timing */
@@ -426,9 +549,13 @@ uint8_t Sd2Card::readData(uint32_t block,
     spiRec();
   }
   // transfer data
+#ifdef USE_SAMD_DMA
+  spiRec(dst, count);
+#else  // USE_SAMD_DMA
   for (uint16_t i = 0; i < count; i++) {
     dst[i] = spiRec();
   }
+#endif  // USE_SAMD_DMA
 #endif  // OPTIMIZE_HARDWARE_SPI
 
   offset_ += count;
@@ -602,13 +729,65 @@ uint8_t Sd2Card::writeBlock(uint32_t blockNumber, const uint8_t* src) {
 //------------------------------------------------------------------------------
 /** Write one data block in a multiple block write sequence */
 uint8_t Sd2Card::writeData(const uint8_t* src) {
+  return writeDataStart(src) && writeDataFinish();
+}
+//------------------------------------------------------------------------------
+/**
+ * Start writing one data block in a multiple block write sequence.
+ *
+ * With USE_SAMD_DMA the block is sent in the background and this returns as
+ * soon as the transfer has started. \a src must not change until
+ * writeDataFinish() has been called, and nothing else may use the card or the
+ * SPI bus in between. Without DMA the block is sent before returning.
+ *
+ * \param[in] src Pointer to the location of the data to be written.
+ * \return The value one, true, is returned for success and
+ * the value zero, false, is returned for failure.
+ */
+uint8_t Sd2Card::writeDataStart(const uint8_t* src) {
+  if (writePending_ && !writeDataFinish()) return false;
+
   // wait for previous write to finish
   if (!waitNotBusy(SD_WRITE_TIMEOUT)) {
     error(SD_CARD_ERROR_WRITE_MULTIPLE);
     chipSelectHigh();
     return false;
   }
-  return writeData(WRITE_MULTIPLE_TOKEN, src);
+#ifdef USE_SAMD_DMA
+  spiSend(WRITE_MULTIPLE_TOKEN);
+  spiDmaStart(src, 0, 512);
+#else  // USE_SAMD_DMA
+  spiSend(WRITE_MULTIPLE_TOKEN);
+  for (uint16_t i = 0; i < 512; i++) {
+    spiSend(src[i]);
+  }
+#endif  // USE_SAMD_DMA
+  writePending_ = 1;
+  return true;
+}
+//------------------------------------------------------------------------------
+/**
+ * Complete a block started by writeDataStart(), waiting for the transfer if
+ * it is still running, and check that the card accepted it.
+ *
+ * \return The value one, true, is returned for success and
+ * the value zero, false, is returned for failure.
+ */
+uint8_t Sd2Card::writeDataFinish(void) {
+  if (!writePending_) return true;
+#ifdef USE_SAMD_DMA
+  spiDmaWait();
+#endif  // USE_SAMD_DMA
+  writePending_ = 0;
+  return writeDataResponse();
+}
+//------------------------------------------------------------------------------
+uint8_t Sd2Card::writeDataBusy(void) const {
+#ifdef USE_SAMD_DMA
+  return writePending_ && dmaBusy;
+#else  // USE_SAMD_DMA
+  return false;
+#endif  // USE_SAMD_DMA
 }
 //------------------------------------------------------------------------------
 // send one block of data for write block or write multiple blocks
@@ -634,10 +813,19 @@ uint8_t Sd2Card::writeData(uint8_t token, const uint8_t* src) {
 
 #else  // OPTIMIZE_HARDWARE_SPI
   spiSend(token);
+#ifdef USE_SAMD_DMA
+  spiSend(src, 512);
+#else  // USE_SAMD_DMA
   for (uint16_t i = 0; i < 512; i++) {
     spiSend(src[i]);
   }
+#endif  // USE_SAMD_DMA
 #endif  // OPTIMIZE_HARDWARE_SPI
+  return writeDataResponse();
+}
+//------------------------------------------------------------------------------
+// send the crc and check the data response token after a block of data
+uint8_t Sd2Card::writeDataResponse(void) {
   spiSend(0xff);  // dummy crc
   spiSend(0xff);  // dummy crc
 
@@ -693,6 +881,7 @@ uint8_t Sd2Card::writeStart(uint32_t blockNumber, uint32_t eraseCount) {
  * the value zero, false, is returned for failure.
  */
 uint8_t Sd2Card::writeStop(void) {
+  if (writePending_ && !writeDataFinish()) goto fail;
   if (!waitNotBusy(SD_WRITE_TIMEOUT)) goto fail;
   spiSend(STOP_TRAN_TOKEN);
   if (!waitNotBusy(SD_WRITE_TIMEOUT)) goto fail;
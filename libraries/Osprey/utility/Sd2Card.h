@@ -45,6 +45,15 @@ uint8_t const SPI_QUARTER_SPEED = 2;
  * but many SD cards will fail with GPS Shield V1.0.
  */
 #define MEGA_SOFT_SPI 0
+/**
+ * USE_SAMD_DMA: if set, block data is moved between memory and the SPI
+ * SERCOM by the SAMD21 DMA controller instead of one SPI.transfer() per byte.
+ * This also allows multiple block writes to run in the background, see
+ * Sd2Card::writeDataStart().
+ */
+#if defined(__SAMD21G18A__) && defined(USE_SPI_LIB)
+#define USE_SAMD_DMA
+#endif
 //------------------------------------------------------------------------------
 #if MEGA_SOFT_SPI && (defined(__AVR_ATmega1280__)||defined(__AVR_ATmega2560__))
 #define SOFTWARE_SPI
@@ -159,7 +168,8 @@ uint8_t const SD_CARD_TYPE_SDHC = 3;
 class Sd2Card {
  public:
   /** Construct an instance of Sd2Card. */
-  Sd2Card(void) : errorCode_(0), inBlock_(0), partialBlockRead_(0), type_(0) {}
+  Sd2Card(void) : errorCode_(0), inBlock_(0), partialBlockRead_(0), type_(0),
+    writePending_(0) {}
   uint32_t cardSize(void);
   uint8_t erase(uint32_t firstBlock, uint32_t lastBlock);
   uint8_t eraseSingleBlockEnable(void);
@@ -210,6 +220,12 @@ class Sd2Card {
   uint8_t type(void) const {return type_;}
   uint8_t writeBlock(uint32_t blockNumber, const uint8_t* src);
   uint8_t writeData(const uint8_t* src);
+  uint8_t writeDataStart(const uint8_t* src);
+  uint8_t writeDataFinish(void);
+  /** \return true if a block started by writeDataStart() is still moving. */
+  uint8_t writeDataBusy(void) const;
+  /** \return true if writeDataFinish() must be called before anything else. */
+  uint8_t writePending(void) const {return writePending_;}
   uint8_t writeStart(uint32_t blockNumber, uint32_t eraseCount);
   uint8_t writeStop(void);
  private:
@@ -221,6 +237,7 @@ class Sd2Card {
   uint8_t partialBlockRead_;
   uint8_t status_;
   uint8_t type_;
+  uint8_t writePending_;
   // private functions
   uint8_t cardAcmd(uint8_t cmd, uint32_t arg) {
     cardCommand(CMD55, 0);
@@ -235,6 +252,7 @@ class Sd2Card {
   void type(uint8_t value) {type_ = value;}
   uint8_t waitNotBusy(uint16_t timeoutMillis);
   uint8_t writeData(uint8_t token, const uint8_t* src);
+  uint8_t writeDataResponse(void);
   uint8_t waitStartBlock(void);
 };
 #endif  // Sd2Card_h
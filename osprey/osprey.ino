@@ -1,57 +1,43 @@
 #include <Wire.h>
 #include <accelerometer.h>
+#include <attitude.h>
 #include <barometer.h>
 #include <battery.h>
 #include <clock.h>
 #include <constants.h>
+#include <estimator.h>
 #include <event.h>
 #include <logger.h>
 #include <gps.h>
+#include <predictor.h>
 #include <radio.h>
+#include <scheduler.h>
 
 #include <SPI.h>
 #include <SD.h>
 
-#define chipSelect 4
-#define FILENAME_FORMAT "%d.log"
-
-char filename[20];
-
-float initAlt = -1;
-
-void blowUp(const char* const message) {
-  while(1) {
-    Serial.println(message);
-    Serial.println("Check your connections and reset the board");
-    Serial.println("\r\n");
-    delay(1000);
-  }
-}
-
-void initSD() {
-  Serial.print("Initializing SD card...");
-
-  // see if the card is present and can be initialized:
-  if (!SD.begin(chipSelect)) {
-    blowUp("Card failed, or not present");
-    // don't do anything more:
-    return;
-  }
-
-  int logNumber = 0;
-  // Find the first unused log number
-  do {
-    sprintf(filename, FILENAME_FORMAT, logNumber);
-    logNumber++;
-  } while(SD.exists(filename));
-
-  
-  Serial.println("card initialized.");
-}
-
-#define chipSelect = 4;
 #define HEARTBEAT_LED 8
-#define HEARTBEAT_INTERVAL 25
+#define HEARTBEAT_INTERVAL 25 // ms the LED stays lit each beat
+
+// Task periods
+#define FRAME_PERIOD 10000UL     // us, 100 Hz, just over one baro conversion
+#define JSON_PERIOD 50000UL      // us, 20 Hz
+#define GPS_PERIOD 100000UL      // us, 10 Hz
+#define EVENT_PERIOD 50000UL     // us, 20 Hz
+#define DEPLOY_PERIOD 10000UL    // us, 100 Hz
+#define BRAKE_PERIOD 20000UL     // us, 50 Hz
+#define RADIO_PERIOD 10000UL     // us, 100 Hz
+#define TELEMETRY_PERIOD 50000UL // us, 20 Hz
+#define BATTERY_PERIOD 1000000UL // us, 1 Hz
+#define FLUSH_PERIOD 1000000UL   // us, 1 Hz
+#define HEARTBEAT_PERIOD 25000UL // us
+#define REPORT_PERIOD 5000000UL  // us
+
+#define DEPLOY_DURATION 1500 // ms the deploy pin is held high
+
+// Set to 1 to log human readable JSON instead of binary records (see record.h).
+// The log still starts with the binary log header either way.
+#define LOG_JSON 0
 
 namespace Osprey {
   Accelerometer accelerometer;
@@ -60,14 +46,33 @@ namespace Osprey {
   Event event;
   Osprey::Clock clock;
   GPS gps;
+  Logger logger;
   Radio radio;
+  Scheduler scheduler;
+  SensorFrame frame;
+  telemetry_state_t telemetry;
+  AltitudeEstimator estimator;
+  ApogeePredictor predictor;
 
   extern int commandStatus;
   int counter;
 
   void printJSON();
+  void sampleSensors();
+  void logFrame();
+  void sampleGps();
+  void checkEvents();
+  void updateDeploy();
+  void updateBrakes();
+  void updateRadio();
+  void sendTelemetry();
+  void sampleBattery();
+  void flushLog();
   void heartbeat();
+  void reportTasks();
+  void initTasks();
   void initSensors();
+  void initLogger();
   void printInitError(const char* const message);
   extern void processCommand();
 }
@@ -77,6 +82,8 @@ using namespace Osprey;
 unsigned long start;
 unsigned long brakeStart;
 bool deployed;
+bool deployActive;
+float padAltitude;
 
 #define DEPLOY_TIME_MILLIS 120000
 
@@ -86,72 +93,264 @@ void setup(void) {
   pinMode(HEARTBEAT_LED, OUTPUT);
   pinMode(13, OUTPUT);
   digitalWrite(13, LOW);
-  initSD();
+  initLogger();
   initSensors();
   deployed = false;
+  deployActive = false;
+  padAltitude = 0;
+  initTasks();
 }
 
 void deploy()
 {
   Serial.println("Deploying!");
   digitalWrite(13,HIGH);
-  delay(1500);
-  digitalWrite(13,LOW);
+  deployActive = true;
+  brakeStart = millis();
+}
+
+void loop(void) {
+  scheduler.run();
+}
+
+void Osprey::initTasks() {
+  // Registration order is priority order
+  scheduler.add("sensors", sampleSensors, FRAME_PERIOD);
+#if LOG_JSON
+  scheduler.add("json", printJSON, JSON_PERIOD);
+#endif
+  scheduler.add("deploy", updateDeploy, DEPLOY_PERIOD);
+  scheduler.add("brakes", updateBrakes, BRAKE_PERIOD);
+  scheduler.add("event", checkEvents, EVENT_PERIOD);
+  scheduler.add("gps", sampleGps, GPS_PERIOD);
+  scheduler.add("radio", updateRadio, RADIO_PERIOD);
+  scheduler.add("telemetry", sendTelemetry, TELEMETRY_PERIOD);
+  scheduler.add("battery", sampleBattery, BATTERY_PERIOD);
+  scheduler.add("flush", flushLog, FLUSH_PERIOD);
+  scheduler.add("heartbeat", heartbeat, HEARTBEAT_PERIOD);
+  scheduler.add("report", reportTasks, REPORT_PERIOD);
+
+  // The radio's bytes go in and out of the UART on every tick
+  Scheduler::setTickCallback(Radio::poll);
+
+  scheduler.init();
+}
+
+void Osprey::sampleSensors() {
+  // Every sensor is read once into the frame and everything else uses that
+  frame.timestamp = micros();
+  frame.fresh = 0;
+  accelerometer.sample(&frame);
+  barometer.sample(&frame);
+  estimator.update(&frame);
+
+#if !LOG_JSON
+  logFrame();
+#endif
+}
+
+void Osprey::logFrame() {
+  if(frame.fresh & FRAME_IMU) {
+    imu_record_t imu;
+    imu.accelerationX = frame.acceleration[0] * 100;
+    imu.accelerationY = frame.acceleration[1] * 100;
+    imu.accelerationZ = frame.acceleration[2] * 100;
+    imu.quaternionW = frame.quaternion[0] * RECORD_QUATERNION_SCALE;
+    imu.quaternionX = frame.quaternion[1] * RECORD_QUATERNION_SCALE;
+    imu.quaternionY = frame.quaternion[2] * RECORD_QUATERNION_SCALE;
+    imu.quaternionZ = frame.quaternion[3] * RECORD_QUATERNION_SCALE;
+    logger.log(RECORD_IMU, &imu, sizeof(imu));
+  }
+
+  if(frame.fresh & FRAME_BARO) {
+    baro_record_t baro;
+    baro.pressure = frame.pressure;
+    baro.temperature = frame.temperature * 100;
+    baro.altitude = frame.altitude * 100;
+    logger.log(RECORD_BARO, &baro, sizeof(baro));
+  }
+}
+
+void Osprey::sampleGps() {
+  // The interrupt only buffers the receiver's bytes, they're parsed here
+  gps.update();
+
+  gps_record_t fix;
+  // The parser's 1e-7 degrees go straight through, as a float would round
+  // them to about a third of a metre
+  fix.latitude = gps.getLatitude();
+  fix.longitude = gps.getLongitude();
+  fix.altitude = gps.getAltitude() * 100;
+  fix.speed = gps.getSpeed() * 100;
+  fix.quality = gps.getQuality();
+  logger.log(RECORD_GPS, &fix, sizeof(fix));
+
+  // The getters filter as they go, so telemetry reuses this fix rather than
+  // asking again
+  telemetry.latitude = fix.latitude;
+  telemetry.longitude = fix.longitude;
+  telemetry.gpsAltitude = fix.altitude / 100;
+  telemetry.gpsQuality = fix.quality;
+}
+
+void Osprey::sampleBattery() {
+  telemetry.battery = battery.getVoltage() * 1000;
+}
+
+void Osprey::checkEvents() {
+  event.check(frame);
+}
+
+void Osprey::updateRadio() {
+  // Every line that has arrived, up to a limit so a flood of them can't hold
+  // up the other tasks
+  for(int i=0; i<RADIO_MAX_LINES && *radio.recv() != '\0'; i++) {
+    processCommand();
+  }
+}
+
+// Clamped so that an out of range value reads as the limit rather than wrapping
+static int16_t saturate16(float value) {
+  if(value > INT16_MAX) return INT16_MAX;
+  if(value < INT16_MIN) return INT16_MIN;
+  return value;
+}
+
+void Osprey::sendTelemetry() {
+  telemetry.time = millis();
+  telemetry.phase = event.getPhase();
+  telemetry.altitude = frame.estimatedAltitude * 100;
+  telemetry.velocity = saturate16(frame.velocity * 10);
+  telemetry.acceleration = saturate16(frame.estimatedAcceleration * 100);
+  for(int i=0; i<4; i++) {
+    telemetry.quaternion[i] = frame.quaternion[i] * TELEMETRY_QUATERNION_SCALE;
+  }
+
+  radio.sendPacket(TELEMETRY_STATE, &telemetry, sizeof(telemetry));
+}
+
+void Osprey::flushLog() {
+  logger.flush();
 }
 
-void loop(void) {  
-  printJSON();
-  heartbeat();
+// Two decimals, as Print::println(float) would, but without its soft double
+// arithmetic
+static void logValue(float value) {
+  char buffer[FORMAT_FIXED_LENGTH];
+  formatFixed(value, 2, buffer);
+  logger.println(buffer);
 }
 
 void Osprey::printJSON() {
-  File dataFile = SD.open(filename, FILE_WRITE);
   // The JSON structure is simple enough. Rather than bringing in another
   // library to do a bunch of heavylifting, just construct the string manually.
-  dataFile.println("{");
+  logger.println("{");
 
-  dataFile.println("\"roll\": ");
-  dataFile.println(accelerometer.getRoll());
+  logger.println("\"roll\": ");
+  logValue(attitudeRoll(&frame));
 
-  dataFile.println(", \"pitch\": ");
-  dataFile.println(accelerometer.getPitch());
+  logger.println(", \"pitch\": ");
+  logValue(attitudePitch(&frame));
 
-  dataFile.println(", \"heading\": ");
-  dataFile.println(accelerometer.getHeading());
+  logger.println(", \"heading\": ");
+  logValue(attitudeHeading(&frame));
 
-  dataFile.println(", \"acceleration magnitude (g)\": ");
-  dataFile.println(accelerometer.getAccelerationG());
+  logger.println(", \"tilt\": ");
+  logValue(attitudeTilt(&frame));
 
-  dataFile.println(", \"pressure_altitude\": ");
-  dataFile.println(barometer.getAltitudeAboveSeaLevel());
+  logger.println(", \"acceleration magnitude (g)\": ");
+  logValue(frame.accelerationG);
 
-  dataFile.println(", \"temp\": ");
-  dataFile.println(barometer.getTemperatureC());
-  dataFile.println(", \"time\": ");
-  dataFile.println(Osprey::clock.getSeconds());
-  dataFile.println(", \"agl\": ");
-  float alt = barometer.getAltitudeAboveGround();
-  if (initAlt == -1)
-  {
-    initAlt = alt;
+  logger.println(", \"pressure_altitude\": ");
+  logValue(barometer.getAltitudeAboveSeaLevel());
+
+  logger.println(", \"temp\": ");
+  logValue(frame.temperature);
+  logger.println(", \"time\": ");
+  logger.println(Osprey::clock.getSeconds());
+  logger.println(", \"agl\": ");
+  logValue(frame.estimatedAltitude);
+
+  logger.println(", \"velocity\": ");
+  logValue(frame.velocity);
+  logger.println("}");
+  logger.println("\r\n");
+}
+
+void Osprey::updateBrakes() {
+  int phase = event.getPhase();
+
+  // Altitudes are relative to the pad whether or not the sensors were zeroed
+  if(phase == PAD) {
+    padAltitude = frame.estimatedAltitude;
+    predictor.setGroundLevel(padAltitude + barometer.getGroundLevel());
+    return;
   }
-  if (!deployed && alt-initAlt>=1000)
-  {
-    delay(600);
-    deploy();
+
+  // Only while coasting up with the brakes still closed
+  if(deployed || phase != COAST) return;
+
+  float altitude = frame.estimatedAltitude - padAltitude;
+  predictor.calibrate(altitude, frame.velocity, frame.estimatedAcceleration, BAL_COEFF_CLOSED);
+
+  // Open the brakes as soon as doing so still gets to the target. Any later
+  // and the apogee with them open only climbs further past it.
+  if(predictor.predict(altitude, frame.velocity, BAL_COEFF_OPEN) &&
+     predictor.getApogee() >= h_TARGET) {
     deployed = true;
+    deploy();
+  }
+}
+
+void Osprey::updateDeploy() {
+  // Ends the igniter pulses
+  event.update();
+
+  if(deployActive && millis() - brakeStart >= DEPLOY_DURATION) {
+    deployActive = false;
+    digitalWrite(13,LOW);
   }
-  dataFile.println(alt);
-  dataFile.println("}");
-  dataFile.println("\r\n");
-  dataFile.close();
 }
 
 void Osprey::heartbeat() {
-//  Serial.println("oiiiiiiiii");
-  digitalWrite(HEARTBEAT_LED, HIGH);
-  delay(HEARTBEAT_INTERVAL);
-  digitalWrite(HEARTBEAT_LED, LOW);
+  // Lit for HEARTBEAT_INTERVAL out of every second
+  digitalWrite(HEARTBEAT_LED, (millis() % 1000 < HEARTBEAT_INTERVAL ? HIGH : LOW));
+}
+
+void Osprey::reportTasks() {
+  for(int i=0; i<scheduler.numTasks(); i++) {
+    const task_t *task = scheduler.getTask(i);
+
+    Serial.print(task->name);
+    Serial.print(": runs=");
+    Serial.print(task->runs);
+    Serial.print(" overruns=");
+    Serial.print(task->overruns);
+    Serial.print(" missed=");
+    Serial.print(task->missed);
+    Serial.print(" jitter(avg/max us)=");
+    Serial.print(task->runs > 0 ? task->totalJitter / task->runs : 0);
+    Serial.print("/");
+    Serial.print(task->maxJitter);
+    Serial.print(" duration(max us)=");
+    Serial.println(task->maxDuration);
+  }
+
+  Serial.print("radio: queued=");
+  Serial.print(Radio::getTxQueued());
+  Serial.print(" dropped(tx/rx)=");
+  Serial.print(Radio::getTxDropped());
+  Serial.print("/");
+  Serial.print(Radio::getRxDropped());
+  Serial.print(" rejected=");
+  Serial.println(Radio::getTxRejected());
+
+  Serial.print("nmea: sentences=");
+  Serial.print(gps.getSentences());
+  Serial.print(" errors=");
+  Serial.print(gps.getErrors());
+  Serial.print(" dropped=");
+  Serial.println(GPS::getDropped());
 }
 
 void Osprey::initSensors() {
@@ -165,7 +364,32 @@ void Osprey::initSensors() {
   if(!Osprey::clock.init()) {
     printInitError("Failed to intialize clock");
   }
+  if(!gps.init()) {
+    printInitError("Failed to intialize GPS");
+  }
+  if(!radio.init()) {
+    printInitError("Failed to intialize radio");
+  }
+  if(!event.init()) {
+    printInitError("Failed to intialize events");
+  }
+
+}
 
+void Osprey::initLogger() {
+  Serial.print("Initializing SD card...");
+  logger.init();
+
+  // The log file is pre-allocated, erased and then streamed to without
+  // touching the FAT. The erase is slow, so it's done here before the tasks
+  // start. The log is opened when the igniters are armed and closed at the
+  // end of the flight.
+  logger.setMode(LOGGER_MODE_RECORDER);
+  if(!logger.prepare()) {
+    Serial.print("failed to prepare the log file...");
+  }
+
+  Serial.println("card initialized.");
 }
 
 void Osprey::printInitError(const char* const message) {
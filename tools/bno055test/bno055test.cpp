@@ -0,0 +1,140 @@
+// Host test for the BNO055 burst read decode (see Adafruit_BNO055::decodeMotionData)
+//
+// Build: g++ -O2 -DARDUINO=10810 -Itools/sitl/hal -Ilibraries/Adafruit_BNO055 -o bno055test tools/bno055test/bno055test.cpp libraries/Adafruit_BNO055/Adafruit_BNO055.cpp tools/sitl/hal/hal.cpp
+// Usage: bno055test
+//
+// Feeds the 45 bytes readAllMotionData reads, from the accelerometer's X LSB
+// at 0x08 to the temperature at 0x34, through decodeMotionData and checks
+// every field against values worked out by hand from the datasheet's units
+// (section 3.6.4): 100 LSB per m/s^2, 16 LSB per uT, degree/s and degree,
+// 2^14 LSB per quaternion unit and 1 LSB per degree C.
+//
+// The dumps are on the pad as the simulator's BNO055 writes its registers,
+// in the middle of a boost with every field signed and off the axes, and
+// every field at the ends of its int16 (or int8) range. Exits non-zero if any
+// field is wrong.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "Adafruit_BNO055.h"
+#include "../check.h"
+
+#define TOLERANCE 1e-9
+
+typedef struct {
+  const char *name;
+  uint8_t registers[BNO055_MOTION_DATA_LEN];
+  double accel[3];       // m/s^2
+  int16_t accelRaw[3];
+  double mag[3];         // uT
+  double gyro[3];        // degrees/s
+  double euler[3];       // degrees
+  double quat[4];        // w, x, y, z
+  double linearAccel[3]; // m/s^2
+  double gravity[3];     // m/s^2
+  int temp;              // degrees C
+} dump_t;
+
+static const dump_t dumps[] = {
+  {
+    // At rest, x axis up, a quarter turn nose up about y
+    "pad",
+    { 0xD5, 0x03, 0x00, 0x00, 0x00, 0x00, 0x80, 0xFD, 0x00, 0x00, 0x40, 0x01,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xA0, 0x05,
+      0x41, 0x2D, 0x00, 0x00, 0x41, 0x2D, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0xD5, 0x03, 0x00, 0x00, 0x00, 0x00, 0x19 },
+    { 9.81, 0, 0 }, { 981, 0, 0 },
+    { -40, 0, 20 },
+    { 0, 0, 0 },
+    { 0, 0, 90 },
+    { 0.70709228515625, 0, 0.70709228515625, 0 },
+    { 0, 0, 0 },
+    { 9.81, 0, 0 },
+    25
+  },
+  {
+    // Burning at 16 g, rolling, in the cold
+    "boost",
+    { 0x4B, 0x3D, 0x06, 0xFF, 0x21, 0x00, 0xC8, 0x00, 0xEF, 0xFD, 0x00, 0x03,
+      0x58, 0xF0, 0xD4, 0x07, 0x00, 0x7D, 0x7F, 0x16, 0xC8, 0xF4, 0x61, 0xFA,
+      0x00, 0x20, 0x00, 0xE0, 0x00, 0x20, 0x00, 0xE0, 0x76, 0x39, 0x06, 0xFF,
+      0x21, 0x00, 0xD5, 0x03, 0x00, 0x00, 0x00, 0x00, 0xF4 },
+    { 156.91, -2.5, 0.33 }, { 15691, -250, 33 },
+    { 12.5, -33.0625, 48 },
+    { -250.5, 125.25, 2000 },
+    { 359.9375, -179.5, -89.9375 },
+    { 0.5, -0.5, 0.5, -0.5 },
+    { 147.1, -2.5, 0.33 },
+    { 9.81, 0, 0 },
+    -12
+  },
+  {
+    // Every register at the ends of its range, and -1 and 1
+    "extremes",
+    { 0xFF, 0x7F, 0x00, 0x80, 0xFF, 0xFF, 0x00, 0x80, 0xFF, 0x7F, 0x01, 0x00,
+      0xFF, 0x7F, 0x00, 0x80, 0xFF, 0xFF, 0x00, 0x80, 0xFF, 0x7F, 0xF0, 0xFF,
+      0xFF, 0x7F, 0x00, 0x80, 0x01, 0x00, 0xFF, 0xFF, 0x00, 0x80, 0xFF, 0x7F,
+      0x64, 0x00, 0x01, 0x00, 0xFF, 0xFF, 0x00, 0x80, 0x80 },
+    { 327.67, -327.68, -0.01 }, { 32767, -32768, -1 },
+    { -2048, 2047.9375, 0.0625 },
+    { 2047.9375, -2048, -0.0625 },
+    { -2048, 2047.9375, -1 },
+    { 1.99993896484375, -2, 0.00006103515625, -0.00006103515625 },
+    { -327.68, 327.67, 1 },
+    { 0.01, -0.01, -327.68 },
+    -128
+  }
+};
+
+static void checkField(const char *dump, const char *field, int axis, double got, double expected) {
+  if(fabs(got - expected) <= TOLERANCE) return;
+  printf("bno055test: %s %s[%d] is %.10g, expected %.10g\n", dump, field, axis, got, expected);
+  failures++;
+}
+
+static void checkVector(const char *dump, const char *field, const imu::Vector<3> &got, const double *expected) {
+  for(int i=0; i<3; i++) {
+    checkField(dump, field, i, got[i], expected[i]);
+  }
+}
+
+int main(int argc, char **argv) {
+  if(argc > 1) {
+    fprintf(stderr, "usage: bno055test\n");
+    return 2;
+  }
+
+  // The offsets the decode uses, which the dumps above are laid out by
+  if(BNO055_MOTION_DATA_LEN != Adafruit_BNO055::BNO055_TEMP_ADDR - Adafruit_BNO055::BNO055_ACCEL_DATA_X_LSB_ADDR + 1) {
+    printf("bno055test: BNO055_MOTION_DATA_LEN doesn't span the accelerometer to the temperature\n");
+    failures++;
+  }
+
+  for(unsigned d=0; d<sizeof(dumps) / sizeof(dumps[0]); d++) {
+    const dump_t &dump = dumps[d];
+    Adafruit_BNO055::adafruit_bno055_motion_t motion;
+    Adafruit_BNO055::decodeMotionData(dump.registers, &motion);
+    int before = failures;
+
+    checkVector(dump.name, "accel", motion.accel, dump.accel);
+    for(int i=0; i<3; i++) {
+      checkField(dump.name, "accelRaw", i, motion.accelRaw[i], dump.accelRaw[i]);
+    }
+    checkVector(dump.name, "mag", motion.mag, dump.mag);
+    checkVector(dump.name, "gyro", motion.gyro, dump.gyro);
+    checkVector(dump.name, "euler", motion.euler, dump.euler);
+    checkField(dump.name, "quat", 0, motion.quat.w(), dump.quat[0]);
+    checkField(dump.name, "quat", 1, motion.quat.x(), dump.quat[1]);
+    checkField(dump.name, "quat", 2, motion.quat.y(), dump.quat[2]);
+    checkField(dump.name, "quat", 3, motion.quat.z(), dump.quat[3]);
+    checkVector(dump.name, "linearAccel", motion.linearAccel, dump.linearAccel);
+    checkVector(dump.name, "gravity", motion.gravity, dump.gravity);
+    checkField(dump.name, "temp", 0, motion.temp, dump.temp);
+
+    printf("%s %s\n", failures == before ? "ok  " : "FAIL", dump.name);
+  }
+
+  return checkResult("bno055test");
+}
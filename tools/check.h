@@ -0,0 +1,27 @@
+#ifndef TOOLS_CHECK_H
+#define TOOLS_CHECK_H
+
+// Pass and fail reporting for the host tests under tools/. Each check prints
+// "ok  " or "FAIL" and what it checked, and checkResult gives the exit status.
+// Every test is a single translation unit, so the count lives here.
+
+#include <stdio.h>
+
+static int failures = 0;
+
+static inline void check(bool ok, const char *what) {
+  printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+  if(!ok) failures++;
+}
+
+// 1 with the count on stderr if anything failed, otherwise 0
+static inline int checkResult(const char *tool) {
+  if(failures) {
+    fprintf(stderr, "%s: %d failed\n", tool, failures);
+    return 1;
+  }
+
+  return 0;
+}
+
+#endif
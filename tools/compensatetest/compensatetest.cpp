@@ -0,0 +1,220 @@
+// Host test and benchmark for the barometer's integer compensation (see MS5xxx::Compensate)
+//
+// Build: g++ -O2 -DARDUINO=10810 -Itools/sitl/hal -Ilibraries/MS5xxx -o compensatetest tools/compensatetest/compensatetest.cpp libraries/MS5xxx/MS5xxx.cpp tools/sitl/hal/hal.cpp
+// Usage: compensatetest [-s STRIDE]
+//
+// Checks MS5xxx::Compensate against the datasheet's worked example and then
+// bit for bit against the datasheet formulas, written out separately below
+// with every 2^n as a power of two in 64 bit integers, over the whole 24 bit
+// D1 and D2 range: every STRIDE'th D2 (default 61) against a spread of D1s,
+// for the datasheet's calibration and a few either side of it.
+//
+// The old double precision Readout, with its pow() calls, doesn't truncate
+// between steps, so it is compared too but only to report how far apart the
+// two are. Finally both are timed. Host time is no measure of the M0's, where
+// the double path is all soft float, but shows the ratio.
+//
+// Exits non-zero if any result differs from the datasheet formulas.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "MS5xxx.h"
+
+#define DEFAULT_STRIDE 61
+#define D1_SAMPLES 64
+#define ADC_MAX 0xFFFFFF
+#define BENCH_CALLS 2000000
+
+// The sensor's operating range
+#define RANGE_MIN_P 1000      // Pa
+#define RANGE_MAX_P 120000    // Pa
+#define RANGE_MIN_TEMP -4000  // 0.01 degrees C
+#define RANGE_MAX_TEMP 8500   // 0.01 degrees C
+
+// The datasheet's example calibration and readings
+static const MS5xxx_Calibration DATASHEET = { 46372, 43981, 29059, 27842, 31553, 28165 };
+#define DATASHEET_D1 6465444
+#define DATASHEET_D2 8077636
+#define DATASHEET_P 110002 // Pa
+#define DATASHEET_TEMP 2000 // 0.01 degrees C
+
+// MS5607 datasheet, first and second order, as written there
+static void reference(const MS5xxx_Calibration &c, uint32_t D1, uint32_t D2, int32_t *P, int32_t *T) {
+  int64_t dT = (int64_t)D2 - (int64_t)c.T_REF * 256;
+  int64_t TEMP = 2000 + ((dT * c.TEMPSENS) >> 23);
+  int64_t OFF = (int64_t)c.OFF_T1 * 131072 + ((c.TCO * dT) >> 6);
+  int64_t SENS = (int64_t)c.SENS_T1 * 65536 + ((c.TCS * dT) >> 7);
+
+  int64_t T2 = 0, OFF2 = 0, SENS2 = 0;
+  if(TEMP < 2000) {
+    T2 = (dT * dT) >> 31;
+    OFF2 = 61 * (TEMP - 2000) * (TEMP - 2000) / 16;
+    SENS2 = 2 * (TEMP - 2000) * (TEMP - 2000);
+    if(TEMP < -1500) {
+      OFF2 += 15 * (TEMP + 1500) * (TEMP + 1500);
+      SENS2 += 8 * (TEMP + 1500) * (TEMP + 1500);
+    }
+  }
+
+  TEMP -= T2;
+  OFF -= OFF2;
+  SENS -= SENS2;
+
+  *T = TEMP;
+  *P = (((int64_t)D1 * SENS >> 21) - OFF) >> 15;
+}
+
+// The double precision Readout this replaced
+static void readoutDouble(const MS5xxx_Calibration &c, uint32_t D1, uint32_t D2, double *P, double *T) {
+  double dT = D2 - c.T_REF * pow(2, 8);
+  double OFF = c.OFF_T1 * pow(2, 17) + dT * c.TCO / pow(2, 6);
+  double SENS = c.SENS_T1 * pow(2, 16) + dT * c.TCS / pow(2, 7);
+  double TEMP = 2000 + (dT * c.TEMPSENS) / pow(2, 23);
+
+  double T2 = 0., OFF2 = 0., SENS2 = 0.;
+  if(TEMP < 2000) {
+    T2 = dT * dT / pow(2, 31);
+    OFF2 = 61 * (TEMP - 2000) * (TEMP - 2000) / pow(2, 4);
+    SENS2 = 2 * (TEMP - 2000) * (TEMP - 2000);
+    if(TEMP < -1500) {
+      OFF2 += 15 * (TEMP + 1500) * (TEMP + 1500);
+      SENS2 += 8 * (TEMP + 1500) * (TEMP + 1500);
+    }
+  }
+
+  TEMP -= T2;
+  OFF -= OFF2;
+  SENS -= SENS2;
+
+  *T = TEMP;
+  *P = ((D1 * SENS) / pow(2, 21) - OFF) / pow(2, 15);
+}
+
+static MS5xxx_Calibration scaled(const MS5xxx_Calibration &c, double scale) {
+  MS5xxx_Calibration result;
+  result.SENS_T1 = c.SENS_T1 * scale;
+  result.OFF_T1 = c.OFF_T1 * scale;
+  result.TCS = c.TCS * scale;
+  result.TCO = c.TCO * scale;
+  result.T_REF = c.T_REF * scale;
+  result.TEMPSENS = c.TEMPSENS * scale;
+  return result;
+}
+
+static double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void usage() {
+  fprintf(stderr, "usage: compensatetest [-s STRIDE]\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  long stride = DEFAULT_STRIDE;
+
+  for(int i=1; i<argc; i++) {
+    if(strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+      stride = atol(argv[++i]);
+      if(stride < 1) usage();
+    } else {
+      usage();
+    }
+  }
+
+  int failures = 0;
+
+  int32_t pressure, temperature;
+  MS5xxx::Compensate(DATASHEET, DATASHEET_D1, DATASHEET_D2, &pressure, &temperature);
+  if(pressure != DATASHEET_P || temperature != DATASHEET_TEMP) {
+    fprintf(stderr, "compensatetest: datasheet example gave P=%d TEMP=%d, expected %d and %d\n",
+            pressure, temperature, DATASHEET_P, DATASHEET_TEMP);
+    failures++;
+  }
+
+  // The datasheet's calibration and some either side of it
+  const double scales[] = { 0.8, 0.9, 1.0, 1.1, 1.2 };
+  const int calibrations = sizeof(scales) / sizeof(scales[0]);
+
+  unsigned long cases = 0, mismatches = 0;
+  double maxPressure = 0, maxTemperature = 0;
+  double rangePressure = 0, rangeTemperature = 0;
+
+  for(int k=0; k<calibrations; k++) {
+    MS5xxx_Calibration cal = scaled(DATASHEET, scales[k]);
+
+    // Ends on ADC_MAX whatever the stride
+    for(uint32_t D2=0; ; D2 = (D2 + stride < ADC_MAX ? D2 + stride : ADC_MAX)) {
+      for(int j=0; j<=D1_SAMPLES; j++) {
+        uint32_t D1 = (uint64_t)ADC_MAX * j / D1_SAMPLES;
+
+        int32_t p, t, rp, rt;
+        MS5xxx::Compensate(cal, D1, D2, &p, &t);
+        reference(cal, D1, D2, &rp, &rt);
+        cases++;
+
+        if(p != rp || t != rt) {
+          if(mismatches++ < 10) {
+            fprintf(stderr, "compensatetest: D1=%u D2=%u gave P=%d TEMP=%d, datasheet P=%d TEMP=%d\n",
+                    D1, D2, p, t, rp, rt);
+          }
+        }
+
+        double dp, dt;
+        readoutDouble(cal, D1, D2, &dp, &dt);
+        if(fabs(p - dp) > maxPressure) maxPressure = fabs(p - dp);
+        if(fabs(t - dt) > maxTemperature) maxTemperature = fabs(t - dt);
+        if(rp >= RANGE_MIN_P && rp <= RANGE_MAX_P && rt >= RANGE_MIN_TEMP && rt <= RANGE_MAX_TEMP) {
+          if(fabs(p - dp) > rangePressure) rangePressure = fabs(p - dp);
+          if(fabs(t - dt) > rangeTemperature) rangeTemperature = fabs(t - dt);
+        }
+      }
+
+      if(D2 == ADC_MAX) break;
+    }
+  }
+
+  failures += (mismatches > 0);
+  printf("compensatetest: %lu cases, %lu differ from the datasheet formulas\n", cases, mismatches);
+  printf("compensatetest: double path differs by up to %.3f Pa and %.3f centidegrees, "
+         "%.3f Pa and %.3f centidegrees in the operating range\n",
+         maxPressure, maxTemperature, rangePressure, rangeTemperature);
+
+  // The same readings through both paths, cold enough for the second order
+  // terms half the time
+  volatile int32_t sink = 0;
+  volatile double sinkDouble = 0;
+  const uint32_t D2s[2] = { DATASHEET_D2, DATASHEET_D2 - 600000 };
+
+  double start = now();
+  for(long i=0; i<BENCH_CALLS; i++) {
+    int32_t p, t;
+    MS5xxx::Compensate(DATASHEET, DATASHEET_D1 + (i & 0xFF), D2s[i & 1], &p, &t);
+    sink += p + t;
+  }
+  double integer = (now() - start) * 1e9 / BENCH_CALLS;
+
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) {
+    double p, t;
+    readoutDouble(DATASHEET, DATASHEET_D1 + (i & 0xFF), D2s[i & 1], &p, &t);
+    sinkDouble += p + t;
+  }
+  double floating = (now() - start) * 1e9 / BENCH_CALLS;
+
+  printf("compensatetest: %.1f ns per integer call, %.1f ns per double call\n", integer, floating);
+
+  if(failures) {
+    fprintf(stderr, "compensatetest: failed\n");
+    return 1;
+  }
+
+  return 0;
+}
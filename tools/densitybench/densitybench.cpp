@@ -0,0 +1,172 @@
+// Host benchmark for the air density model (see libraries/Osprey/airbrake.cpp)
+//
+// Build: g++ -O2 -Ilibraries/Osprey -o densitybench tools/densitybench/densitybench.cpp libraries/Osprey/airbrake.cpp
+// Usage: densitybench
+//
+// Compares Exponentially_Decaying_Density_Model, which indexes its band
+// directly and takes the lowest band from a table, with the function it
+// replaced, kept below as it was: a parameter table built on the stack and
+// scanned end to end on every call, then an exp(). Both are also compared
+// with the model worked out in double, every metre from 0 to 1000 km.
+//
+// Then both are timed in the lowest band, where every flight stays, and
+// above it. Host time is no measure of the M0's, where exp() is a long soft
+// float routine, but shows how the two compare. Exits non-zero if the two
+// differ by more than 1e-6 relative anywhere in the model's range.
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+#include "airbrake.h"
+
+#define MAX_HEIGHT 1000   // km, the top of the model
+#define HEIGHT_STEP 0.001 // km
+#define TOLERANCE 1e-6    // relative
+#define BENCH_CALLS 20000000L
+
+// The model as it was
+static float oldDensity(float h)
+{
+   static const float parameters[36][5] =
+   {{  0 ,  25 ,   0 , 1.225     , 8.44},
+    { 25 ,  30 ,  25 , 3.899e-2  , 6.49},
+    { 30 ,  35 ,  30 , 1.774e-2  , 6.75},
+    { 35 ,  40 ,  35 , 8.279e-3  , 7.07},
+    { 40 ,  45 ,  40 , 3.972e-3  , 7.47},
+    { 45 ,  50 ,  45 , 1.995e-3  , 7.83},
+    { 50 ,  55 ,  50 , 1.057e-3  , 7.95},
+    { 55 ,  60 ,  55 , 5.821e-4  , 7.73},
+    { 60 ,  65 ,  60 , 3.206e-4  , 7.29},
+    { 65 ,  70 ,  65 , 1.718e-4  , 6.81},
+    { 70 ,  75 ,  70 , 8.770e-5  , 6.33},
+    { 75 ,  80 ,  75 , 4.178e-5  , 6.00},
+    { 80 ,  85 ,  80 , 1.905e-5  , 5.70},
+    { 85 ,  90 ,  85 , 8.337e-6  , 5.41},
+    { 90 ,  95 ,  90 , 3.396e-6  , 5.38},
+    { 95 , 100 ,  95 , 1.343e-6  , 5.74},
+    { 100,  110,  100, 5.297e-7 ,  6.15},
+    { 110,  120,  110, 9.661e-8 ,  8.06},
+    { 120,  130,  120, 2.438e-8 ,  11.6},
+    { 130,  140,  130, 8.484e-9 ,  16.1},
+    { 140,  150,  140, 3.845e-9 ,  20.6},
+    { 150,  160,  150, 2.070e-9 ,  24.6},
+    { 160,  180,  160, 1.224e-9 ,  26.3},
+    { 180,  200,  180, 5.464e-10,  33.2},
+    { 200,  250,  200, 2.789e-10,  38.5},
+    { 250,  300,  250, 7.248e-11,  46.9},
+    { 300,  350,  300, 2.418e-11,  52.5},
+    { 350,  400,  350, 9.158e-12,  56.4},
+    { 400,  450,  400, 3.725e-12,  59.4},
+    { 450,  500,  450, 1.585e-12,  62.2},
+    { 500,  600,  500, 6.967e-13,  65.8},
+    { 600,  700,  600, 1.454e-13,  79.0},
+    { 700,  800,  700, 3.614e-14, 109.0},
+    { 800,  900,  800, 1.170e-14, 164.0},
+    { 900, 1000,  900, 5.245e-15, 225.0},
+    {1000 , 1000, 1000, 3.019e-15, 268.0}};
+
+  /* Initialize the atmosphere density model parameters */
+  float h_0   = 0.0; // reference height, in km
+  float rho_0 = 0.0; // reference density, in kg/m^3
+  float H     = 0.0; // scale height, in km
+
+  /* Compute the atmosphere density */
+  for (auto counter = 0u; counter < 36; ++counter)
+  {
+      if( h >= parameters[counter][0] && h <= parameters[counter][1])
+      {
+          h_0 = parameters[counter][2]; // reference height, in km
+          rho_0 = parameters[counter][3]; //reference density, in kg/m^3
+          H = parameters[counter][4]; // scale height, in km
+      }
+  }
+
+  return rho_0*exp(-(h-h_0)/H); // atmospheric density, in kg/m^3
+}
+
+// The same model in double, the band found the same way
+static double exactDensity(double h) {
+  static const double bands[][3] = {
+    {   0, 1.225,     8.44 }, {  25, 3.899e-2,  6.49 }, {  30, 1.774e-2,  6.75 },
+    {  35, 8.279e-3,  7.07 }, {  40, 3.972e-3,  7.47 }, {  45, 1.995e-3,  7.83 },
+    {  50, 1.057e-3,  7.95 }, {  55, 5.821e-4,  7.73 }, {  60, 3.206e-4,  7.29 },
+    {  65, 1.718e-4,  6.81 }, {  70, 8.770e-5,  6.33 }, {  75, 4.178e-5,  6.00 },
+    {  80, 1.905e-5,  5.70 }, {  85, 8.337e-6,  5.41 }, {  90, 3.396e-6,  5.38 },
+    {  95, 1.343e-6,  5.74 }, { 100, 5.297e-7,  6.15 }, { 110, 9.661e-8,  8.06 },
+    { 120, 2.438e-8,  11.6 }, { 130, 8.484e-9,  16.1 }, { 140, 3.845e-9,  20.6 },
+    { 150, 2.070e-9,  24.6 }, { 160, 1.224e-9,  26.3 }, { 180, 5.464e-10, 33.2 },
+    { 200, 2.789e-10, 38.5 }, { 250, 7.248e-11, 46.9 }, { 300, 2.418e-11, 52.5 },
+    { 350, 9.158e-12, 56.4 }, { 400, 3.725e-12, 59.4 }, { 450, 1.585e-12, 62.2 },
+    { 500, 6.967e-13, 65.8 }, { 600, 1.454e-13, 79.0 }, { 700, 3.614e-14, 109.0 },
+    { 800, 1.170e-14, 164.0 }, { 900, 5.245e-15, 225.0 }, { 1000, 3.019e-15, 268.0 }
+  };
+
+  int band = 0;
+  while(band < 35 && h >= bands[band + 1][0]) {
+    band++;
+  }
+  return bands[band][1] * exp(-(h - bands[band][0]) / bands[band][2]);
+}
+
+static double relative(double a, double b) {
+  return b > 0 ? fabs(a - b) / b : fabs(a);
+}
+
+static double now() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ns per call over heights from low to high km
+template<typename Density>
+static double timeCalls(Density density, float low, float high) {
+  volatile float sink = 0;
+  float step = (high - low) / 65536;
+
+  double start = now();
+  for(long i=0; i<BENCH_CALLS; i++) {
+    sink = sink + density(low + (i & 0xFFFF) * step);
+  }
+  return (now() - start) * 1e9 / BENCH_CALLS;
+}
+
+int main(int argc, char **argv) {
+  if(argc > 1) {
+    fprintf(stderr, "usage: densitybench\n");
+    return 2;
+  }
+
+  double worstOld = 0, worstNew = 0, worstBetween = 0;
+  double worstOldAt = 0, worstNewAt = 0, worstBetweenAt = 0;
+
+  for(long i=0; i<=(long)(MAX_HEIGHT / HEIGHT_STEP); i++) {
+    float h = i * HEIGHT_STEP;
+    double exact = exactDensity(h);
+    double fresh = Exponentially_Decaying_Density_Model(h);
+    double old = oldDensity(h);
+
+    if(relative(old, exact) > worstOld) { worstOld = relative(old, exact); worstOldAt = h; }
+    if(relative(fresh, exact) > worstNew) { worstNew = relative(fresh, exact); worstNewAt = h; }
+    if(relative(fresh, old) > worstBetween) { worstBetween = relative(fresh, old); worstBetweenAt = h; }
+  }
+
+  printf("densitybench: against double, old %.2g at %.3f km, new %.2g at %.3f km\n",
+         worstOld, worstOldAt, worstNew, worstNewAt);
+  printf("densitybench: new against old %.2g at %.3f km\n", worstBetween, worstBetweenAt);
+  printf("densitybench: below sea level old %g, new %g kg/m^3\n",
+         oldDensity(-0.1f), Exponentially_Decaying_Density_Model(-0.1f));
+
+  printf("densitybench: 0 to 25 km, %.1f ns per call, was %.1f ns\n",
+         timeCalls(Exponentially_Decaying_Density_Model, 0, h_LOW_BAND_TOP),
+         timeCalls(oldDensity, 0, h_LOW_BAND_TOP));
+  printf("densitybench: 25 to 1000 km, %.1f ns per call, was %.1f ns\n",
+         timeCalls(Exponentially_Decaying_Density_Model, h_LOW_BAND_TOP, MAX_HEIGHT),
+         timeCalls(oldDensity, h_LOW_BAND_TOP, MAX_HEIGHT));
+
+  if(worstBetween > TOLERANCE) {
+    fprintf(stderr, "densitybench: new and old models differ by more than %g\n", TOLERANCE);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,123 @@
+// Fixed point against soft float benchmark for the Feather M0
+//
+// Usage: open this sketch in the Arduino IDE alongside the libraries of this
+// repository, upload it and watch the serial monitor.
+//
+// Times each operation in libraries/Osprey/fixed.h beside the float one it
+// stands in for, and Sensor's Kalman update written both ways, and prints
+// the CPU cycles per call of each. The M0 has no cycle counter, so cycles are
+// worked out from micros(), which the core keeps with SysTick, over
+// BENCH_CALLS calls less the same loop with nothing in it.
+//
+// tools/fixedtest checks the results on the host; this is only the cost.
+
+#include <math.h>
+
+#include <fixed.h>
+
+using Osprey::Fixed;
+
+#define BENCH_CALLS 10000
+#define BENCH_VALUES 64 // inputs cycled through, a power of two
+
+// The barometer's filter settings
+#define BENCH_PROCESS_NOISE 0.01f
+#define BENCH_MEASUREMENT_NOISE 0.25f
+
+static Fixed fixedA[BENCH_VALUES], fixedB[BENCH_VALUES];
+static float floatA[BENCH_VALUES], floatB[BENCH_VALUES];
+
+volatile int32_t fixedSink;
+volatile float floatSink;
+
+static unsigned long emptyLoop;
+
+// Sensor's filter in either type, as kalmanUpdate does it
+template<typename T>
+struct BenchKalman {
+  T processNoise, measurementNoise, value, error, gain;
+
+  void update(T measurement) {
+    error = error + processNoise;
+    gain = error / (error + measurementNoise);
+    value = value + gain * (measurement - value);
+    error = (T(1) - gain) * error;
+  }
+};
+
+static BenchKalman<Fixed> fixedKalman;
+static BenchKalman<float> floatKalman;
+
+#define TIME(expression) ({ \
+    unsigned long start = micros(); \
+    for(int i=0; i<BENCH_CALLS; i++) { \
+      int j = i & (BENCH_VALUES - 1); \
+      (void)j; \
+      expression; \
+    } \
+    micros() - start; \
+  })
+
+static void report(const char *name, unsigned long fixedMicros, unsigned long floatMicros) {
+  // Cycles per call, in tenths
+  unsigned long cyclesPerMicro = F_CPU / 1000000UL;
+  long fixedCycles = (long)(fixedMicros - emptyLoop) * cyclesPerMicro * 10 / BENCH_CALLS;
+  long floatCycles = (long)(floatMicros - emptyLoop) * cyclesPerMicro * 10 / BENCH_CALLS;
+
+  Serial.print(name);
+  Serial.print(": fixed ");
+  Serial.print(fixedCycles / 10);
+  Serial.print('.');
+  Serial.print(fixedCycles % 10);
+  Serial.print(" cycles, float ");
+  Serial.print(floatCycles / 10);
+  Serial.print('.');
+  Serial.print(floatCycles % 10);
+  Serial.println(" cycles");
+}
+
+void setup() {
+  Serial.begin(9600);
+  while(!Serial) {
+    delay(1);
+  }
+
+  // Positive values below 200 and 100, as sensor readings would be
+  randomSeed(1);
+  for(int i=0; i<BENCH_VALUES; i++) {
+    fixedA[i] = Fixed::fromRaw(random(1, 200L * FIXED_ONE));
+    fixedB[i] = Fixed::fromRaw(random(1, 100L * FIXED_ONE));
+    floatA[i] = fixedA[i].toFloat();
+    floatB[i] = fixedB[i].toFloat();
+  }
+
+  fixedKalman = { Fixed(BENCH_PROCESS_NOISE), Fixed(BENCH_MEASUREMENT_NOISE), Fixed(0), Fixed(1), Fixed(0) };
+  floatKalman = { BENCH_PROCESS_NOISE, BENCH_MEASUREMENT_NOISE, 0, 1, 0 };
+
+  emptyLoop = TIME(fixedSink = fixedSink + j);
+
+  report("multiply", TIME(fixedSink = (fixedA[j] * fixedB[j]).toRaw()),
+                     TIME(floatSink = floatA[j] * floatB[j]));
+  report("divide", TIME(fixedSink = (fixedA[j] / fixedB[j]).toRaw()),
+                   TIME(floatSink = floatA[j] / floatB[j]));
+  report("sqrt", TIME(fixedSink = fixedSqrt(fixedA[j]).toRaw()),
+                 TIME(floatSink = sqrtf(floatA[j])));
+  report("norm", TIME(fixedSink = fixedNorm(fixedA[j], fixedB[j], fixedA[j ^ 1]).toRaw()),
+                 TIME(floatSink = sqrtf(floatA[j] * floatA[j] + floatB[j] * floatB[j] + floatA[j ^ 1] * floatA[j ^ 1])));
+  report("atan2", TIME(fixedSink = fixedAtan2(fixedA[j], fixedB[j]).toRaw()),
+                  TIME(floatSink = atan2f(floatA[j], floatB[j])));
+  report("exp", TIME(fixedSink = fixedExp(fixedB[j] / Fixed(10)).toRaw()),
+                TIME(floatSink = expf(floatB[j] / 10)));
+  report("log", TIME(fixedSink = fixedLog(fixedA[j]).toRaw()),
+                TIME(floatSink = logf(floatA[j])));
+  report("pow", TIME(fixedSink = fixedPow(fixedA[j], Fixed(0.1902632)).toRaw()),
+                TIME(floatSink = powf(floatA[j], 0.1902632f)));
+  report("kalman", TIME(fixedKalman.update(fixedB[j])),
+                   TIME(floatKalman.update(floatB[j])));
+
+  fixedSink = fixedKalman.value.toRaw();
+  floatSink = floatKalman.value;
+}
+
+void loop() {
+}
@@ -0,0 +1,393 @@
+// Host test and benchmark for the Q16.16 fixed point type (see libraries/Osprey/fixed.h)
+//
+// Build: g++ -O2 -DARDUINO=10810 -DFIXED_POINT_MATH=1 -Itools/sitl/hal -Ilibraries/Osprey -o fixedtest tools/fixedtest/fixedtest.cpp libraries/Osprey/fixed.cpp libraries/Osprey/sensor.cpp
+// Usage: fixedtest [-n SAMPLES]
+//
+// Checks Fixed's conversions, rounding and saturation, then measures the
+// worst case error of fixedSqrt, fixedNorm, fixedAtan2, fixedExp, fixedLog
+// and fixedPow against long double, over every input up to 2^20 (every
+// input of exp that doesn't saturate) and SAMPLES (default 10000000) random
+// ones spread over the whole range, and checks each against the bound
+// fixed.h documents.
+//
+// Sensor's Kalman filter is built in fixed point (hence FIXED_POINT_MATH
+// above) and run beside the float filter it replaces, on a barometer's
+// pressures in hPa and an accelerometer's counts, and the largest
+// difference is reported.
+//
+// Finally the fixed and float versions of each are timed. Host time is no
+// measure of the M0's, where every float operation is a library call, but
+// shows what the fixed point code costs in integer work. Exits non-zero if
+// any check fails.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "fixed.h"
+#include "sensor.h"
+#include "../check.h"
+
+#if !FIXED_POINT_MATH
+#error "build with -DFIXED_POINT_MATH=1"
+#endif
+
+using Osprey::Fixed;
+
+#define DEFAULT_SAMPLES 10000000L
+#define EXHAUSTIVE_LIMIT (1L << 20)
+#define LSB (1.0L / FIXED_ONE)
+#define BENCH_CALLS 10000000L
+
+// The bounds documented in fixed.h, the last two beyond 0.5 LSB and relative
+#define ATAN2_ERROR 0.65 // LSB
+#define LOG_ERROR 0.51   // LSB
+#define EXP_ERROR 1e-8
+#define POW_ERROR 1e-4
+
+// The barometer's and accelerometer's filter settings
+#define BARO_PROCESS_NOISE 0.01f
+#define BARO_MEASUREMENT_NOISE 0.25f
+#define BARO_ERROR 1
+#define ACCEL_LSB 100 // counts per m/s^2
+
+static long double value(Fixed x) {
+  return x.toRaw() * LSB;
+}
+
+// Uniform over the whole raw range, from a generator whose sequence doesn't
+// depend on the platform's rand()
+static uint64_t state = 88172645463325252ULL;
+
+static uint32_t random32() {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return (uint32_t)state;
+}
+
+static Fixed randomFixed() {
+  return Fixed::fromRaw((int32_t)random32());
+}
+
+// Scaled down by a random power of two so small values are as well covered
+// as large ones
+static Fixed randomSpread() {
+  return Fixed::fromRaw((int32_t)random32() >> (random32() % 31));
+}
+
+static double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Exposes Sensor's filter
+class TestSensor : public Sensor {
+  public:
+    TestSensor() : Sensor(BARO_PROCESS_NOISE, BARO_MEASUREMENT_NOISE, BARO_ERROR) {}
+    int init() { return 1; }
+
+    kalman_t init(float value) { return kalmanInit(value); }
+    void update(kalman_t *state, kalman_value_t measurement) { kalmanUpdate(state, measurement); }
+    float read(const kalman_t *state) { return kalmanValue(state); }
+};
+
+// Sensor's filter as it is in float builds
+typedef struct {
+  float processNoise, measurementNoise, value, error, gain;
+} float_kalman_t;
+
+static float_kalman_t floatInit(float value) {
+  float_kalman_t kalman = { BARO_PROCESS_NOISE, BARO_MEASUREMENT_NOISE, value, BARO_ERROR, 0 };
+  return kalman;
+}
+
+static void floatUpdate(float_kalman_t *state, float measurement) {
+  state->error = state->error + state->processNoise;
+  state->gain = state->error / (state->error + state->measurementNoise);
+  state->value = state->value + state->gain * (measurement - state->value);
+  state->error = (1 - state->gain) * state->error;
+}
+
+static void testArithmetic() {
+  check(Fixed(1).toRaw() == FIXED_ONE && Fixed(-3).toRaw() == -3 * FIXED_ONE, "integers convert exactly");
+  check(Fixed(0.5f).toRaw() == FIXED_ONE / 2 && Fixed(-1.5).toRaw() == -3 * FIXED_ONE / 2, "reals convert exactly where they can");
+  check(Fixed(1.0 / 3).toRaw() == 21845 && Fixed(-1.0 / 3).toRaw() == -21845, "reals round to nearest");
+  check(Fixed(2.5).toInt() == 3 && Fixed(-2.5).toInt() == -2 && Fixed(2.49).toInt() == 2, "toInt rounds half up");
+  check(Fixed(40000) == Fixed::max() && Fixed(-40000) == Fixed::min() && Fixed(1e6) == Fixed::max(),
+        "out of range conversions saturate");
+  check(Fixed(30000) + Fixed(30000) == Fixed::max() && Fixed(-30000) - Fixed(30000) == Fixed::min(),
+        "addition and subtraction saturate");
+  check(Fixed(200) * Fixed(200) == Fixed::max() && Fixed(-200) * Fixed(200) == Fixed::min(),
+        "multiplication saturates");
+  check(Fixed(1) / Fixed(0) == Fixed::max() && Fixed(-1) / Fixed(0) == Fixed::min(),
+        "division by zero saturates towards the dividend's sign");
+  check(-Fixed::min() == Fixed::max(), "negating the minimum saturates");
+  check(Fixed::fromRatio(101325, 100) == Fixed(1013.25) && Fixed::fromRatio(1, 0) == Fixed::max(),
+        "fromRatio");
+
+  // Products round to nearest, quotients truncate
+  long double worstProduct = 0, worstQuotient = 0, worstRatio = 0;
+  for(long i=0; i<1000000; i++) {
+    Fixed a = randomSpread(), b = randomSpread();
+    long double product = value(a) * value(b);
+    if(fabsl(product) < 32767) {
+      worstProduct = fmaxl(worstProduct, fabsl(value(a * b) - product) / LSB);
+    }
+    if(b.toRaw()) {
+      long double quotient = value(a) / value(b);
+      if(fabsl(quotient) < 32767) {
+        worstQuotient = fmaxl(worstQuotient, fabsl(value(a / b) - quotient) / LSB);
+      }
+    }
+
+    int32_t num = (int32_t)random32() >> 8, den = (int32_t)(random32() % 100000) + 1;
+    long double ratio = (long double)num / den;
+    if(fabsl(ratio) < 32767) {
+      worstRatio = fmaxl(worstRatio, fabsl(value(Fixed::fromRatio(num, den)) - ratio) / LSB);
+    }
+  }
+  printf("fixedtest: worst product %.3Lf LSB, quotient %.3Lf LSB, ratio %.3Lf LSB\n",
+         worstProduct, worstQuotient, worstRatio);
+  check(worstProduct <= 0.5, "products are within 0.5 LSB");
+  check(worstQuotient < 1 && worstRatio < 1, "quotients are within 1 LSB");
+}
+
+static void testRoots(long samples) {
+  long double worstSqrt = 0, worstNorm = 0;
+
+  for(long raw=0; raw<EXHAUSTIVE_LIMIT; raw++) {
+    Fixed x = Fixed::fromRaw(raw);
+    worstSqrt = fmaxl(worstSqrt, fabsl(value(fixedSqrt(x)) - sqrtl(value(x))) / LSB);
+  }
+
+  bool saturated = true;
+  for(long i=0; i<samples; i++) {
+    Fixed x = randomFixed();
+    if(x.toRaw() >= 0) {
+      worstSqrt = fmaxl(worstSqrt, fabsl(value(fixedSqrt(x)) - sqrtl(value(x))) / LSB);
+    }
+
+    Fixed a = randomSpread(), b = randomSpread(), c = randomSpread();
+    long double norm = sqrtl(value(a) * value(a) + value(b) * value(b) + value(c) * value(c));
+    if(norm < 32767) {
+      worstNorm = fmaxl(worstNorm, fabsl(value(fixedNorm(a, b, c)) - norm) / LSB);
+    } else if(norm >= 32768 && fixedNorm(a, b, c) != Fixed::max()) {
+      saturated = false;
+    }
+  }
+
+  printf("fixedtest: worst sqrt %.3Lf LSB, norm %.3Lf LSB\n", worstSqrt, worstNorm);
+  check(worstSqrt <= 0.5, "fixedSqrt is within 0.5 LSB");
+  check(worstNorm <= 0.5, "fixedNorm is within 0.5 LSB");
+  check(saturated, "fixedNorm saturates rather than overflowing");
+  check(fixedSqrt(Fixed(-4)) == Fixed() && fixedSqrt(Fixed::max()) == Fixed(181.0193359837562),
+        "fixedSqrt at the ends of its range");
+}
+
+// Error beyond the 0.5 LSB of rounding, relative to the exact result
+static long double relativeError(Fixed got, long double exact) {
+  return fmaxl(fabsl(value(got) - exact) - LSB / 2, 0) / fabsl(exact);
+}
+
+static void testTranscendentals(long samples) {
+  long double worstAtan2 = 0, worstLog = 0, worstExp = 0, worstPow = 0;
+
+  // Every input where e^x is neither zero nor saturated, and every log input
+  // up to 16
+  for(int32_t raw=-772243; raw<=681391; raw++) {
+    Fixed x = Fixed::fromRaw(raw);
+    long double exact = expl(value(x));
+    if(exact < 32767) {
+      worstExp = fmaxl(worstExp, relativeError(fixedExp(x), exact));
+    }
+  }
+  for(long raw=1; raw<EXHAUSTIVE_LIMIT; raw++) {
+    Fixed x = Fixed::fromRaw(raw);
+    worstLog = fmaxl(worstLog, fabsl(value(fixedLog(x)) - logl(value(x))) / LSB);
+  }
+
+  for(long i=0; i<samples; i++) {
+    Fixed x = randomSpread(), y = randomSpread();
+    if(x.toRaw() || y.toRaw()) {
+      worstAtan2 = fmaxl(worstAtan2, fabsl(value(fixedAtan2(y, x)) - atan2l(value(y), value(x))) / LSB);
+    }
+
+    Fixed positive = Fixed::fromRaw(random32() & INT32_MAX);
+    if(positive.toRaw()) {
+      worstLog = fmaxl(worstLog, fabsl(value(fixedLog(positive)) - logl(value(positive))) / LSB);
+    }
+
+    Fixed base = Fixed::fromRaw((int32_t)(random32() & INT32_MAX) >> (random32() % 31));
+    Fixed exponent = randomSpread();
+    if(base.toRaw()) {
+      long double power = powl(value(base), value(exponent));
+      if(power < 32767) {
+        worstPow = fmaxl(worstPow, relativeError(fixedPow(base, exponent), power));
+      }
+    }
+  }
+
+  printf("fixedtest: worst atan2 %.3Lf LSB, log %.4Lf LSB, exp 0.5 LSB + %.2Le, pow 0.5 LSB + %.2Le relative\n",
+         worstAtan2, worstLog, worstExp, worstPow);
+  check(worstAtan2 <= ATAN2_ERROR, "fixedAtan2 is within its documented error");
+  check(worstLog <= LOG_ERROR, "fixedLog is within its documented error");
+  check(worstExp <= EXP_ERROR, "fixedExp is within its documented error");
+  check(worstPow <= POW_ERROR, "fixedPow is within its documented error");
+  check(fixedExp(Fixed(11)) == Fixed::max() && fixedExp(Fixed(-12)) == Fixed() &&
+        fixedLog(Fixed()) == Fixed::min() && fixedPow(Fixed(-2), Fixed(2)) == Fixed(),
+        "exp, log and pow at the ends of their range");
+  check(fixedAtan2(Fixed(), Fixed(-1)) == Fixed(3.14159265358979) && fixedAtan2(Fixed(), Fixed()) == Fixed(),
+        "atan2 on the negative x axis and at the origin");
+}
+
+static void testKalman() {
+  TestSensor sensor;
+
+  // A ground test pressure, then a flight's worth of falling pressure, with
+  // the MS5607's few Pa of noise
+  kalman_t baro = sensor.init(1013.25f);
+  float_kalman_t floatBaro = floatInit(101325);
+  double worstBaro = 0;
+  for(int i=0; i<6000; i++) {
+    int32_t pressure = 101325 - (i > 1000 ? (i - 1000) * 14 : 0) + (int32_t)(random32() % 9) - 4;
+    sensor.update(&baro, kalmanRatio(pressure, 100));
+    floatUpdate(&floatBaro, pressure);
+    worstBaro = fmax(worstBaro, fabs(sensor.read(&baro) * 100 - floatBaro.value));
+  }
+
+  // An accelerometer's counts through a motor burn
+  kalman_t accel = sensor.init(1);
+  float_kalman_t floatAccel = floatInit(1);
+  double worstAccel = 0;
+  for(int i=0; i<6000; i++) {
+    int16_t counts = (i > 1000 && i < 1400 ? 9000 : 981) + (int16_t)(random32() % 61) - 30;
+    sensor.update(&accel, kalmanRatio(counts, ACCEL_LSB));
+    floatUpdate(&floatAccel, counts / (float)ACCEL_LSB);
+    worstAccel = fmax(worstAccel, fabs(sensor.read(&accel) - floatAccel.value));
+  }
+
+  printf("fixedtest: Kalman filter within %.4f Pa and %.5f m/s^2 of float\n", worstBaro, worstAccel);
+  check(worstBaro < 0.1, "fixed point pressure filter matches float");
+  check(worstAccel < 0.001, "fixed point acceleration filter matches float");
+}
+
+static void benchmark() {
+  Fixed a[256], b[256];
+  float fa[256], fb[256];
+  for(int i=0; i<256; i++) {
+    a[i] = Fixed::fromRaw((int32_t)(random32() % (200 * FIXED_ONE)) + 1);
+    b[i] = Fixed::fromRaw((int32_t)(random32() % (100 * FIXED_ONE)) + 1);
+    fa[i] = a[i].toFloat();
+    fb[i] = b[i].toFloat();
+  }
+
+  volatile int32_t sink = 0;
+  volatile float floatSink = 0;
+  double start;
+
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) sink = sink + (a[i & 0xFF] * b[(i >> 8) & 0xFF]).toRaw();
+  double fixedMultiply = (now() - start) * 1e9 / BENCH_CALLS;
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) floatSink = floatSink + fa[i & 0xFF] * fb[(i >> 8) & 0xFF];
+  double floatMultiply = (now() - start) * 1e9 / BENCH_CALLS;
+
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) sink = sink + (a[i & 0xFF] / b[(i >> 8) & 0xFF]).toRaw();
+  double fixedDivide = (now() - start) * 1e9 / BENCH_CALLS;
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) floatSink = floatSink + fa[i & 0xFF] / fb[(i >> 8) & 0xFF];
+  double floatDivide = (now() - start) * 1e9 / BENCH_CALLS;
+
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) sink = sink + fixedSqrt(a[i & 0xFF]).toRaw();
+  double fixedRoot = (now() - start) * 1e9 / BENCH_CALLS;
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) floatSink = floatSink + sqrtf(fa[i & 0xFF]);
+  double floatRoot = (now() - start) * 1e9 / BENCH_CALLS;
+
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) {
+    sink = sink + fixedNorm(a[i & 0xFF], b[(i >> 8) & 0xFF], a[(i >> 4) & 0xFF]).toRaw();
+  }
+  double fixedNorms = (now() - start) * 1e9 / BENCH_CALLS;
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) {
+    float x = fa[i & 0xFF], y = fb[(i >> 8) & 0xFF], z = fa[(i >> 4) & 0xFF];
+    floatSink = floatSink + sqrtf(x * x + y * y + z * z);
+  }
+  double floatNorms = (now() - start) * 1e9 / BENCH_CALLS;
+
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) sink = sink + fixedAtan2(a[i & 0xFF], b[(i >> 8) & 0xFF]).toRaw();
+  double fixedAtan = (now() - start) * 1e9 / BENCH_CALLS;
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) floatSink = floatSink + atan2f(fa[i & 0xFF], fb[(i >> 8) & 0xFF]);
+  double floatAtan = (now() - start) * 1e9 / BENCH_CALLS;
+
+  // Exponents of -8 to 8, the range that doesn't round to zero or saturate
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) sink = sink + fixedExp(b[i & 0xFF] / Fixed(6) - Fixed(8)).toRaw();
+  double fixedExps = (now() - start) * 1e9 / BENCH_CALLS;
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) floatSink = floatSink + expf(fb[i & 0xFF] / 6 - 8);
+  double floatExps = (now() - start) * 1e9 / BENCH_CALLS;
+
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) sink = sink + fixedLog(a[i & 0xFF]).toRaw();
+  double fixedLogs = (now() - start) * 1e9 / BENCH_CALLS;
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) floatSink = floatSink + logf(fa[i & 0xFF]);
+  double floatLogs = (now() - start) * 1e9 / BENCH_CALLS;
+
+  TestSensor sensor;
+  kalman_t kalman = sensor.init(0);
+  float_kalman_t floatKalman = floatInit(0);
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) sensor.update(&kalman, b[i & 0xFF]);
+  double fixedKalman = (now() - start) * 1e9 / BENCH_CALLS;
+  start = now();
+  for(long i=0; i<BENCH_CALLS; i++) floatUpdate(&floatKalman, fb[i & 0xFF]);
+  double floatKalmanTime = (now() - start) * 1e9 / BENCH_CALLS;
+  floatSink = floatSink + floatKalman.value + kalman.value.toFloat();
+
+  printf("fixedtest: %-8s %6.2f ns fixed %6.2f ns float\n", "multiply", fixedMultiply, floatMultiply);
+  printf("fixedtest: %-8s %6.2f ns fixed %6.2f ns float\n", "divide", fixedDivide, floatDivide);
+  printf("fixedtest: %-8s %6.2f ns fixed %6.2f ns float\n", "sqrt", fixedRoot, floatRoot);
+  printf("fixedtest: %-8s %6.2f ns fixed %6.2f ns float\n", "norm", fixedNorms, floatNorms);
+  printf("fixedtest: %-8s %6.2f ns fixed %6.2f ns float\n", "atan2", fixedAtan, floatAtan);
+  printf("fixedtest: %-8s %6.2f ns fixed %6.2f ns float\n", "exp", fixedExps, floatExps);
+  printf("fixedtest: %-8s %6.2f ns fixed %6.2f ns float\n", "log", fixedLogs, floatLogs);
+  printf("fixedtest: %-8s %6.2f ns fixed %6.2f ns float\n", "kalman", fixedKalman, floatKalmanTime);
+}
+
+static void usage() {
+  fprintf(stderr, "usage: fixedtest [-n SAMPLES]\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  long samples = DEFAULT_SAMPLES;
+
+  for(int i=1; i<argc; i++) {
+    if(strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      samples = atol(argv[++i]);
+      if(samples < 1) usage();
+    } else {
+      usage();
+    }
+  }
+
+  testArithmetic();
+  testRoots(samples);
+  testTranscendentals(samples);
+  testKalman();
+  benchmark();
+
+  return checkResult("fixedtest");
+}
@@ -0,0 +1,211 @@
+// Host test for the number formatting (see libraries/Osprey/format.h)
+//
+// Build: g++ -O2 -Ilibraries/Osprey -o formattest tools/formattest/formattest.cpp libraries/Osprey/format.cpp
+// Usage: formattest [-n CASES]
+//
+// Compares formatUnsigned, formatInt and formatFixed with glibc's printf:
+// every unsigned value below 200000 and a sweep of the rest, the edges of
+// the divide by 100, then CASES (default 20 million) random integers and
+// random floats at every precision. Half the floats are random bit patterns
+// and half are of the sizes a flight logs. Ties are checked at every
+// precision, since both should round them to even, and formatIso8601 with
+// dates and times padded to width.
+//
+// Also shows what the radio's old floatToString got wrong and times each
+// against snprintf. Host time says little of the M0's, where printf's %f
+// runs in soft double, but shows how they compare. Exits non-zero if any
+// output differs from printf's.
+
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "format.h"
+
+using namespace Osprey;
+
+#define DEFAULT_CASES 20000000L
+#define SEED 42
+#define DENSE_UNSIGNED 200000 // checked one by one, the rest in steps
+#define UNSIGNED_STEP 7919    // a prime, so every last digit comes up
+#define BENCH_VALUES 1024
+#define BENCH_REPEATS 2000
+
+static long failures = 0;
+
+static void compare(const char *what, const char *got, const char *expected) {
+  if(strcmp(got, expected) == 0) return;
+  if(failures++ < 20) {
+    printf("formattest: %s gave \"%s\", printf \"%s\"\n", what, got, expected);
+  }
+}
+
+// As Radio::floatToString was
+static void floatToString(float num, int precision, char *buffer) {
+  int characteristic = num;
+  num -= characteristic;
+  int mantissa = num * powf(10, precision);
+  if(mantissa < 0) mantissa = -mantissa;
+
+  char format[64];
+  sprintf(format, "%%0%dd.%%0%dd", 1, precision);
+  sprintf(buffer, format, characteristic, mantissa);
+}
+
+static void testIntegers(std::mt19937_64 &random, long cases) {
+  char got[FORMAT_INT_LENGTH], expected[32];
+
+  for(uint64_t value=0; value<=0xFFFFFFFFull; value+=(value < DENSE_UNSIGNED ? 1 : UNSIGNED_STEP)) {
+    formatUnsigned(value, got);
+    sprintf(expected, "%u", (unsigned)value);
+    compare("formatUnsigned", got, expected);
+  }
+
+  const uint32_t edges[] = { 0, 9, 10, 99, 100, 43698, 43699, 43700, 999999999, 1000000000, 4294967295u };
+  for(unsigned i=0; i<sizeof(edges) / sizeof(edges[0]); i++) {
+    formatUnsigned(edges[i], got);
+    sprintf(expected, "%u", edges[i]);
+    compare("formatUnsigned", got, expected);
+
+    formatInt((int32_t)edges[i], got);
+    sprintf(expected, "%d", (int32_t)edges[i]);
+    compare("formatInt", got, expected);
+  }
+
+  for(long i=0; i<cases; i++) {
+    int32_t value = random();
+    formatInt(value, got);
+    sprintf(expected, "%d", value);
+    compare("formatInt", got, expected);
+  }
+}
+
+static void testFixed(std::mt19937_64 &random, long cases) {
+  char got[FORMAT_FIXED_LENGTH], expected[64];
+
+  for(long i=0; i<cases; i++) {
+    float value;
+    if(i & 1) {
+      value = ldexpf((float)(random() % 20000000) / 1e6f - 10, (int)(random() % 40) - 20);
+    } else {
+      uint32_t bits = random();
+      memcpy(&value, &bits, sizeof(value));
+    }
+
+    // Past 2^64 formatFixed writes "inf" by design
+    if(fabsf(value) >= 18446744073709551616.0f && !isinf(value)) continue;
+
+    int precision = random() % (FORMAT_MAX_PRECISION + 1);
+    formatFixed(value, precision, got);
+    snprintf(expected, sizeof(expected), "%.*f", precision, (double)value);
+    compare("formatFixed", got, expected);
+  }
+
+  const float ties[] = { 0.5f, 1.5f, 2.5f, 0.125f, 0.375f, -0.5f, -0.0f, 1e-40f, 0.0f, -1e-30f, 9.995f, 0.995f, 99.5f };
+  for(unsigned i=0; i<sizeof(ties) / sizeof(ties[0]); i++) {
+    for(int precision=0; precision<=FORMAT_MAX_PRECISION; precision++) {
+      formatFixed(ties[i], precision, got);
+      snprintf(expected, sizeof(expected), "%.*f", precision, (double)ties[i]);
+      compare("formatFixed", got, expected);
+    }
+  }
+}
+
+static void testIso8601() {
+  char got[FORMAT_ISO_8601_LENGTH], expected[64];
+  const int times[][7] = {
+    { 2024, 6, 21, 14, 3, 7, 250 },
+    { 2005, 1, 2, 3, 4, 5, 6 },
+    { 2000, 12, 31, 23, 59, 59, 999 },
+    { 2099, 10, 10, 10, 10, 10, 10 },
+    { 2010, 1, 1, 0, 0, 0, 0 }
+  };
+
+  for(unsigned i=0; i<sizeof(times) / sizeof(times[0]); i++) {
+    const int *t = times[i];
+    formatIso8601(t[0], t[1], t[2], t[3], t[4], t[5], t[6], got);
+    snprintf(expected, sizeof(expected), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", t[0], t[1], t[2], t[3], t[4], t[5], t[6]);
+    compare("formatIso8601", got, expected);
+  }
+}
+
+static void showOld() {
+  const float values[] = { -0.5f, 1.999f };
+  char old[64], fresh[FORMAT_FIXED_LENGTH];
+
+  for(unsigned i=0; i<sizeof(values) / sizeof(values[0]); i++) {
+    floatToString(values[i], 2, old);
+    formatFixed(values[i], 2, fresh);
+    printf("formattest: %g to 2 places, old floatToString \"%s\", formatFixed \"%s\"\n", values[i], old, fresh);
+  }
+}
+
+// ns per call over the values
+template<typename Format>
+static double timeCalls(Format format, const float *values) {
+  volatile int sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for(int r=0; r<BENCH_REPEATS; r++) {
+    for(int i=0; i<BENCH_VALUES; i++) {
+      sink = sink + format(values[i]);
+    }
+  }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+         ((double)BENCH_REPEATS * BENCH_VALUES);
+}
+
+static void bench(std::mt19937_64 &random) {
+  float values[BENCH_VALUES];
+  char buffer[64];
+
+  // Altitudes and velocities to the millimetre
+  for(int i=0; i<BENCH_VALUES; i++) {
+    values[i] = ((int)(random() % 2000000) - 1000000) / 1000.0f;
+  }
+
+  printf("formattest: formatFixed %.1f ns, snprintf %%.2f %.1f ns, old floatToString %.1f ns\n",
+         timeCalls([&](float v) { return formatFixed(v, 2, buffer); }, values),
+         timeCalls([&](float v) { return snprintf(buffer, sizeof(buffer), "%.2f", (double)v); }, values),
+         timeCalls([&](float v) { floatToString(v, 2, buffer); return (int)buffer[0]; }, values));
+  printf("formattest: formatInt %.1f ns, snprintf %%d %.1f ns\n",
+         timeCalls([&](float v) { return formatInt((int32_t)v, buffer); }, values),
+         timeCalls([&](float v) { return snprintf(buffer, sizeof(buffer), "%d", (int32_t)v); }, values));
+}
+
+static void usage() {
+  fprintf(stderr, "usage: formattest [-n CASES]\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  long cases = DEFAULT_CASES;
+
+  for(int i=1; i<argc; i++) {
+    if(strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      cases = atol(argv[++i]);
+      if(cases < 1) usage();
+    } else {
+      usage();
+    }
+  }
+
+  std::mt19937_64 random(SEED);
+  testIntegers(random, cases);
+  testFixed(random, cases);
+  testIso8601();
+
+  printf("formattest: %ld outputs differ from printf\n", failures);
+  showOld();
+  bench(random);
+
+  if(failures) {
+    fprintf(stderr, "formattest: %ld failed\n", failures);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,231 @@
+// Host benchmark for the adaptive integrator (see libraries/Osprey/integrator.h)
+//
+// Build: g++ -O2 -Ilibraries/Osprey -o integratorbench tools/integratorbench/integratorbench.cpp libraries/Osprey/airbrake.cpp
+// Usage: integratorbench
+//
+// Flies the apogee predictor's problem, from a coasting state to zero
+// vertical velocity, over the grid of states the predictor is tested on,
+// brakes open and closed, with two integrators:
+//
+//   rk4 N    the fixed step RK4 of Truth_prop_state_rk45 that the predictor
+//            used, N steps over the closed form estimate of the climb time,
+//            with a parabola through the ends of the last step
+//   dp5 TOL  Osprey::DormandPrince with rtol TOL and atol 100 TOL, stopping
+//            on the zero crossing of its dense output, as the predictor does
+//
+// Each is compared with an RK4 of the same model in 1 ms steps, carried in
+// double. The derivative evaluations are what a prediction costs on the
+// board, so the worst and mean apogee error are printed against the mean and
+// worst number of them, with host time per prediction for what it's worth.
+//
+// Exits non-zero if Dormand-Prince at the predictor's tolerances is less
+// accurate, or needs more evaluations on average, than RK4 with 16 steps.
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+#include "airbrake.h"
+#include "integrator.h"
+#include "predictor.h"
+
+#define GROUND_LEVEL 1400.0f // m above sea level
+#define MIN_VELOCITY 20      // m/s
+#define MAX_VELOCITY 320
+#define VELOCITY_STEP 20
+#define MAX_ALTITUDE 2500    // m above the ground
+#define ALTITUDE_STEP 250
+#define STATES (((MAX_VELOCITY - MIN_VELOCITY) / VELOCITY_STEP + 1) * (MAX_ALTITUDE / ALTITUDE_STEP + 1) * 2)
+
+#define REFERENCE_DT 1e-3 // s
+#define BASELINE_STEPS 16 // the RK4 the predictor used
+#define REPEATS 20        // of every prediction, for the timing
+
+typedef struct {
+  float altitude; // m above sea level
+  float velocity; // m/s
+  float balCoeff;
+  double apogee;  // m above sea level, from the reference
+} case_t;
+
+typedef struct {
+  double worstError; // m
+  double meanError;  // m
+  double meanEvaluations;
+  int maxEvaluations;
+  double time;       // ns per prediction
+} result_t;
+
+static case_t cases[STATES];
+
+static double now() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The model as the flight code evaluates it, for a reference carried in double
+static double referenceAcceleration(double height, double velocity, float balCoeff) {
+  StateVector x((float)height, Vector3D(0, 0, (float)velocity), balCoeff);
+  return Truth_gravdiffeq_air_brake(x, 0).vec.z;
+}
+
+static double referenceApogee(double h, double v, float balCoeff) {
+  double dt = REFERENCE_DT;
+
+  for(;;) {
+    double a1 = referenceAcceleration(h, v, balCoeff);
+    double a2 = referenceAcceleration(h + dt / 2 * v, v + dt / 2 * a1, balCoeff);
+    double a3 = referenceAcceleration(h + dt / 2 * (v + dt / 2 * a1), v + dt / 2 * a2, balCoeff);
+    double a4 = referenceAcceleration(h + dt * (v + dt / 2 * a2), v + dt * a3, balCoeff);
+
+    double nextH = h + dt / 6 * (v + 2 * (v + dt / 2 * a1) + 2 * (v + dt / 2 * a2) + (v + dt * a3));
+    double nextV = v + dt / 6 * (a1 + 2 * a2 + 2 * a3 + a4);
+
+    if(nextV <= 0) {
+      double a = (nextV - v) / dt;
+      double s = -v / a;
+      return h + v * s + a * s * s / 2;
+    }
+
+    h = nextH;
+    v = nextV;
+  }
+}
+
+static void buildCases() {
+  const float balCoeffs[2] = { BAL_COEFF_CLOSED, BAL_COEFF_OPEN };
+  int n = 0;
+
+  for(int velocity=MIN_VELOCITY; velocity<=MAX_VELOCITY; velocity+=VELOCITY_STEP) {
+    for(int altitude=0; altitude<=MAX_ALTITUDE; altitude+=ALTITUDE_STEP) {
+      for(int b=0; b<2; b++) {
+        case_t &c = cases[n++];
+        c.altitude = altitude + GROUND_LEVEL;
+        c.velocity = velocity;
+        c.balCoeff = balCoeffs[b];
+        c.apogee = referenceApogee(c.altitude, c.velocity, c.balCoeff);
+      }
+    }
+  }
+}
+
+// Time to apogee with quadratic drag in air of constant density, as the
+// predictor works it out
+static float climbTime(const StateVector &x, float velocity) {
+  float k = Exponentially_Decaying_Density_Model(x.height / 1000.0) * x.balCoeff;
+  return atan(velocity * sqrt(k / GRAV)) / sqrt(k * GRAV);
+}
+
+// The predictor's old fixed step loop
+static float predictRK4(const case_t &c, int steps, int *evaluations) {
+  StateVector x(c.altitude, Vector3D(0, 0, c.velocity), c.balCoeff);
+  float dt = climbTime(x, c.velocity) / steps;
+  float t = 0;
+  *evaluations = 0;
+
+  for(int i=0; i<2 * steps; i++) {
+    StateVector next = Truth_prop_state_rk45(x, t, dt);
+    *evaluations += 4;
+
+    if(next.vec.z <= 0) {
+      float deceleration = (x.vec.z - next.vec.z) / dt;
+      float rise = x.vec.z / deceleration;
+      return x.height + x.vec.z * rise / 2;
+    }
+
+    x = next;
+    t += dt;
+  }
+
+  return NAN;
+}
+
+static float verticalVelocity(StateVector x) {
+  return x.vec.z;
+}
+
+// As ApogeePredictor::predict does it, without the budget
+static float predictDP5(const case_t &c, float rtol, float atol, int *evaluations) {
+  StateVector x(c.altitude, Vector3D(0, 0, c.velocity), c.balCoeff);
+  Osprey::DormandPrince<StateVector, StateVector (*)(StateVector, float)> integrator(
+      Truth_gravdiffeq_air_brake, rtol, atol, climbTime(x, c.velocity) / PREDICTOR_FIRST_STEPS);
+
+  float t = 0;
+  int result = integrator.integrate(x, t, c.velocity / GRAV + 1, verticalVelocity, PREDICTOR_MAX_STEPS);
+  *evaluations = integrator.getEvaluations();
+  return result == INTEGRATOR_EVENT ? x.height : NAN;
+}
+
+template<typename Predict>
+static result_t measure(Predict predict) {
+  result_t result = { 0, 0, 0, 0, 0 };
+  long evaluations = 0;
+
+  for(int i=0; i<STATES; i++) {
+    int n;
+    double error = fabs(predict(cases[i], &n) - cases[i].apogee);
+    if(!(error <= result.worstError)) result.worstError = error; // NaN wins
+    result.meanError += error / STATES;
+    evaluations += n;
+    if(n > result.maxEvaluations) result.maxEvaluations = n;
+  }
+  result.meanEvaluations = (double)evaluations / STATES;
+
+  volatile float sink = 0;
+  double start = now();
+  for(int r=0; r<REPEATS; r++) {
+    for(int i=0; i<STATES; i++) {
+      int n;
+      sink = sink + predict(cases[i], &n);
+    }
+  }
+  result.time = (now() - start) * 1e9 / (REPEATS * STATES);
+
+  return result;
+}
+
+static void print(const char *name, const result_t &result) {
+  printf("%-10s %9.4f %9.4f %9.1f %9d %9.0f\n", name, result.worstError, result.meanError,
+         result.meanEvaluations, result.maxEvaluations, result.time);
+}
+
+int main(int argc, char **argv) {
+  if(argc > 1) {
+    fprintf(stderr, "usage: integratorbench\n");
+    return 2;
+  }
+
+  buildCases();
+  printf("integratorbench: %d states\n", STATES);
+  printf("%-10s %9s %9s %9s %9s %9s\n", "method", "worst m", "mean m", "evals", "max", "ns");
+
+  result_t baseline = { 0, 0, 0, 0, 0 };
+  const int rk4Steps[] = { 4, 8, 16, 32 };
+  for(unsigned i=0; i<sizeof(rk4Steps) / sizeof(rk4Steps[0]); i++) {
+    int steps = rk4Steps[i];
+    result_t result = measure([steps](const case_t &c, int *n) { return predictRK4(c, steps, n); });
+
+    char name[16];
+    snprintf(name, sizeof(name), "rk4 %d", steps);
+    print(name, result);
+    if(steps == BASELINE_STEPS) baseline = result;
+  }
+
+  result_t predictor = { 0, 0, 0, 0, 0 };
+  const float tolerances[] = { 1e-4f, PREDICTOR_RTOL, 1e-6f };
+  for(unsigned i=0; i<sizeof(tolerances) / sizeof(tolerances[0]); i++) {
+    float rtol = tolerances[i];
+    result_t result = measure([rtol](const case_t &c, int *n) { return predictDP5(c, rtol, rtol * 100, n); });
+
+    char name[16];
+    snprintf(name, sizeof(name), "dp5 %.0e", rtol);
+    print(name, result);
+    if(rtol == PREDICTOR_RTOL) predictor = result;
+  }
+
+  if(!(predictor.worstError <= baseline.worstError) || predictor.meanEvaluations > baseline.meanEvaluations) {
+    fprintf(stderr, "integratorbench: dp5 at the predictor's tolerances doesn't beat rk4 %d\n", BASELINE_STEPS);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,122 @@
+// Flight log throughput benchmark for the Feather M0
+//
+// Usage: open this sketch in the Arduino IDE alongside the libraries of this
+// repository, upload it with a card in the slot and watch the serial monitor.
+//
+// Logs the same baro record for BENCH_DURATION in three ways and prints the
+// sustained records per second of each:
+//
+//   reopen    the old printJSON: open, println the fields and close per record
+//   file      Logger in file mode, one file held open and written in blocks
+//   recorder  Logger in recorder mode, streamed to a pre-erased contiguous file
+//
+// The logs are left on the card as ordinary numbered logs and a bench.txt.
+
+#include <SPI.h>
+#include <SD.h>
+
+#include <logger.h>
+#include <record.h>
+
+#define BENCH_DURATION 10000 // ms
+#define BENCH_FLUSH_INTERVAL 1000 // ms, as the flight's flush task
+#define BENCH_FILENAME "bench.txt"
+
+Logger logger;
+
+static baro_record_t sampleRecord(unsigned long count) {
+  baro_record_t baro;
+  baro.pressure = 101325 - (count & 0xFFF);
+  baro.temperature = 2150;
+  baro.altitude = count;
+  return baro;
+}
+
+static void report(const char *name, unsigned long records, unsigned long elapsed) {
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(records);
+  Serial.print(" records in ");
+  Serial.print(elapsed);
+  Serial.print(" ms, ");
+  Serial.print(records * 1000UL / elapsed);
+  Serial.println(" records/s");
+}
+
+static void benchReopen() {
+  unsigned long count = 0;
+  unsigned long start = millis();
+
+  while(millis() - start < BENCH_DURATION) {
+    baro_record_t baro = sampleRecord(count);
+
+    File file = SD.open(BENCH_FILENAME, FILE_WRITE);
+    if(!file) {
+      Serial.println("reopen: failed to open " BENCH_FILENAME);
+      return;
+    }
+    file.println(millis());
+    file.println(baro.pressure);
+    file.println(baro.temperature);
+    file.println(baro.altitude);
+    file.close();
+
+    count++;
+  }
+
+  report("reopen", count, millis() - start);
+}
+
+static void benchLogger(const char *name, int mode) {
+  logger.setMode(mode);
+  if(!logger.open()) {
+    Serial.print(name);
+    Serial.println(": failed to open log");
+    return;
+  }
+
+  unsigned long blocks = logger.getBlocksWritten();
+  unsigned long errors = logger.getWriteErrors();
+  unsigned long count = 0;
+  unsigned long start = millis();
+  unsigned long lastFlush = start;
+
+  while(millis() - start < BENCH_DURATION) {
+    baro_record_t baro = sampleRecord(count);
+    logger.log(RECORD_BARO, &baro, sizeof(baro));
+    count++;
+
+    if(millis() - lastFlush >= BENCH_FLUSH_INTERVAL) {
+      logger.flush();
+      lastFlush = millis();
+    }
+  }
+
+  unsigned long elapsed = millis() - start;
+  logger.close();
+
+  report(name, count, elapsed);
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(logger.getBlocksWritten() - blocks);
+  Serial.print(" blocks written, ");
+  Serial.print(logger.getWriteErrors() - errors);
+  Serial.println(" write errors");
+}
+
+void setup() {
+  Serial.begin(9600);
+  while(!Serial) {
+    delay(1);
+  }
+
+  Serial.println("Initializing SD card...");
+  logger.init();
+
+  benchReopen();
+  benchLogger("file", LOGGER_MODE_FILE);
+  benchLogger("recorder", LOGGER_MODE_RECORDER);
+}
+
+void loop() {
+}
@@ -0,0 +1,245 @@
+// Host-side decoder for binary Osprey flight logs (see libraries/Osprey/record.h)
+//
+// Build: g++ -O2 -o logdecode tools/logdecode/logdecode.cpp
+// Usage: logdecode [-f csv|json] [-t imu|baro|gps|event] FILE.log
+//
+// CSV output has one row per record. Without -t the columns after the record
+// type and time depend on the type, so pass -t for a rectangular table.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../libraries/Osprey/record.h"
+
+#define FORMAT_CSV 0
+#define FORMAT_JSON 1
+
+static int format = FORMAT_CSV;
+static int onlyType = -1;
+static int schema = RECORD_SCHEMA;
+
+// The log is little-endian regardless of the host
+static uint16_t readU16(const uint8_t *p) {
+  return p[0] | (p[1] << 8);
+}
+
+static uint32_t readU32(const uint8_t *p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int16_t readI16(const uint8_t *p) {
+  return (int16_t)readU16(p);
+}
+
+static int32_t readI32(const uint8_t *p) {
+  return (int32_t)readU32(p);
+}
+
+static const char* typeName(int type) {
+  switch(type) {
+    case RECORD_IMU: return "imu";
+    case RECORD_BARO: return "baro";
+    case RECORD_GPS: return "gps";
+    case RECORD_EVENT: return "event";
+    default: return "unknown";
+  }
+}
+
+static int typeFromName(const char *name) {
+  for(int type = RECORD_IMU; type <= RECORD_EVENT; type++) {
+    if(strcmp(name, typeName(type)) == 0) return type;
+  }
+
+  return -1;
+}
+
+static void printHeader(int type) {
+  switch(type) {
+    case RECORD_IMU:
+      printf("type,time_ms,accel_x_ms2,accel_y_ms2,accel_z_ms2,roll_deg,pitch_deg,heading_deg\n");
+      break;
+    case RECORD_BARO:
+      printf("type,time_ms,pressure_pa,temperature_c,altitude_m\n");
+      break;
+    case RECORD_GPS:
+      printf("type,time_ms,latitude_deg,longitude_deg,altitude_m,speed_knots,quality\n");
+      break;
+    case RECORD_EVENT:
+      printf("type,time_ms,kind,value\n");
+      break;
+    default:
+      printf("type,time_ms,...\n");
+      break;
+  }
+}
+
+// Same z-y-x angles the flight computer works out in attitude.cpp
+static void quaternionToEuler(const uint8_t *p, double *euler) {
+  double w = readI16(p + 0) / (double)RECORD_QUATERNION_SCALE;
+  double x = readI16(p + 2) / (double)RECORD_QUATERNION_SCALE;
+  double y = readI16(p + 4) / (double)RECORD_QUATERNION_SCALE;
+  double z = readI16(p + 6) / (double)RECORD_QUATERNION_SCALE;
+
+  double sinPitch = 2 * (w * y - z * x);
+  if(sinPitch > 1) sinPitch = 1;
+  if(sinPitch < -1) sinPitch = -1;
+
+  euler[0] = atan2(2 * (w * x + y * z), 1 - 2 * (x * x + y * y)) * 180 / M_PI;
+  euler[1] = asin(sinPitch) * 180 / M_PI;
+  euler[2] = atan2(2 * (w * z + x * y), 1 - 2 * (y * y + z * z)) * 180 / M_PI;
+  if(euler[2] < 0) euler[2] += 360;
+}
+
+// Each entry is printed as either a CSV column or a JSON member
+static void field(const char *name, double value, int decimals, int *first) {
+  if(format == FORMAT_JSON) {
+    printf("%s\"%s\": %.*f", *first ? "" : ", ", name, decimals, value);
+  } else {
+    printf("%s%.*f", *first ? "" : ",", decimals, value);
+  }
+
+  *first = 0;
+}
+
+static int decodeRecord(int type, uint32_t timestamp, const uint8_t *p, int length) {
+  int first = 1;
+
+  if(format == FORMAT_JSON) {
+    printf("{\"type\": \"%s\", ", typeName(type));
+  } else {
+    printf("%s,", typeName(type));
+  }
+  field("time_ms", timestamp, 0, &first);
+
+  switch(type) {
+    case RECORD_IMU:
+      if(length < (schema == 1 ? 12 : (int)sizeof(imu_record_t))) return 0;
+      field("accel_x_ms2", readI16(p + 0) / 100.0, 2, &first);
+      field("accel_y_ms2", readI16(p + 2) / 100.0, 2, &first);
+      field("accel_z_ms2", readI16(p + 4) / 100.0, 2, &first);
+      if(schema == 1) {
+        field("roll_deg", readI16(p + 6) / 100.0, 2, &first);
+        field("pitch_deg", readI16(p + 8) / 100.0, 2, &first);
+        field("heading_deg", readI16(p + 10) / 100.0, 2, &first);
+      } else {
+        double euler[3];
+        quaternionToEuler(p + 6, euler);
+        field("roll_deg", euler[0], 2, &first);
+        field("pitch_deg", euler[1], 2, &first);
+        field("heading_deg", euler[2], 2, &first);
+      }
+      break;
+    case RECORD_BARO:
+      if(length < (int)sizeof(baro_record_t)) return 0;
+      field("pressure_pa", readI32(p + 0), 0, &first);
+      field("temperature_c", readI16(p + 4) / 100.0, 2, &first);
+      field("altitude_m", readI32(p + 6) / 100.0, 2, &first);
+      break;
+    case RECORD_GPS:
+      if(length < (int)sizeof(gps_record_t)) return 0;
+      field("latitude_deg", readI32(p + 0) / 1e7, 7, &first);
+      field("longitude_deg", readI32(p + 4) / 1e7, 7, &first);
+      field("altitude_m", readI32(p + 8) / 100.0, 2, &first);
+      field("speed_knots", readU16(p + 12) / 100.0, 2, &first);
+      field("quality", p[14], 0, &first);
+      break;
+    case RECORD_EVENT:
+      if(length < (int)sizeof(event_record_t)) return 0;
+      field("kind", p[0], 0, &first);
+      field("value", p[1], 0, &first);
+      break;
+    default:
+      break;
+  }
+
+  printf(format == FORMAT_JSON ? "}\n" : "\n");
+  return 1;
+}
+
+static int decode(FILE *in) {
+  uint8_t buffer[sizeof(log_header_t)];
+
+  if(fread(buffer, sizeof(log_header_t), 1, in) != 1 || readU32(buffer) != RECORD_MAGIC) {
+    fprintf(stderr, "logdecode: not an Osprey binary log\n");
+    return 0;
+  }
+
+  uint16_t version = readU16(buffer + 4);
+  schema = readU16(buffer + 6);
+  if(version != RECORD_VERSION || schema < 1 || schema > RECORD_SCHEMA) {
+    fprintf(stderr, "logdecode: unsupported log version %u schema %u\n", version, schema);
+    return 0;
+  }
+
+  if(format == FORMAT_CSV && onlyType > 0) {
+    printHeader(onlyType);
+  }
+
+  unsigned long records = 0;
+  uint8_t header[sizeof(record_header_t)];
+  uint8_t payload[256];
+
+  while(fread(header, sizeof(record_header_t), 1, in) == 1) {
+    int type = header[0];
+    int length = header[1];
+
+    // Padding or erased space after the last record
+    if(type == RECORD_END || type == RECORD_ERASED) break;
+
+    if(length > 0 && fread(payload, length, 1, in) != 1) {
+      fprintf(stderr, "logdecode: truncated record after %lu records\n", records);
+      break;
+    }
+
+    records++;
+    if(onlyType > 0 && type != onlyType) continue;
+
+    if(!decodeRecord(type, readU32(header + 2), payload, length)) {
+      fprintf(stderr, "logdecode: short %s record\n", typeName(type));
+    }
+  }
+
+  fprintf(stderr, "logdecode: %lu records\n", records);
+  return 1;
+}
+
+static void usage() {
+  fprintf(stderr, "usage: logdecode [-f csv|json] [-t imu|baro|gps|event] FILE.log\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  const char *path = NULL;
+
+  for(int i=1; i<argc; i++) {
+    if(strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+      i++;
+      if(strcmp(argv[i], "json") == 0) format = FORMAT_JSON;
+      else if(strcmp(argv[i], "csv") == 0) format = FORMAT_CSV;
+      else usage();
+    } else if(strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      onlyType = typeFromName(argv[++i]);
+      if(onlyType < 0) usage();
+    } else if(argv[i][0] == '-' || path) {
+      usage();
+    } else {
+      path = argv[i];
+    }
+  }
+
+  if(!path) usage();
+
+  FILE *in = fopen(path, "rb");
+  if(!in) {
+    perror(path);
+    return 1;
+  }
+
+  int ok = decode(in);
+  fclose(in);
+
+  return (ok ? 0 : 1);
+}
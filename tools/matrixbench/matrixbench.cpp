@@ -0,0 +1,291 @@
+// Host benchmark for the fixed size matrices (see libraries/Osprey/fixed_matrix.h)
+//
+// Build: g++ -O2 -Ilibraries/Osprey -Ilibraries/Adafruit_BNO055/utility -o matrixbench tools/matrixbench/matrixbench.cpp
+// Usage: matrixbench [-n STEPS]
+//
+// Runs the altitude estimator's covariance through STEPS (default 1000000)
+// predict and correct cycles three ways: with hand written float loops, the
+// estimator's old propagation and the Joseph update written out the same
+// way, with the BNO055 library's imu::Matrix, which is what the tree had for
+// matrices, and with Osprey::Matrix. Each cycle is
+// P = F P F' + Q for a jittered dt and a Joseph form update for a barometer
+// altitude measurement, as AltitudeEstimator does.
+//
+// The three covariances are compared at the end and the time per cycle and
+// per propagation alone is printed for each. imu::Matrix only comes in
+// double, so it is no measure of what the M0 would pay for it, but the
+// other two are both float. Exits non-zero if the results disagree.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "fixed_matrix.h"
+#include "matrix.h"
+
+#define STATES 3
+#define DEFAULT_STEPS 1000000
+
+#define DT 0.01f            // s, the estimator's update period
+#define DT_JITTER 0.002f    // s
+#define JERK_NOISE 100.0f   // (m/s^3)^2 / Hz
+#define BARO_VARIANCE 1.0f  // m^2
+#define INITIAL_VARIANCE 100.0f
+#define TOLERANCE 1e-4      // relative, float against double
+
+typedef Osprey::Matrix<float, STATES, STATES> FixedMatrix;
+
+// The same dt sequence for every run, without calling rand() in the loops
+static float dts[256];
+
+static void fillDts() {
+  srand(1);
+  for(int i=0; i<256; i++) {
+    dts[i] = DT + DT_JITTER * (2.0f * rand() / RAND_MAX - 1);
+  }
+}
+
+static void processNoise(float dt, float Q[STATES][STATES]) {
+  float dt2 = dt * dt;
+  float dt3 = dt2 * dt;
+  float q = JERK_NOISE;
+  Q[0][0] = q * dt3 * dt2 / 20;
+  Q[0][1] = Q[1][0] = q * dt3 * dt / 8;
+  Q[0][2] = Q[2][0] = q * dt3 / 6;
+  Q[1][1] = q * dt3 / 3;
+  Q[1][2] = Q[2][1] = q * dt2 / 2;
+  Q[2][2] = q * dt;
+}
+
+static void transition(float dt, float F[STATES][STATES]) {
+  memset(F, 0, sizeof(float) * STATES * STATES);
+  F[0][0] = F[1][1] = F[2][2] = 1;
+  F[0][1] = F[1][2] = dt;
+  F[0][2] = dt * dt / 2;
+}
+
+static double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Hand written loops as estimator.cpp had them, in a struct so it can be
+// copied like the others
+
+typedef struct LoopsMatrix {
+  float m[STATES][STATES];
+  float operator()(int i, int j) const { return m[i][j]; }
+} LoopsMatrix;
+
+static void loopsPredict(LoopsMatrix &matrix, float dt) {
+  float (&P)[STATES][STATES] = matrix.m;
+  float F[STATES][STATES], Q[STATES][STATES], FP[STATES][STATES];
+  transition(dt, F);
+  processNoise(dt, Q);
+
+  for(int i=0; i<STATES; i++) {
+    for(int j=0; j<STATES; j++) {
+      FP[i][j] = 0;
+      for(int k=0; k<STATES; k++) {
+        FP[i][j] += F[i][k] * P[k][j];
+      }
+    }
+  }
+
+  for(int i=0; i<STATES; i++) {
+    for(int j=0; j<STATES; j++) {
+      float sum = Q[i][j];
+      for(int k=0; k<STATES; k++) {
+        sum += FP[i][k] * F[j][k];
+      }
+      P[i][j] = sum;
+    }
+  }
+}
+
+static void loopsCorrect(LoopsMatrix &matrix, float variance) {
+  float (&P)[STATES][STATES] = matrix.m;
+  float K[STATES], A[STATES][STATES], AP[STATES][STATES];
+  float S = P[0][0] + variance;
+  for(int i=0; i<STATES; i++) {
+    K[i] = P[i][0] / S;
+  }
+
+  // P = (I - K H) P (I - K H)' + K R K'
+  for(int i=0; i<STATES; i++) {
+    for(int j=0; j<STATES; j++) {
+      A[i][j] = (i == j) - (j == 0 ? K[i] : 0);
+    }
+  }
+  for(int i=0; i<STATES; i++) {
+    for(int j=0; j<STATES; j++) {
+      AP[i][j] = 0;
+      for(int k=0; k<STATES; k++) {
+        AP[i][j] += A[i][k] * P[k][j];
+      }
+    }
+  }
+  for(int i=0; i<STATES; i++) {
+    for(int j=0; j<STATES; j++) {
+      float sum = K[i] * variance * K[j];
+      for(int k=0; k<STATES; k++) {
+        sum += AP[i][k] * A[j][k];
+      }
+      P[i][j] = sum;
+    }
+  }
+}
+
+// imu::Matrix
+
+static void imuPredict(imu::Matrix<STATES> &P, float dt) {
+  float f[STATES][STATES], q[STATES][STATES];
+  transition(dt, f);
+  processNoise(dt, q);
+
+  imu::Matrix<STATES> F, Q;
+  for(int i=0; i<STATES; i++) {
+    for(int j=0; j<STATES; j++) {
+      F(i, j) = f[i][j];
+      Q(i, j) = q[i][j];
+    }
+  }
+
+  P = F * P * F.transpose() + Q;
+}
+
+static void imuCorrect(imu::Matrix<STATES> &P, float variance) {
+  double S = P(0, 0) + variance;
+
+  imu::Matrix<STATES> K, H, R, I;
+  for(int i=0; i<STATES; i++) {
+    K(i, 0) = P(i, 0) / S;
+    I(i, i) = 1;
+  }
+  H(0, 0) = 1;
+  R(0, 0) = variance;
+
+  imu::Matrix<STATES> A = I - K * H;
+  P = A * P * A.transpose() + K * R * K.transpose();
+}
+
+// Osprey::Matrix, as AltitudeEstimator uses it
+
+static void fixedPredict(FixedMatrix &P, float dt) {
+  float f[STATES][STATES], q[STATES][STATES];
+  transition(dt, f);
+  processNoise(dt, q);
+
+  FixedMatrix F, Q;
+  for(int i=0; i<STATES; i++) {
+    for(int j=0; j<STATES; j++) {
+      F(i, j) = f[i][j];
+      Q(i, j) = q[i][j];
+    }
+  }
+
+  Osprey::propagateCovariance(P, F, Q);
+}
+
+static void fixedCorrect(FixedMatrix &P, float variance) {
+  Osprey::Matrix<float, 1, STATES> H;
+  H(0, 0) = 1;
+  Osprey::Matrix<float, 1, 1> R;
+  R(0, 0) = variance;
+
+  float S = P(0, 0) + variance;
+  Osprey::Vector<float, STATES> K = P * Osprey::transpose(H) * (1 / S);
+  Osprey::josephUpdate(P, K, H, R);
+}
+
+// ns per predict and correct cycle, run on P. Then ns per propagation
+// alone, run on copies of the steady state P so it can't grow without bound.
+template<typename M, typename Predict, typename Correct>
+static void run(M &P, long steps, Predict predict, Correct correct, double *cycleTime, double *predictTime) {
+  double start = now();
+  for(long i=0; i<steps; i++) {
+    predict(P, dts[i & 0xFF]);
+    correct(P, BARO_VARIANCE);
+  }
+  *cycleTime = (now() - start) * 1e9 / steps;
+
+  volatile float sink = 0;
+  start = now();
+  for(long i=0; i<steps; i++) {
+    M copy = P;
+    predict(copy, dts[i & 0xFF]);
+    sink = sink + copy(0, 0);
+  }
+  *predictTime = (now() - start) * 1e9 / steps;
+}
+
+static double difference(double a, double b) {
+  return fabs(a - b) / (fabs(b) > 1e-12 ? fabs(b) : 1e-12);
+}
+
+static void usage() {
+  fprintf(stderr, "usage: matrixbench [-n STEPS]\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  long steps = DEFAULT_STEPS;
+
+  for(int i=1; i<argc; i++) {
+    if(strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      steps = atol(argv[++i]);
+      if(steps < 1) usage();
+    } else {
+      usage();
+    }
+  }
+
+  fillDts();
+
+  LoopsMatrix loopsP = {};
+  imu::Matrix<STATES> imuP;
+  FixedMatrix fixedP;
+  for(int i=0; i<STATES; i++) {
+    loopsP.m[i][i] = INITIAL_VARIANCE;
+    imuP(i, i) = INITIAL_VARIANCE;
+    fixedP(i, i) = INITIAL_VARIANCE;
+  }
+
+  double loopsCycleTime, loopsPredictTime;
+  double imuCycleTime, imuPredictTime;
+  double fixedCycleTime, fixedPredictTime;
+
+  run(loopsP, steps, loopsPredict, loopsCorrect, &loopsCycleTime, &loopsPredictTime);
+  run(imuP, steps, imuPredict, imuCorrect, &imuCycleTime, &imuPredictTime);
+  run(fixedP, steps, fixedPredict, fixedCorrect, &fixedCycleTime, &fixedPredictTime);
+
+  double worstLoops = 0, worstFixed = 0;
+  for(int i=0; i<STATES; i++) {
+    for(int j=0; j<STATES; j++) {
+      double loops = difference(loopsP(i, j), imuP(i, j));
+      double fixed = difference(fixedP(i, j), imuP(i, j));
+      if(loops > worstLoops) worstLoops = loops;
+      if(fixed > worstFixed) worstFixed = fixed;
+    }
+  }
+
+  printf("matrixbench: %ld cycles, steady state altitude variance %.4f m^2\n", steps, imuP(0, 0));
+  printf("matrixbench: %-14s %8.1f ns per cycle %8.1f ns per propagation\n",
+         "loops", loopsCycleTime, loopsPredictTime);
+  printf("matrixbench: %-14s %8.1f ns per cycle %8.1f ns per propagation\n",
+         "imu::Matrix", imuCycleTime, imuPredictTime);
+  printf("matrixbench: %-14s %8.1f ns per cycle %8.1f ns per propagation\n",
+         "Osprey::Matrix", fixedCycleTime, fixedPredictTime);
+  printf("matrixbench: largest relative difference from imu::Matrix %.2g for loops, %.2g for Osprey::Matrix\n",
+         worstLoops, worstFixed);
+
+  if(worstLoops > TOLERANCE || worstFixed > TOLERANCE) {
+    fprintf(stderr, "matrixbench: covariances disagree by more than %g\n", TOLERANCE);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,459 @@
+// Monte Carlo dispersion of the coast from burnout, using the point mass
+// model of libraries/Osprey/airbrake.cpp
+//
+// Build: g++ -O3 -march=native -ffast-math -pthread -o montecarlo tools/montecarlo/montecarlo.cpp
+// Usage: montecarlo [-n RUNS] [-j THREADS] [-s SEED] [-b] [-d DT] [-z ALT] [-v SPEED] [-g ALT] [-o RUNS.csv]
+//
+// Every run disperses the mass, drag coefficient, the rest of the ballistic
+// coefficient, the wind and the rail angle, then flies from burnout to the
+// ground with the brakes closed (open with -b). Nothing slows the descent, so
+// the landing points are the ballistic worst case range safety asks for.
+// Apogee and landing statistics go to stdout and -o writes one CSV row per
+// run.
+//
+// The dynamics are Truth_gravdiffeq_air_brake with drag taken relative to the
+// wind. Runs are flown BATCH at a time with the state kept as one array per
+// component, so every RK4 stage is a plain loop over the batch that the
+// compiler turns into SIMD (-ffast-math lets GCC call glibc's vector expf).
+// Threads take batches from their own queue and steal from the others when it
+// runs dry. Each run draws its random numbers from a generator seeded with
+// the seed and the run number only, so the results don't depend on the
+// thread count.
+//
+// Density only follows the lowest band of the model (below 25 km). Runs that
+// leave it are counted and reported.
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <math.h>
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "../../libraries/Osprey/airbrake.h"
+
+#define BATCH 64
+#define DEFAULT_RUNS 100000
+#define DEFAULT_SEED 1
+#define DEFAULT_DT 0.02f        // s
+#define MAX_TIME 600.0f         // s, a run still flying by then is dropped
+
+// Nominal burnout
+#define BURNOUT_ALTITUDE 500.0f // m above the pad
+#define BURNOUT_SPEED 430.0f    // m/s along the rail
+#define GROUND_ALTITUDE 0.0f    // m above sea level
+
+// Dispersions, one sigma
+#define MASS_SIGMA 0.3f         // kg
+#define CD_SIGMA 0.05f          // fraction of Cd
+#define BAL_COEFF_SIGMA 0.03f   // fraction, for reference area and model error
+#define WIND_MEAN 4.0f          // m/s
+#define WIND_SIGMA 2.0f         // m/s
+#define RAIL_ANGLE 5.0f         // degrees from vertical
+#define RAIL_ANGLE_SIGMA 1.0f   // degrees
+
+#define DEG_TO_RAD 0.017453292519943295f
+
+// State components
+#define STATE_EAST 0
+#define STATE_NORTH 1
+#define STATE_UP 2
+#define STATE_V_EAST 3
+#define STATE_V_NORTH 4
+#define STATE_V_UP 5
+#define STATE_COUNT 6
+
+struct State {
+  float v[STATE_COUNT][BATCH];
+};
+
+// What stays constant through a batch
+struct Forcing {
+  float balCoeff[BATCH];  // m^2/kg
+  float windEast[BATCH];  // m/s
+  float windNorth[BATCH]; // m/s
+};
+
+struct Run {
+  float mass;         // kg
+  float cd;
+  float balCoeff;     // m^2/kg
+  float windSpeed;    // m/s
+  float windFrom;     // degrees clockwise from north
+  float railAngle;    // degrees from vertical
+  float railAzimuth;  // degrees clockwise from north
+  float apogee;       // m above the pad
+  float apogeeTime;   // s after burnout
+  float landingEast;  // m from the pad
+  float landingNorth; // m from the pad
+  float landingTime;  // s after burnout
+  int landed;
+  int leftBand;       // went above the lowest density band
+};
+
+struct Config {
+  long runs;
+  int threads;
+  uint64_t seed;
+  int brakesOpen;
+  float dt;
+  float burnoutAltitude;
+  float burnoutSpeed;
+  float groundAltitude;
+  const char *csvPath;
+};
+
+// splitmix64, which is fine seeded with consecutive numbers
+struct Random {
+  uint64_t state;
+
+  Random(uint64_t seed, uint64_t run) : state(seed ^ (run * 0x9E3779B97F4A7C15ULL)) {}
+
+  uint64_t next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  // [0, 1)
+  double uniform() {
+    return (next() >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+  // Box-Muller, throwing the second value away
+  double normal() {
+    double u = 1 - uniform();
+    return sqrt(-2 * log(u)) * cos(2 * M_PI * uniform());
+  }
+};
+
+static void disperse(const Config &config, long index, Run &run) {
+  Random random(config.seed, index);
+
+  float cd = config.brakesOpen ? Cd_OPEN : Cd_CLOSED;
+  float area = config.brakesOpen ? A_ref_OPEN : A_ref_CLOSED;
+
+  memset(&run, 0, sizeof(run));
+  run.mass = MASS_ROCKET + MASS_SIGMA * random.normal();
+  run.cd = cd * (1 + CD_SIGMA * random.normal());
+  run.balCoeff = run.cd * area / (2 * run.mass) * (1 + BAL_COEFF_SIGMA * random.normal());
+  run.windSpeed = fabs(WIND_MEAN + WIND_SIGMA * random.normal());
+  run.windFrom = 360 * random.uniform();
+  run.railAngle = fabs(RAIL_ANGLE + RAIL_ANGLE_SIGMA * random.normal());
+  run.railAzimuth = 360 * random.uniform();
+}
+
+// Derivative of every run in the batch
+static void derivative(const State &x, const Forcing &forcing, float groundAltitude, State &dx) {
+  for(int i=0; i<BATCH; i++) {
+    float altitude = fmaxf(groundAltitude + x.v[STATE_UP][i], 0);
+    float rho = RHO_SEA_LEVEL * expf(altitude * (-1 / (1000 * SCALE_HEIGHT_LOW)));
+
+    float airEast = x.v[STATE_V_EAST][i] - forcing.windEast[i];
+    float airNorth = x.v[STATE_V_NORTH][i] - forcing.windNorth[i];
+    float airUp = x.v[STATE_V_UP][i];
+    float airSpeed = sqrtf(airEast * airEast + airNorth * airNorth + airUp * airUp);
+    float drag = rho * airSpeed * forcing.balCoeff[i];
+
+    dx.v[STATE_EAST][i] = x.v[STATE_V_EAST][i];
+    dx.v[STATE_NORTH][i] = x.v[STATE_V_NORTH][i];
+    dx.v[STATE_UP][i] = x.v[STATE_V_UP][i];
+    dx.v[STATE_V_EAST][i] = -drag * airEast;
+    dx.v[STATE_V_NORTH][i] = -drag * airNorth;
+    dx.v[STATE_V_UP][i] = -drag * airUp - GRAV;
+  }
+}
+
+// out = x + h dx
+static void advance(const State &x, float h, const State &dx, State &out) {
+  const float *a = &x.v[0][0];
+  const float *b = &dx.v[0][0];
+  float *c = &out.v[0][0];
+  for(int i=0; i<STATE_COUNT * BATCH; i++) {
+    c[i] = a[i] + h * b[i];
+  }
+}
+
+static void rk4(State &x, const Forcing &forcing, float groundAltitude, float dt) {
+  State k1, k2, k3, k4, y;
+
+  derivative(x, forcing, groundAltitude, k1);
+  advance(x, dt / 2, k1, y);
+  derivative(y, forcing, groundAltitude, k2);
+  advance(x, dt / 2, k2, y);
+  derivative(y, forcing, groundAltitude, k3);
+  advance(x, dt, k3, y);
+  derivative(y, forcing, groundAltitude, k4);
+
+  float *a = &x.v[0][0];
+  const float *b1 = &k1.v[0][0], *b2 = &k2.v[0][0], *b3 = &k3.v[0][0], *b4 = &k4.v[0][0];
+  for(int i=0; i<STATE_COUNT * BATCH; i++) {
+    a[i] += dt / 6 * (b1[i] + 2 * (b2[i] + b3[i]) + b4[i]);
+  }
+}
+
+// Flies runs [first, first + count), count <= BATCH
+static void flyBatch(const Config &config, long first, int count, Run *runs) {
+  State x;
+  Forcing forcing;
+
+  for(int i=0; i<BATCH; i++) {
+    // Spare lanes fly a copy of the first run and are never written back
+    Run &run = runs[i < count ? i : 0];
+    if(i < count) {
+      disperse(config, first + i, run);
+    }
+
+    float tilt = run.railAngle * DEG_TO_RAD;
+    float azimuth = run.railAzimuth * DEG_TO_RAD;
+    float windFrom = run.windFrom * DEG_TO_RAD;
+
+    x.v[STATE_EAST][i] = 0;
+    x.v[STATE_NORTH][i] = 0;
+    x.v[STATE_UP][i] = config.burnoutAltitude;
+    x.v[STATE_V_EAST][i] = config.burnoutSpeed * sinf(tilt) * sinf(azimuth);
+    x.v[STATE_V_NORTH][i] = config.burnoutSpeed * sinf(tilt) * cosf(azimuth);
+    x.v[STATE_V_UP][i] = config.burnoutSpeed * cosf(tilt);
+
+    forcing.balCoeff[i] = run.balCoeff;
+    forcing.windEast[i] = -run.windSpeed * sinf(windFrom);
+    forcing.windNorth[i] = -run.windSpeed * cosf(windFrom);
+  }
+
+  float bandTop = h_LOW_BAND_TOP * 1000 - config.groundAltitude;
+  float dt = config.dt;
+  int flying = count;
+
+  for(float t=0; flying > 0 && t < MAX_TIME; t += dt) {
+    float east[BATCH], north[BATCH], up[BATCH], vUp[BATCH];
+    memcpy(east, x.v[STATE_EAST], sizeof(east));
+    memcpy(north, x.v[STATE_NORTH], sizeof(north));
+    memcpy(up, x.v[STATE_UP], sizeof(up));
+    memcpy(vUp, x.v[STATE_V_UP], sizeof(vUp));
+
+    rk4(x, forcing, config.groundAltitude, dt);
+
+    for(int i=0; i<count; i++) {
+      Run &run = runs[i];
+      if(run.landed) continue;
+
+      // Apogee from a parabola through the step where the climb stopped
+      float v0 = vUp[i], v1 = x.v[STATE_V_UP][i];
+      if(v0 > 0 && v1 <= 0) {
+        float tau = dt * v0 / (v0 - v1);
+        run.apogee = up[i] + v0 * tau + (v1 - v0) / dt * tau * tau / 2;
+        run.apogeeTime = t + tau;
+        run.leftBand = run.apogee > bandTop;
+      }
+
+      float z0 = up[i], z1 = x.v[STATE_UP][i];
+      if(z1 <= 0) {
+        float f = z0 / (z0 - z1);
+        run.landingEast = east[i] + f * (x.v[STATE_EAST][i] - east[i]);
+        run.landingNorth = north[i] + f * (x.v[STATE_NORTH][i] - north[i]);
+        run.landingTime = t + f * dt;
+        run.landed = 1;
+        flying--;
+      }
+    }
+  }
+}
+
+// One thread's batches. The owner takes from the front and thieves from the
+// back, so the owner keeps working through neighbouring runs.
+struct WorkQueue {
+  std::mutex lock;
+  std::deque<long> batches;
+
+  bool take(long &batch) {
+    std::lock_guard<std::mutex> guard(lock);
+    if(batches.empty()) return false;
+    batch = batches.front();
+    batches.pop_front();
+    return true;
+  }
+
+  bool steal(long &batch) {
+    std::lock_guard<std::mutex> guard(lock);
+    if(batches.empty()) return false;
+    batch = batches.back();
+    batches.pop_back();
+    return true;
+  }
+};
+
+static void worker(const Config &config, std::vector<WorkQueue> &queues, int self, Run *runs) {
+  int threads = queues.size();
+
+  for(;;) {
+    long batch;
+    bool found = queues[self].take(batch);
+
+    // Nothing is ever added, so one fruitless pass over the others means
+    // everything has been handed out
+    for(int i=1; !found && i<threads; i++) {
+      found = queues[(self + i) % threads].steal(batch);
+    }
+    if(!found) return;
+
+    long first = batch * BATCH;
+    int count = (int)std::min((long)BATCH, config.runs - first);
+    flyBatch(config, first, count, runs + first);
+  }
+}
+
+static void flyAll(const Config &config, Run *runs) {
+  long batches = (config.runs + BATCH - 1) / BATCH;
+  std::vector<WorkQueue> queues(config.threads);
+
+  // Contiguous shares to start with
+  for(long b=0; b<batches; b++) {
+    queues[b * config.threads / batches].batches.push_back(b);
+  }
+
+  std::vector<std::thread> threads;
+  for(int i=1; i<config.threads; i++) {
+    threads.push_back(std::thread(worker, std::cref(config), std::ref(queues), i, runs));
+  }
+  worker(config, queues, 0, runs);
+
+  for(size_t i=0; i<threads.size(); i++) {
+    threads[i].join();
+  }
+}
+
+static void printStats(const char *name, std::vector<float> values) {
+  if(values.empty()) return;
+  std::sort(values.begin(), values.end());
+
+  double sum = 0, sumSquares = 0;
+  for(size_t i=0; i<values.size(); i++) {
+    sum += values[i];
+    sumSquares += (double)values[i] * values[i];
+  }
+  double mean = sum / values.size();
+  double sd = sqrt(fmax(sumSquares / values.size() - mean * mean, 0));
+
+  size_t last = values.size() - 1;
+  printf("%-16s %9.1f %8.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n", name, mean, sd, values[0],
+         values[last * 5 / 100], values[last / 2], values[last * 95 / 100], values[last]);
+}
+
+static void printSummary(const Config &config, const Run *runs, double seconds) {
+  std::vector<float> apogee, apogeeTime, range, landingTime;
+  double east = 0, north = 0;
+  long leftBand = 0;
+
+  for(long i=0; i<config.runs; i++) {
+    const Run &run = runs[i];
+    if(run.leftBand) leftBand++;
+    if(!run.landed) continue;
+
+    apogee.push_back(run.apogee);
+    apogeeTime.push_back(run.apogeeTime);
+    range.push_back(hypotf(run.landingEast, run.landingNorth));
+    landingTime.push_back(run.landingTime);
+    east += run.landingEast;
+    north += run.landingNorth;
+  }
+
+  printf("%ld runs in %.2f s on %d threads, %.0f runs/min\n", config.runs, seconds, config.threads,
+         config.runs / seconds * 60);
+  printf("brakes %s, burnout at %.0f m and %.0f m/s\n", config.brakesOpen ? "open" : "closed",
+         config.burnoutAltitude, config.burnoutSpeed);
+  printf("%-16s %9s %8s %9s %9s %9s %9s %9s\n", "", "mean", "sd", "min", "p5", "p50", "p95", "max");
+  printStats("apogee m", apogee);
+  printStats("apogee time s", apogeeTime);
+  printStats("landing range m", range);
+  printStats("landing time s", landingTime);
+
+  if(!range.empty()) {
+    printf("mean landing point %.1f m east, %.1f m north\n", east / range.size(), north / range.size());
+  }
+  if(range.size() < (size_t)config.runs) {
+    printf("%ld runs still flying after %.0f s were left out\n", config.runs - (long)range.size(), MAX_TIME);
+  }
+  if(leftBand) {
+    printf("%ld runs went above %.0f km, where the density model isn't followed\n", leftBand, h_LOW_BAND_TOP);
+  }
+}
+
+static int writeCsv(const Config &config, const Run *runs) {
+  FILE *file = fopen(config.csvPath, "w");
+  if(!file) {
+    fprintf(stderr, "montecarlo: can't write %s\n", config.csvPath);
+    return 0;
+  }
+
+  fprintf(file, "run,mass,cd,bal_coeff,wind_speed,wind_from,rail_angle,rail_azimuth,"
+                "apogee,apogee_time,landing_east,landing_north,landing_time,landed\n");
+  for(long i=0; i<config.runs; i++) {
+    const Run &run = runs[i];
+    fprintf(file, "%ld,%.3f,%.4f,%.6g,%.2f,%.1f,%.2f,%.1f,%.1f,%.2f,%.1f,%.1f,%.2f,%d\n", i,
+            run.mass, run.cd, run.balCoeff, run.windSpeed, run.windFrom, run.railAngle, run.railAzimuth,
+            run.apogee, run.apogeeTime, run.landingEast, run.landingNorth, run.landingTime, run.landed);
+  }
+
+  return fclose(file) == 0;
+}
+
+static void usage() {
+  fprintf(stderr, "usage: montecarlo [-n RUNS] [-j THREADS] [-s SEED] [-b] [-d DT] [-z ALT] [-v SPEED] [-g ALT] [-o RUNS.csv]\n");
+  exit(1);
+}
+
+int main(int argc, char **argv) {
+  Config config;
+  config.runs = DEFAULT_RUNS;
+  config.threads = std::max(1u, std::thread::hardware_concurrency());
+  config.seed = DEFAULT_SEED;
+  config.brakesOpen = 0;
+  config.dt = DEFAULT_DT;
+  config.burnoutAltitude = BURNOUT_ALTITUDE;
+  config.burnoutSpeed = BURNOUT_SPEED;
+  config.groundAltitude = GROUND_ALTITUDE;
+  config.csvPath = NULL;
+
+  for(int i=1; i<argc; i++) {
+    const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+    if(strcmp(argv[i], "-b") == 0) {
+      config.brakesOpen = 1;
+      continue;
+    }
+    if(!value) usage();
+
+    if(strcmp(argv[i], "-n") == 0) config.runs = atol(value);
+    else if(strcmp(argv[i], "-j") == 0) config.threads = atoi(value);
+    else if(strcmp(argv[i], "-s") == 0) config.seed = strtoull(value, NULL, 0);
+    else if(strcmp(argv[i], "-d") == 0) config.dt = atof(value);
+    else if(strcmp(argv[i], "-z") == 0) config.burnoutAltitude = atof(value);
+    else if(strcmp(argv[i], "-v") == 0) config.burnoutSpeed = atof(value);
+    else if(strcmp(argv[i], "-g") == 0) config.groundAltitude = atof(value);
+    else if(strcmp(argv[i], "-o") == 0) config.csvPath = value;
+    else usage();
+    i++;
+  }
+
+  if(config.runs <= 0 || config.threads <= 0 || config.dt <= 0 || config.burnoutAltitude <= 0) usage();
+
+  std::vector<Run> runs(config.runs);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  flyAll(config, runs.data());
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  printSummary(config, runs.data(), elapsed.count());
+
+  if(config.csvPath && !writeCsv(config, runs.data())) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,123 @@
+// Host benchmark for the flight computer's NMEA parser (see libraries/Osprey/nmea.h)
+//
+// Build: g++ -O2 -Ilibraries/Osprey -o nmeabench tools/nmeabench/nmeabench.cpp libraries/Osprey/nmea.cpp
+// Usage: nmeabench [-n PASSES] [-f] FILE.nmea
+//
+// Feeds a recorded NMEA stream through the parser byte by byte, as GPS::update
+// does, PASSES times (default 100) and prints the counts and the time per
+// byte, sentence and fix. With -f the fixes of the first pass are printed as
+// CSV so the parse can be checked against the recording.
+//
+// flight.nmea beside this file is 12 s of a receiver at 5 Hz in the board's
+// format, from cold start through a boost, with a corrupted checksum, a
+// sentence cut short and the sentences the parser skips. flight.csv holds its
+// fixes, worked out from the sentences rather than by the parser, so
+//
+//   nmeabench -n 1 -f tools/nmeabench/flight.nmea | diff - tools/nmeabench/flight.csv
+//
+// prints nothing if every fix matches.
+//
+// Host time is no measure of the SAMD21's, but the parser does no floating
+// point and only a few integer divisions per sentence, so the host's numbers
+// do show where its time goes.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "nmea.h"
+
+#define DEFAULT_PASSES 100
+
+static void printFix(const gps_fix_t &fix) {
+  printf("20%02u-%02u-%02uT%02u:%02u:%02u.%03uZ,%.7f,%.7f,%.2f,%.2f,%u,%u\n",
+         fix.year, fix.month, fix.day, fix.hour, fix.minute, fix.second, fix.millis,
+         fix.latitude / 1e7, fix.longitude / 1e7, fix.altitude / 100.0, fix.speed / 100.0,
+         fix.quality, fix.satellites);
+}
+
+static double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void usage() {
+  fprintf(stderr, "usage: nmeabench [-n PASSES] [-f] FILE.nmea\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  const char *path = NULL;
+  long passes = DEFAULT_PASSES;
+  bool fixes = false;
+
+  for(int i=1; i<argc; i++) {
+    if(strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      passes = atol(argv[++i]);
+      if(passes < 1) usage();
+    } else if(strcmp(argv[i], "-f") == 0) {
+      fixes = true;
+    } else if(argv[i][0] == '-' || path) {
+      usage();
+    } else {
+      path = argv[i];
+    }
+  }
+
+  if(!path) usage();
+
+  FILE *in = fopen(path, "rb");
+  if(!in) {
+    perror(path);
+    return 1;
+  }
+
+  std::vector<char> stream;
+  char buffer[4096];
+  size_t length;
+  while((length = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+    stream.insert(stream.end(), buffer, buffer + length);
+  }
+  fclose(in);
+
+  if(fixes) {
+    Osprey::NmeaParser parser;
+    printf("time,latitude_deg,longitude_deg,altitude_m,speed_knots,quality,satellites\n");
+    for(size_t i=0; i<stream.size(); i++) {
+      if(parser.feed(stream[i])) printFix(parser.getFix());
+    }
+  }
+
+  // A fresh parser each pass, so every pass does the same work
+  Osprey::NmeaParser parser;
+  unsigned long sentences = 0, errors = 0, published = 0;
+  volatile int32_t sink = 0;
+  double start = now();
+
+  for(long pass=0; pass<passes; pass++) {
+    parser = Osprey::NmeaParser();
+    for(size_t i=0; i<stream.size(); i++) {
+      if(parser.feed(stream[i])) sink += parser.getFix().latitude;
+    }
+
+    sentences += parser.getSentences();
+    errors += parser.getErrors();
+    published += parser.getFixes();
+  }
+
+  double elapsed = now() - start;
+  double bytes = (double)stream.size() * passes;
+
+  fprintf(stderr, "nmeabench: %zu bytes, %lu sentences, %lu errors, %lu fixes per pass\n",
+          stream.size(), sentences / passes, errors / passes, published / passes);
+  fprintf(stderr, "nmeabench: %.2f ns per byte, %.1f ns per sentence, %.1f ns per fix over %ld passes\n",
+          elapsed * 1e9 / bytes,
+          sentences ? elapsed * 1e9 / sentences : 0,
+          published ? elapsed * 1e9 / published : 0, passes);
+
+  return 0;
+}
@@ -0,0 +1,204 @@
+// Host test for the apogee predictor (see libraries/Osprey/predictor.h)
+//
+// Build: g++ -O2 -Ilibraries/Osprey -o predtest tools/predtest/predtest.cpp libraries/Osprey/predictor.cpp libraries/Osprey/airbrake.cpp
+// Usage: predtest [-d DT]
+//
+// Predicts apogee from a grid of coasting states, brakes open and closed,
+// and compares every prediction with a fixed step RK4 of the same model,
+// Truth_gravdiffeq_air_brake, with steps of DT (default 1 ms). The reference
+// evaluates the model in float, as the predictor does, but carries the state
+// in double so that tens of thousands of small steps don't add up rounding.
+// The last step is cut where the vertical velocity, taken as linear over
+// it, reaches zero.
+//
+// Also checks that the drag calibration finds a known drag scale, and
+// reports the integrator's steps and evaluations per prediction and the host
+// time each took. Exits non-zero if any check fails.
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "predictor.h"
+#include "../check.h"
+
+#define DEFAULT_DT 1e-3 // s
+
+#define GROUND_LEVEL 1400.0f // m above sea level, Spaceport America
+#define MIN_VELOCITY 20      // m/s, the grid of starting states
+#define MAX_VELOCITY 320
+#define VELOCITY_STEP 20
+#define MAX_ALTITUDE 2500    // m above the ground
+#define ALTITUDE_STEP 250
+
+#define APOGEE_TOLERANCE 0.25f // m, RTOL is 1e-5 of about 5 km of state
+#define TIME_TOLERANCE 0.02f  // s, ill conditioned where the climb flattens out
+#define CALIBRATION_SCALE 1.3f
+#define CALIBRATION_SAMPLES 200
+
+static unsigned long hostMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Vertical flight only, so height and vertical velocity are the whole state
+typedef struct {
+  double height;
+  double velocity;
+} reference_t;
+
+static void derivative(reference_t x, float balCoeff, double *dh, double *dv) {
+  StateVector state((float)x.height, Vector3D(0, 0, (float)x.velocity), balCoeff);
+  StateVector xdot = Truth_gravdiffeq_air_brake(state, 0);
+  *dh = xdot.height;
+  *dv = xdot.vec.z;
+}
+
+// Apogee above sea level and the time to it
+static void referenceApogee(double height, double velocity, float balCoeff, double dt,
+                            double *apogee, double *time) {
+  reference_t x = { height, velocity };
+  double t = 0;
+
+  for(;;) {
+    double h1, v1, h2, v2, h3, v3, h4, v4;
+    derivative(x, balCoeff, &h1, &v1);
+    reference_t x2 = { x.height + dt / 2 * h1, x.velocity + dt / 2 * v1 };
+    derivative(x2, balCoeff, &h2, &v2);
+    reference_t x3 = { x.height + dt / 2 * h2, x.velocity + dt / 2 * v2 };
+    derivative(x3, balCoeff, &h3, &v3);
+    reference_t x4 = { x.height + dt * h3, x.velocity + dt * v3 };
+    derivative(x4, balCoeff, &h4, &v4);
+
+    reference_t next = {
+      x.height + dt / 6 * (h1 + 2 * h2 + 2 * h3 + h4),
+      x.velocity + dt / 6 * (v1 + 2 * v2 + 2 * v3 + v4)
+    };
+
+    if(next.velocity > 0) {
+      x = next;
+      t += dt;
+      continue;
+    }
+
+    // Velocity is near enough linear over one short step, and the height is
+    // its integral
+    double a = (next.velocity - x.velocity) / dt;
+    double s = -x.velocity / a;
+    *apogee = x.height + x.velocity * s + a * s * s / 2;
+    *time = t + s;
+    return;
+  }
+}
+
+static void testPredictions(double dt) {
+  ApogeePredictor predictor(hostMicros);
+  predictor.setGroundLevel(GROUND_LEVEL);
+
+  const float balCoeffs[2] = { BAL_COEFF_CLOSED, BAL_COEFF_OPEN };
+  float worstApogee = 0, worstTime = 0;
+  int predictions = 0, failed = 0, maxSteps = 0, maxEvaluations = 0;
+  long totalEvaluations = 0;
+  unsigned long totalDuration = 0, maxDuration = 0;
+
+  for(int velocity=MIN_VELOCITY; velocity<=MAX_VELOCITY; velocity+=VELOCITY_STEP) {
+    for(int altitude=0; altitude<=MAX_ALTITUDE; altitude+=ALTITUDE_STEP) {
+      for(int b=0; b<2; b++) {
+        double apogee, time;
+        referenceApogee(altitude + GROUND_LEVEL, velocity, balCoeffs[b], dt, &apogee, &time);
+        apogee -= GROUND_LEVEL;
+
+        predictions++;
+        if(!predictor.predict(altitude, velocity, balCoeffs[b])) {
+          failed++;
+          continue;
+        }
+
+        float apogeeError = fabs(predictor.getApogee() - apogee);
+        float timeError = fabs(predictor.getTimeToApogee() - time);
+        if(apogeeError > worstApogee) worstApogee = apogeeError;
+        if(timeError > worstTime) worstTime = timeError;
+
+        if(apogeeError > APOGEE_TOLERANCE || timeError > TIME_TOLERANCE) {
+          printf("predtest: %d m at %d m/s, %s: %.2f m at %.3f s, reference %.2f m at %.3f s\n",
+                 altitude, velocity, b ? "open" : "closed", predictor.getApogee(),
+                 predictor.getTimeToApogee(), apogee, time);
+        }
+
+        if(predictor.getSteps() > maxSteps) maxSteps = predictor.getSteps();
+        if(predictor.getEvaluations() > maxEvaluations) maxEvaluations = predictor.getEvaluations();
+        totalEvaluations += predictor.getEvaluations();
+        totalDuration += predictor.getDuration();
+        if(predictor.getDuration() > maxDuration) maxDuration = predictor.getDuration();
+      }
+    }
+  }
+
+  int succeeded = predictions - failed;
+  printf("predtest: %d predictions, worst %.4f m and %.5f s from the reference\n",
+         predictions, worstApogee, worstTime);
+  printf("predtest: at most %d steps and %d evaluations, %.1f evaluations on average\n",
+         maxSteps, maxEvaluations, succeeded ? (double)totalEvaluations / succeeded : 0.0);
+  printf("predtest: %.1f us per prediction on the host, at most %lu us\n",
+         succeeded ? (double)totalDuration / succeeded : 0.0, maxDuration);
+
+  check(failed == 0, "every prediction finishes within its budget");
+  check(worstApogee <= APOGEE_TOLERANCE, "apogee matches the fine step RK4");
+  check(worstTime <= TIME_TOLERANCE, "time to apogee matches the fine step RK4");
+}
+
+static void testSlow() {
+  ApogeePredictor predictor(hostMicros);
+  predictor.setGroundLevel(GROUND_LEVEL);
+
+  int ok = predictor.predict(1234, PREDICTOR_MIN_VELOCITY / 2, BAL_COEFF_CLOSED);
+  check(ok && predictor.getApogee() == 1234 && predictor.getTimeToApogee() == 0,
+        "a rocket barely climbing is at apogee already");
+}
+
+// Decelerations with CALIBRATION_SCALE times the nominal drag
+static void testCalibration() {
+  ApogeePredictor predictor(hostMicros);
+  predictor.setGroundLevel(GROUND_LEVEL);
+
+  for(int i=0; i<CALIBRATION_SAMPLES; i++) {
+    float altitude = 500 + 5 * i;
+    float velocity = 250 - i;
+    float rho = Exponentially_Decaying_Density_Model((altitude + GROUND_LEVEL) / 1000);
+    float acceleration = -rho * velocity * velocity * BAL_COEFF_CLOSED * CALIBRATION_SCALE - GRAV;
+    predictor.calibrate(altitude, velocity, acceleration, BAL_COEFF_CLOSED);
+  }
+
+  printf("predtest: calibrated drag scale %.4f, actual %.4f\n", predictor.getDragScale(), CALIBRATION_SCALE);
+  check(fabs(predictor.getDragScale() - CALIBRATION_SCALE) < 0.001f, "calibration finds the drag scale");
+
+  // Samples too slow to measure drag are ignored
+  predictor.calibrate(2000, PREDICTOR_CALIBRATION_VELOCITY / 2, 0, BAL_COEFF_CLOSED);
+  check(fabs(predictor.getDragScale() - CALIBRATION_SCALE) < 0.001f, "calibration ignores slow samples");
+}
+
+static void usage() {
+  fprintf(stderr, "usage: predtest [-d DT]\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  double dt = DEFAULT_DT;
+
+  for(int i=1; i<argc; i++) {
+    if(strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+      dt = atof(argv[++i]);
+      if(dt <= 0) usage();
+    } else {
+      usage();
+    }
+  }
+
+  testPredictions(dt);
+  testSlow();
+  testCalibration();
+
+  return checkResult("predtest");
+}
@@ -0,0 +1,131 @@
+// Host benchmark for the barometric altitude lookup (see Barometer::pressureToAltitude)
+//
+// Build: g++ -O2 -DARDUINO=10810 -Itools/sitl/hal -Ilibraries/Osprey -Ilibraries/MS5xxx -o pressurebench tools/pressurebench/pressurebench.cpp libraries/Osprey/barometer.cpp libraries/Osprey/sensor.cpp libraries/Osprey/fixed.cpp libraries/MS5xxx/MS5xxx.cpp tools/sitl/hal/hal.cpp
+// Usage: pressurebench
+//
+// Compares Barometer::pressureToAltitude, which interpolates the generated
+// table in pressure_table.h, with the pow() formula it replaced, kept below
+// as it was, and both with the formula in double. Every quarter Pa from 1 to
+// 110 kPa is tried at altimeter settings (QNH) of 950, 1013.25 and 1060 hPa,
+// which go through setSeaLevelPressure's offset, and at -30, 15 and 50 C.
+// Add -DFIXED_POINT_MATH=1 to the build to check the integer table instead.
+//
+// Then both are timed over flight pressures. Host time is no measure of the
+// M0's, where pow() is a long soft float routine, but shows how the two
+// compare. Exits non-zero if the lookup is more than TOLERANCE from the
+// formula anywhere.
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+#include "barometer.h"
+
+#define MIN_PRESSURE 1000    // Pa
+#define MAX_PRESSURE 110000
+#define PRESSURE_STEP 0.25
+#define BENCH_CALLS 20000000L
+
+// m, the table's own error grown by the warmest temperature and the highest
+// setting, and in fixed point by the centimetre steps near 1 kPa
+#if FIXED_POINT_MATH
+#define TOLERANCE 0.1
+#else
+#define TOLERANCE 0.06
+#endif
+
+#define SEA_LEVEL_PRESSURE 101325.0 // Pa, of the standard atmosphere
+
+// The formula as it was
+static float oldPressureToAltitude(float pressure, float temp, float seaLevelPressure) {
+  float const EXPONENT = 0.19022256039566293;
+  float const TO_KELVIN = 273.15;
+  float const DENOM = 0.0065;
+
+  return ( (pow(seaLevelPressure/pressure,EXPONENT)-1.0)*(temp+TO_KELVIN) )/(DENOM);
+}
+
+static double exactAltitude(double pressure, double temp, double seaLevelPressure) {
+  return (pow(seaLevelPressure / pressure, 0.19022256039566293) - 1) * (temp + 273.15) / 0.0065;
+}
+
+// Exposes the conversion
+class BenchBarometer : public Barometer {
+  public:
+    BenchBarometer() : Barometer(&Wire) {}
+
+    float altitude(float pressure, float temp) { return pressureToAltitude(pressure, temp); }
+};
+
+static double now() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ns per call over pressures from a flight: the ground to 10 km
+template<typename Altitude>
+static double timeCalls(Altitude altitude) {
+  volatile float sink = 0;
+  float step = (101325 - 26500) / 65536.0f;
+
+  double start = now();
+  for(long i=0; i<BENCH_CALLS; i++) {
+    sink = sink + altitude(26500 + (i & 0xFFFF) * step);
+  }
+  return (now() - start) * 1e9 / BENCH_CALLS;
+}
+
+int main(int argc, char **argv) {
+  if(argc > 1) {
+    fprintf(stderr, "usage: pressurebench\n");
+    return 2;
+  }
+
+  BenchBarometer barometer;
+  const float settings[] = { 95000, 101325, 106000 }; // Pa
+  const float temperatures[] = { -30, 15, 50 };       // C
+
+  double worstNew = 0, worstOld = 0;
+  double worstNewPressure = 0, worstOldPressure = 0;
+  float worstNewSetting = 0, worstNewTemp = 0;
+
+  for(unsigned s=0; s<sizeof(settings) / sizeof(settings[0]); s++) {
+    barometer.setSeaLevelPressure(settings[s]);
+
+    for(unsigned t=0; t<sizeof(temperatures) / sizeof(temperatures[0]); t++) {
+      float temp = temperatures[t];
+
+      for(double pressure=MIN_PRESSURE; pressure<=MAX_PRESSURE; pressure+=PRESSURE_STEP) {
+        double exact = exactAltitude(pressure, temp, settings[s]);
+        double fresh = fabs(barometer.altitude(pressure, temp) - exact);
+        double old = fabs(oldPressureToAltitude(pressure, temp, settings[s]) - exact);
+
+        if(fresh > worstNew) {
+          worstNew = fresh;
+          worstNewPressure = pressure;
+          worstNewSetting = settings[s];
+          worstNewTemp = temp;
+        }
+        if(old > worstOld) {
+          worstOld = old;
+          worstOldPressure = pressure;
+        }
+      }
+    }
+  }
+
+  printf("pressurebench: %s table within %.4f m of the formula, worst at %.2f Pa, QNH %.0f Pa, %.0f C\n",
+         FIXED_POINT_MATH ? "fixed point" : "float", worstNew, worstNewPressure, worstNewSetting, worstNewTemp);
+  printf("pressurebench: float pow() within %.4f m, worst at %.2f Pa\n", worstOld, worstOldPressure);
+
+  barometer.setSeaLevelPressure(SEA_LEVEL_PRESSURE);
+  double lookup = timeCalls([&](float pressure) { return barometer.altitude(pressure, 15); });
+  double formula = timeCalls([](float pressure) { return oldPressureToAltitude(pressure, 15, SEA_LEVEL_PRESSURE); });
+  printf("pressurebench: %.1f ns per call, pow() %.1f ns\n", lookup, formula);
+
+  if(worstNew > TOLERANCE) {
+    fprintf(stderr, "pressurebench: the table is more than %g m from the formula\n", TOLERANCE);
+    return 1;
+  }
+
+  return 0;
+}
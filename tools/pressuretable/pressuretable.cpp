@@ -0,0 +1,131 @@
+// Generates libraries/Osprey/pressure_table.h, the pressure to altitude table
+// used by the barometer (see Barometer::standardAltitude)
+//
+// Build: g++ -O2 -o pressuretable tools/pressuretable/pressuretable.cpp
+// Usage: pressuretable > libraries/Osprey/pressure_table.h
+//
+// The table holds the standard atmosphere altitude for 512 Pa to 128 kPa. Each
+// power of two of pressure is a band of equally spaced steps, so the spacing
+// grows with pressure roughly as fast as the curve flattens out and a lookup
+// needs no search. Float builds get it in metres, FIXED_POINT_MATH builds
+// in whole centimetres, interpolated in integers. The worst interpolation
+// error of each between 1 and 110 kPa is printed to stderr.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define REFERENCE_PRESSURE 101325.0 // Pa
+#define REFERENCE_TEMPERATURE 288.15 // K
+#define LAPSE_RATE 0.0065           // K/m
+#define EXPONENT 0.19022256039566293
+
+#define FIRST_BAND 9 // 2^9 = 512 Pa
+#define BANDS 8      // up to 2^17 = 131072 Pa
+#define STEP_BITS 8  // 256 steps per band
+#define ENTRIES ((BANDS << STEP_BITS) + 1)
+#define FRACTION_BITS 12 // of the pressure, as PRESSURE_FRACTION_BITS
+#define POSITION_BITS 16 // of the position within a step, fixed point
+
+static double altitude(double pressure) {
+  return (pow(REFERENCE_PRESSURE / pressure, EXPONENT) - 1) * REFERENCE_TEMPERATURE / LAPSE_RATE;
+}
+
+static double entryPressure(int entry) {
+  int band = FIRST_BAND + (entry >> STEP_BITS);
+  int step = entry & ((1 << STEP_BITS) - 1);
+  return ldexp(1 + ldexp(step, -STEP_BITS), band);
+}
+
+// As Barometer::standardAltitudeCm interpolates, for a pressure in Pa with
+// FRACTION_BITS of fraction
+static int32_t interpolateCm(const int32_t *table, uint32_t scaled) {
+  int band = 31 - __builtin_clz(scaled) - FRACTION_BITS;
+  int shift = band + FRACTION_BITS - STEP_BITS;
+  int entry = ((band - FIRST_BAND) << STEP_BITS) + (int)(scaled >> shift) - (1 << STEP_BITS);
+  uint32_t position = scaled & ((1UL << shift) - 1);
+  position = shift >= POSITION_BITS ? position >> (shift - POSITION_BITS) : position << (POSITION_BITS - shift);
+
+  return table[entry] + (((table[entry + 1] - table[entry]) * (int32_t)position + (1 << (POSITION_BITS - 1))) >> POSITION_BITS);
+}
+
+int main() {
+  static float table[ENTRIES];
+  static int32_t tableCm[ENTRIES];
+  int32_t widestStep = 0;
+  for(int i=0; i<ENTRIES; i++) {
+    table[i] = altitude(entryPressure(i));
+    tableCm[i] = (int32_t)lround(altitude(entryPressure(i)) * 100);
+    if(i && abs(tableCm[i] - tableCm[i - 1]) > widestStep) widestStep = abs(tableCm[i] - tableCm[i - 1]);
+  }
+
+  // The fixed point interpolation multiplies a step by the position in 32 bits
+  if(widestStep >= (1L << (31 - POSITION_BITS))) {
+    fprintf(stderr, "a step of %d cm overflows the interpolation\n", widestStep);
+    return 1;
+  }
+
+  // Interpolate exactly as the flight code does and compare with the formula
+  double worst = 0;
+  double worstPressure = 0;
+  for(double pressure=1000; pressure<=110000; pressure+=0.25) {
+    int band = (int)floor(log2(pressure));
+    double position = (ldexp(pressure, -band) - 1) * (1 << STEP_BITS);
+    int entry = ((band - FIRST_BAND) << STEP_BITS) + (int)position;
+    float fraction = position - floor(position);
+    float interpolated = table[entry] + (table[entry + 1] - table[entry]) * fraction;
+
+    double error = fabs(interpolated - altitude(pressure));
+    if(error > worst) {
+      worst = error;
+      worstPressure = pressure;
+    }
+  }
+  fprintf(stderr, "worst error %.4f m at %.2f Pa\n", worst, worstPressure);
+
+  double worstCm = 0;
+  double worstCmPressure = 0;
+  for(double pressure=1000; pressure<=110000; pressure+=0.25) {
+    uint32_t scaled = (uint32_t)(pressure * (1 << FRACTION_BITS));
+    double error = fabs(interpolateCm(tableCm, scaled) / 100.0 - altitude(pressure));
+    if(error > worstCm) {
+      worstCm = error;
+      worstCmPressure = pressure;
+    }
+  }
+  fprintf(stderr, "worst fixed point error %.4f m at %.2f Pa\n", worstCm, worstCmPressure);
+
+  printf("#ifndef PRESSURE_TABLE_H\n");
+  printf("#define PRESSURE_TABLE_H\n\n");
+  printf("// Generated by tools/pressuretable, don't edit by hand.\n");
+  printf("//\n");
+  printf("// Standard atmosphere altitude for pressures from 2^%d to 2^%d Pa. Band b\n", FIRST_BAND, FIRST_BAND + BANDS);
+  printf("// covers 2^b to 2^(b+1) Pa in %d equal steps. Linear interpolation is within\n", 1 << STEP_BITS);
+  printf("// %.3f m of the formula between 1 and 110 kPa in metres, and %.3f m in the\n", worst, worstCm);
+  printf("// centimetres FIXED_POINT_MATH builds use.\n\n");
+  printf("#define PRESSURE_TABLE_REFERENCE_PRESSURE %.1ff\n", REFERENCE_PRESSURE);
+  printf("#define PRESSURE_TABLE_REFERENCE_TEMPERATURE %.2ff\n", REFERENCE_TEMPERATURE);
+  printf("#define PRESSURE_TABLE_LAPSE_RATE %.4ff\n", LAPSE_RATE);
+  printf("#define PRESSURE_TABLE_FIRST_BAND %d\n", FIRST_BAND);
+  printf("#define PRESSURE_TABLE_BANDS %d\n", BANDS);
+  printf("#define PRESSURE_TABLE_STEP_BITS %d\n", STEP_BITS);
+  printf("#define PRESSURE_TABLE_ENTRIES %d\n", ENTRIES);
+  printf("#define PRESSURE_TABLE_POSITION_BITS %d\n\n", POSITION_BITS);
+  printf("#if FIXED_POINT_MATH\n");
+  printf("static const int32_t PRESSURE_TABLE[PRESSURE_TABLE_ENTRIES] = {\n");
+  for(int i=0; i<ENTRIES; i++) {
+    printf("%s%d%s", i % 8 ? " " : "  ", tableCm[i], i == ENTRIES - 1 ? "\n" : i % 8 == 7 ? ",\n" : ",");
+  }
+  printf("};\n");
+  printf("#else\n");
+  printf("static const float PRESSURE_TABLE[PRESSURE_TABLE_ENTRIES] = {\n");
+  for(int i=0; i<ENTRIES; i++) {
+    printf("%s%.3ff%s", i % 8 ? " " : "  ", table[i], i == ENTRIES - 1 ? "\n" : i % 8 == 7 ? ",\n" : ",");
+  }
+  printf("};\n");
+  printf("#endif\n\n");
+  printf("#endif\n");
+
+  return 0;
+}
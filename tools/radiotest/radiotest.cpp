@@ -0,0 +1,162 @@
+// Host test for the radio's receive path (see libraries/Osprey/radio.h and ring.h)
+//
+// Build: g++ -O2 -DARDUINO=10810 -Itools/sitl/hal -Ilibraries/Osprey -o radiotest tools/radiotest/radiotest.cpp libraries/Osprey/radio.cpp libraries/Osprey/logger.cpp libraries/Osprey/format.cpp libraries/Osprey/sensor.cpp tools/sitl/hal/hal.cpp
+// Usage: radiotest [-s SECONDS]
+//
+// Pushes random lines into the simulator's UART at 100 kB/s, for SECONDS
+// (default 100) of traffic, on the board's schedule. Every 1 ms tick the UART
+// gets 100 bytes and the tick interrupt's Radio::poll moves them into the
+// receive ring. Every 10 ms the radio task takes up to RADIO_MAX_LINES lines
+// through recv() and clear().
+//
+// Lines are 0 to 89 printable characters, so some are too long for a command
+// and must be dropped whole. Checks that every other line arrives intact and
+// in order, that the ring never drops a byte, and that read() uses the same
+// stack however much is waiting. Exits non-zero if any check fails.
+
+#include <random>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "radio.h"
+#include "../check.h"
+
+namespace Osprey {
+  Logger logger;
+}
+
+#define DEFAULT_SECONDS 100
+#define BYTES_PER_TICK 100 // 100 kB/s at the 1 kHz tick
+#define TASK_TICKS 10      // the radio task's period, in ticks
+#define MAX_LINE 90        // characters, longer than any command
+#define SEED 7
+
+#define STACK_PAINT 16384  // bytes below the caller checked for use
+#define STACK_PATTERN 0xA5
+
+static std::string randomLine(std::mt19937 &random) {
+  int length = random() % MAX_LINE;
+  std::string line;
+  for(int i=0; i<length; i++) {
+    line += (char)(' ' + random() % 94);
+  }
+  return line;
+}
+
+// Stack use is measured by painting the stack below the caller with a
+// pattern, making the call, then seeing how far down the pattern was
+// overwritten. Both helpers are called from the same frame, so their arrays
+// lie over the stack the call in between used, less the slot of its return
+// address. At -O2 on the host read() lives in registers and uses none.
+static __attribute__((noinline)) void paintStack() {
+  uint8_t area[STACK_PAINT];
+  volatile uint8_t *stack = area;
+  for(int i=0; i<STACK_PAINT; i++) {
+    stack[i] = STACK_PATTERN;
+  }
+}
+
+static __attribute__((noinline)) int stackUsed() {
+  uint8_t area[STACK_PAINT];
+  volatile uint8_t *stack = area;
+  int untouched = 0;
+  while(untouched < STACK_PAINT && stack[untouched] == STACK_PATTERN) {
+    untouched++;
+  }
+  return STACK_PAINT - untouched;
+}
+
+static __attribute__((noinline)) char* measuredRecv(Radio &radio, int *stack) {
+  paintStack();
+  char *line = radio.recv();
+  *stack = stackUsed();
+  return line;
+}
+
+static void usage() {
+  fprintf(stderr, "usage: radiotest [-s SECONDS]\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  long seconds = DEFAULT_SECONDS;
+
+  for(int i=1; i<argc; i++) {
+    if(strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+      seconds = atol(argv[++i]);
+      if(seconds < 1) usage();
+    } else {
+      usage();
+    }
+  }
+
+  // The sender and the checker draw the same lines
+  std::mt19937 sender(SEED), checker(SEED);
+  std::string pending;
+  const long total = seconds * 1000 * BYTES_PER_TICK;
+  long sent = 0;
+
+  Radio radio;
+  long received = 0, corrupt = 0, expectedOverlong = 0, maxPerTask = 0;
+  int minStack = STACK_PAINT, maxStack = 0;
+
+  for(long tick=0; ; tick++) {
+    for(int i=0; i<BYTES_PER_TICK && sent < total; i++, sent++) {
+      if(pending.empty()) {
+        pending = randomLine(sender) + "\n";
+      }
+      uint8_t c = pending[0];
+      pending.erase(0, 1);
+      Serial1.receive(&c, 1);
+    }
+    Radio::poll();
+
+    if(tick % TASK_TICKS) continue;
+
+    long handled = 0;
+    for(int i=0; i<RADIO_MAX_LINES; i++) {
+      int stack;
+      char *line = measuredRecv(radio, &stack);
+      if(stack < minStack) minStack = stack;
+      if(stack > maxStack) maxStack = stack;
+      if(line[0] == '\0') break;
+
+      // Lines too long are dropped, and empty ones never show
+      std::string expected;
+      do {
+        expected = randomLine(checker);
+        if(expected.size() > RADIO_MAX_LINE_LENGTH - 1) expectedOverlong++;
+      } while(expected.size() > RADIO_MAX_LINE_LENGTH - 1 || expected.empty());
+
+      if(expected != line) {
+        if(corrupt++ < 10) {
+          fprintf(stderr, "radiotest: line %ld is \"%s\", expected \"%s\"\n", received, line, expected.c_str());
+        }
+      }
+
+      radio.clear();
+      received++;
+      handled++;
+    }
+    if(handled > maxPerTask) maxPerTask = handled;
+
+    // Everything sent has been read
+    if(sent == total && !Serial1.available() && handled == 0) break;
+  }
+
+  printf("radiotest: %ld bytes, %ld lines received, %ld corrupt, %lu bytes dropped, "
+         "%lu overlong lines dropped, at most %ld lines a task\n",
+         sent, received, corrupt, Radio::getRxDropped(), Radio::getOverlong(), maxPerTask);
+  printf("radiotest: recv() used %d to %d bytes of stack below its frame\n", minStack, maxStack);
+
+  check(corrupt == 0, "every line arrives intact and in order");
+  check(Radio::getRxDropped() == 0, "the receive ring never drops a byte");
+  check((long)Radio::getOverlong() == expectedOverlong, "overlong lines are dropped whole");
+  check(maxPerTask < RADIO_MAX_LINES, "the task keeps up without hitting its line limit");
+  check(minStack == maxStack, "read() uses constant stack");
+
+  return checkResult("radiotest");
+}
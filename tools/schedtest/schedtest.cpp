@@ -0,0 +1,194 @@
+// Host test for the task scheduler (see libraries/Osprey/scheduler.h)
+//
+// Build: g++ -O2 -DARDUINO=10810 -Itools/sitl/hal -Ilibraries/Osprey -o schedtest tools/schedtest/schedtest.cpp libraries/Osprey/scheduler.cpp tools/sitl/hal/hal.cpp
+// Usage: schedtest
+//
+// Drives the scheduler on the SITL clock the way loop() and the tick timer
+// drive it on the board. Tasks stand in for work by waiting with
+// delayMicroseconds, which moves the clock on. Checks that
+// tasks are released on their own time base, that lower priority tasks see
+// the higher ones as jitter, that overruns are counted against the deadline,
+// and that a task held up past several releases skips them rather than
+// running back to back to catch up. Exits non-zero if any check fails.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "Arduino.h"
+#include "scheduler.h"
+#include "sitl.h"
+#include "../check.h"
+
+#define TICK (1000000 / SCHEDULER_TICK_HZ) // us
+#define SLACK 20 // us of clock reads allowed for around a task
+
+// A task for the tests: how long each run takes and when each run started
+typedef struct test_task_t {
+  unsigned long duration;       // us
+  unsigned long longDuration;   // us, every longEvery'th run instead
+  unsigned long longEvery;
+  std::vector<uint64_t> starts; // us
+} test_task_t;
+
+static test_task_t testTasks[2];
+static void work(test_task_t *task) {
+  task->starts.push_back(Sitl::now());
+
+  unsigned long n = task->starts.size();
+  bool isLong = task->longEvery && n % task->longEvery == 0;
+  delayMicroseconds(isLong ? task->longDuration : task->duration);
+}
+
+static void task0() { work(&testTasks[0]); }
+static void task1() { work(&testTasks[1]); }
+
+static void setUp(int count) {
+  for(int i=0; i<count; i++) {
+    testTasks[i].duration = 0;
+    testTasks[i].longDuration = 0;
+    testTasks[i].longEvery = 0;
+    testTasks[i].starts.clear();
+  }
+
+  // Tasks are released at start(), so start on a tick
+  Sitl::advanceTo((Sitl::now() / TICK + 1) * TICK);
+}
+
+// Runs as the board's loop() does: run() again straight away while it
+// finds work, and otherwise sleep until the timer's next tick on its fixed
+// grid
+static void runFor(Scheduler &scheduler, uint64_t duration) {
+  uint64_t end = Sitl::now() / TICK * TICK + duration;
+
+  while(Sitl::now() < end) {
+    if(scheduler.run() == 0) {
+      Sitl::advanceTo((Sitl::now() / TICK + 1) * TICK);
+      Scheduler::tick();
+    }
+  }
+}
+
+// Every run starts no earlier than its release and within limit of it
+static bool onTimeBase(const test_task_t &task, uint64_t start, unsigned long period, unsigned long limit) {
+  for(size_t i=0; i<task.starts.size(); i++) {
+    uint64_t release = start + i * period;
+    if(task.starts[i] < release || task.starts[i] - release > limit) return false;
+  }
+  return true;
+}
+
+static void testRelease() {
+  setUp(2);
+  testTasks[0].duration = 100;
+  testTasks[1].duration = 200;
+
+  Scheduler scheduler(micros);
+  scheduler.add("fast", task0, 10000);
+  scheduler.add("slow", task1, 25000);
+  uint64_t start = Sitl::now();
+  scheduler.start();
+  runFor(scheduler, 1000000);
+
+  const task_t *fast = scheduler.getTask(0);
+  const task_t *slow = scheduler.getTask(1);
+  check(fast->runs == 100 && slow->runs == 40, "release: each task runs once per period");
+  check(fast->overruns == 0 && slow->overruns == 0, "release: no overruns");
+  check(fast->missed == 0 && slow->missed == 0, "release: no missed releases");
+  check(onTimeBase(testTasks[0], start, 10000, SLACK), "release: fast task starts on its release");
+  check(onTimeBase(testTasks[1], start, 25000, 100 + SLACK), "release: slow task starts on its release, after the fast one");
+}
+
+static void testJitter() {
+  setUp(2);
+  testTasks[0].duration = 3000;
+  testTasks[1].duration = 100;
+
+  Scheduler scheduler(micros);
+  scheduler.add("high", task0, 5000);
+  scheduler.add("low", task1, 5000);
+  scheduler.start();
+  runFor(scheduler, 500000);
+
+  const task_t *high = scheduler.getTask(0);
+  const task_t *low = scheduler.getTask(1);
+  check(high->maxJitter < SLACK, "jitter: high priority task starts on time");
+  check(low->maxJitter >= 3000 && low->maxJitter < 3000 + SLACK, "jitter: low priority task waits for the high one");
+  check(low->totalJitter / low->runs >= 3000, "jitter: mean jitter is the high task's duration");
+  check(high->maxDuration >= 3000 && high->maxDuration < 3000 + SLACK, "jitter: duration is measured");
+  check(low->overruns == 0 && low->missed == 0, "jitter: no overruns or missed releases");
+}
+
+static void testOverrun() {
+  setUp(1);
+  testTasks[0].duration = 100;
+  testTasks[0].longDuration = 12000;
+  testTasks[0].longEvery = 5;
+
+  Scheduler scheduler(micros);
+  scheduler.add("late", task0, 10000);
+  scheduler.start();
+  runFor(scheduler, 1000000);
+
+  const task_t *late = scheduler.getTask(0);
+  check(late->overruns > 0 && late->overruns == late->runs / 5, "overrun: runs past the period are counted");
+  check(late->missed == 0, "overrun: a release only just passed is still run");
+  check(late->maxJitter >= 2000 && late->maxJitter < 2000 + SLACK, "overrun: the run after starts late by the overrun");
+}
+
+static void testDeadline() {
+  setUp(1);
+  testTasks[0].duration = 3000;
+
+  Scheduler scheduler(micros);
+  scheduler.add("deadline", task0, 10000, 2000);
+  scheduler.start();
+  runFor(scheduler, 100000);
+
+  const task_t *deadline = scheduler.getTask(0);
+  check(deadline->runs == 10 && deadline->overruns == deadline->runs, "deadline: runs past a deadline shorter than the period are counted");
+  check(deadline->missed == 0 && deadline->maxJitter < SLACK, "deadline: without holding up the next release");
+}
+
+static void testCatchUp() {
+  setUp(1);
+  testTasks[0].duration = 100;
+  testTasks[0].longDuration = 35000;
+  testTasks[0].longEvery = 10;
+
+  Scheduler scheduler(micros);
+  scheduler.add("stall", task0, 10000);
+  uint64_t start = Sitl::now();
+  scheduler.start();
+  runFor(scheduler, 95000);
+
+  const task_t *stall = scheduler.getTask(0);
+  const std::vector<uint64_t> &starts = testTasks[0].starts;
+  check(stall->missed == 2, "catch up: releases passed during a stall are skipped");
+
+  // The stall starts at 90 ms and ends at 125 ms, which is past the releases
+  // at 100 and 110 ms. The one at 120 ms is run late and then the task is
+  // back on its time base, running at 130, 140, 150 and 160 ms.
+  runFor(scheduler, 45000);
+  check(starts.size() == 15, "catch up: one late run, not one per missed release");
+  check(starts.size() == 15 && starts[10] - start >= 125000 && starts[10] - start < 125000 + SLACK,
+        "catch up: the late run starts as soon as the stall ends");
+  check(starts.size() == 15 && starts[11] - start >= 130000 && starts[11] - start < 130000 + SLACK,
+        "catch up: the next run is back on the original time base");
+}
+
+int main(int argc, char **argv) {
+  if(argc > 1) {
+    fprintf(stderr, "usage: schedtest\n");
+    return 2;
+  }
+
+  testRelease();
+  testJitter();
+  testOverrun();
+  testDeadline();
+  testCatchUp();
+
+  return checkResult("schedtest");
+}
@@ -0,0 +1,70 @@
+#ifndef SPI_H
+#define SPI_H
+
+// Mock SPI bus for running Sd2Card on the host (see sdcardtest.cpp)
+//
+// Stands in for the Arduino SPI library. Every byte is handed to whatever
+// device is attached and moves the SITL clock on by the time the byte takes
+// on the wire at the clock rate of the current transaction, so transfers
+// can be timed as well as checked.
+
+#include "Arduino.h"
+#include "sitl.h"
+
+#define MSBFIRST 1
+#define SPI_MODE0 0x02
+
+#define SPI_MAX_CLOCK 24000000UL // Hz, F_CPU / 2 on the SAMD21
+
+class SPISettings {
+  public:
+    SPISettings() : clock(4000000UL) {}
+    SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) :
+      clock(clock > SPI_MAX_CLOCK ? SPI_MAX_CLOCK : clock) {}
+
+    uint32_t clock;
+};
+
+// The other end of the bus. transfer() is given the byte clocked out and
+// returns the one clocked in at the same time.
+class SPIDevice {
+  public:
+    virtual uint8_t transfer(uint8_t data) = 0;
+};
+
+class SPIClass {
+  public:
+    SPIClass() : device(0), clock(4000000UL), picoseconds(0), transferred(0) {}
+
+    void attach(SPIDevice *device) { this->device = device; }
+
+    void begin() {}
+    void beginTransaction(SPISettings settings) { clock = settings.clock; }
+    void endTransaction() {}
+
+    uint8_t transfer(uint8_t data) {
+      // 8 bit times, carried over in picoseconds so slow and fast clocks
+      // both come out right
+      picoseconds += 8000000000000ULL / clock;
+      if(picoseconds >= 1000000) {
+        Sitl::advanceTo(Sitl::now() + picoseconds / 1000000);
+        picoseconds %= 1000000;
+      }
+
+      transferred++;
+      return device ? device->transfer(data) : 0xFF;
+    }
+
+    uint32_t getClock() const { return clock; }
+    uint64_t getTransferred() const { return transferred; }
+
+  private:
+    SPIDevice *device;
+    uint32_t clock;
+    uint64_t picoseconds;
+    uint64_t transferred;
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,472 @@
+// Host test and benchmark for the SD card driver (libraries/Osprey/utility/Sd2Card.cpp)
+//
+// Build: g++ -O2 -D__arm__ -DARDUINO=10810 -DSITL_NO_SD -Itools/sdcardtest -Itools/sitl/hal -Ilibraries/Osprey/utility -o sdcardtest tools/sdcardtest/sdcardtest.cpp libraries/Osprey/utility/Sd2Card.cpp tools/sitl/hal/hal.cpp
+// Usage: sdcardtest [-n BLOCKS]
+//
+// Runs the real Sd2Card against a simulated card on the mock SPI bus in
+// SPI.h, with the SITL HAL for the clock and the chip select pin. The card
+// speaks the SPI mode protocol byte by byte: commands and their responses,
+// data tokens, data responses and busy while it programs.
+//
+// The tests go through init, single block reads and writes, erase, and the
+// multiple block write state machine of writeStart, writeDataStart,
+// writeDataFinish and writeStop, including a rejected block and a card that
+// stays busy past the timeout. Exits non-zero if any fails.
+//
+// The benchmark then streams BLOCKS blocks (default 2048) as the logger's
+// recorder mode does at each SCK rate and prints the bus time per block on
+// the SITL clock and the host time the driver spent per block.
+//
+// The host has no DMAC, so this builds the byte at a time path. The block
+// protocol around it is the same with USE_SAMD_DMA.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "Arduino.h"
+#include "SPI.h"
+#include "Sd2Card.h"
+#include "sitl.h"
+#include "../check.h"
+
+#define DEFAULT_BLOCKS 2048
+#define CHIP_SELECT 4
+
+#define CARD_BLOCK_SIZE 512
+#define CARD_PROGRAM_TIME 250   // us busy after each block
+#define CARD_ERASE_TIME 2000    // us busy after an erase
+#define CARD_ACCESS_BYTES 8     // bytes of 0XFF before a read's data token
+#define CARD_INIT_POLLS 2       // ACMD41 calls before the card is ready
+
+SPIClass SPI;
+
+// An SDHC card in SPI mode. Blocks that were never written read back as
+// zeros, as an erased card would.
+class MockCard : public SPIDevice {
+  public:
+    MockCard() { reset(); }
+
+    void reset() {
+      state = STATE_COMMAND;
+      length = 0;
+      multiple = false;
+      address = 0;
+      idle = true;
+      application = false;
+      polls = 0;
+      busyUntil = 0;
+      eraseStart = eraseEnd = 0;
+      rejectBlock = -1;
+      busyTime = CARD_PROGRAM_TIME;
+      output.clear();
+      blocks.clear();
+      blocksWritten = 0;
+    }
+
+    // Called from the SITL pin listener
+    void select(bool selected) {
+      if(selected) return;
+
+      // Whatever was half sent is dropped, a multiple block write isn't
+      if(state != STATE_WRITE_TOKEN || !multiple) state = STATE_COMMAND;
+      length = 0;
+      output.clear();
+    }
+
+    uint8_t transfer(uint8_t data) {
+      uint8_t reply;
+      if(!output.empty()) {
+        reply = output.front();
+        output.pop_front();
+      } else {
+        // MISO is held low while programming
+        reply = (Sitl::now() < busyUntil ? 0X00 : 0XFF);
+      }
+
+      receive(data);
+      return reply;
+    }
+
+    const uint8_t *block(uint32_t number) {
+      static const uint8_t zeros[CARD_BLOCK_SIZE] = {0};
+      std::map<uint32_t, std::vector<uint8_t> >::iterator it = blocks.find(number);
+      return it == blocks.end() ? zeros : &it->second[0];
+    }
+
+    // The data response for the block'th block written from now on is a CRC
+    // error
+    void reject(long block) { rejectBlock = blocksWritten + block; }
+    void setBusyTime(uint64_t us) { busyTime = us; }
+
+    uint32_t getBlocksWritten() const { return blocksWritten; }
+
+  private:
+    enum {
+      STATE_COMMAND,     // waiting for or reading a command
+      STATE_WRITE_TOKEN, // waiting for a data token
+      STATE_WRITE_DATA,  // reading a block and its CRC
+    };
+
+    void receive(uint8_t data) {
+      switch(state) {
+        case STATE_COMMAND:
+          if(length == 0 && (data & 0XC0) != 0X40) return;
+          command[length++] = data;
+          if(length == 6) {
+            length = 0;
+            execute(command[0] & 0X3F,
+                    (uint32_t)command[1] << 24 | (uint32_t)command[2] << 16 |
+                    (uint32_t)command[3] << 8 | command[4]);
+          }
+          break;
+
+        case STATE_WRITE_TOKEN:
+          if(data == DATA_START_BLOCK || data == WRITE_MULTIPLE_TOKEN) {
+            state = STATE_WRITE_DATA;
+            length = 0;
+          } else if(data == STOP_TRAN_TOKEN && multiple) {
+            // One byte before busy starts
+            output.push_back(0XFF);
+            busyUntil = Sitl::now() + busyTime;
+            state = STATE_COMMAND;
+          }
+          break;
+
+        case STATE_WRITE_DATA:
+          if(length < CARD_BLOCK_SIZE) buffer[length] = data;
+          if(++length < CARD_BLOCK_SIZE + 2) return;
+
+          if((long)blocksWritten == rejectBlock) {
+            output.push_back(0X0B);
+          } else {
+            blocks[address].assign(buffer, buffer + CARD_BLOCK_SIZE);
+            output.push_back(DATA_RES_ACCEPTED | 0XE0);
+          }
+          blocksWritten++;
+          address++;
+          busyUntil = Sitl::now() + busyTime;
+          state = (multiple ? STATE_WRITE_TOKEN : STATE_COMMAND);
+          length = 0;
+          break;
+      }
+    }
+
+    void respond(uint8_t r1) {
+      // One byte of NCR before the response
+      output.push_back(0XFF);
+      output.push_back(r1);
+    }
+
+    void execute(uint8_t cmd, uint32_t arg) {
+      bool app = application;
+      application = false;
+      uint8_t r1 = (idle ? R1_IDLE_STATE : R1_READY_STATE);
+
+      if(app && cmd == ACMD41) {
+        if(++polls >= CARD_INIT_POLLS) idle = false;
+        respond(idle ? R1_IDLE_STATE : R1_READY_STATE);
+        return;
+      }
+      if(app && cmd == ACMD23) {
+        respond(r1);
+        return;
+      }
+
+      switch(cmd) {
+        case CMD0:
+          idle = true;
+          polls = 0;
+          respond(R1_IDLE_STATE);
+          break;
+        case CMD8:
+          respond(r1);
+          output.push_back(0X00);
+          output.push_back(0X00);
+          output.push_back(0X01);
+          output.push_back(arg & 0XFF);
+          break;
+        case CMD9: {
+          // An 8 GB SDHC card that can erase single blocks
+          static const uint8_t csd[16] = {
+            0X40, 0X0E, 0X00, 0X32, 0X5B, 0X59, 0X00, 0X00,
+            0X3B, 0X37, 0X7F, 0X80, 0X0A, 0X40, 0X00, 0X01
+          };
+          respond(r1);
+          output.push_back(0XFF);
+          output.push_back(DATA_START_BLOCK);
+          output.insert(output.end(), csd, csd + 16);
+          output.push_back(0XFF);
+          output.push_back(0XFF);
+          break;
+        }
+        case CMD13:
+          respond(r1);
+          output.push_back(0X00);
+          break;
+        case CMD17: {
+          respond(r1);
+          for(int i=0; i<CARD_ACCESS_BYTES; i++) output.push_back(0XFF);
+          output.push_back(DATA_START_BLOCK);
+          const uint8_t *data = block(arg);
+          output.insert(output.end(), data, data + CARD_BLOCK_SIZE);
+          output.push_back(0XFF);
+          output.push_back(0XFF);
+          break;
+        }
+        case CMD24:
+        case CMD25:
+          respond(r1);
+          address = arg;
+          multiple = (cmd == CMD25);
+          state = STATE_WRITE_TOKEN;
+          break;
+        case CMD32:
+          eraseStart = arg;
+          respond(r1);
+          break;
+        case CMD33:
+          eraseEnd = arg;
+          respond(r1);
+          break;
+        case CMD38:
+          respond(r1);
+          blocks.erase(blocks.lower_bound(eraseStart), blocks.upper_bound(eraseEnd));
+          busyUntil = Sitl::now() + CARD_ERASE_TIME;
+          break;
+        case CMD55:
+          application = true;
+          respond(r1);
+          break;
+        case CMD58:
+          respond(r1);
+          // Powered up and high capacity
+          output.push_back(0XC0);
+          output.push_back(0XFF);
+          output.push_back(0X80);
+          output.push_back(0X00);
+          break;
+        default:
+          respond(r1 | R1_ILLEGAL_COMMAND);
+          break;
+      }
+    }
+
+    int state;
+    uint8_t command[6];
+    uint8_t buffer[CARD_BLOCK_SIZE];
+    int length;
+    bool multiple;
+    uint32_t address;
+
+    bool idle;
+    bool application;
+    int polls;
+    uint64_t busyUntil;
+    uint64_t busyTime;
+    uint32_t eraseStart;
+    uint32_t eraseEnd;
+    long rejectBlock;
+
+    std::deque<uint8_t> output;
+    std::map<uint32_t, std::vector<uint8_t> > blocks;
+    uint32_t blocksWritten;
+};
+
+static MockCard mock;
+
+static void chipSelect(int pin, int value, uint64_t time) {
+  if(pin == CHIP_SELECT) mock.select(value == LOW);
+}
+
+static void fill(uint8_t *block, uint32_t seed) {
+  for(int i=0; i<CARD_BLOCK_SIZE; i++) {
+    seed = seed * 1103515245 + 12345;
+    block[i] = seed >> 16;
+  }
+}
+
+static double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void testInit(Sd2Card &card) {
+  check(card.init(SPI_FULL_SPEED, CHIP_SELECT), "init");
+  check(card.type() == SD_CARD_TYPE_SDHC, "card is SDHC");
+  check(card.cardSize() == (0X3B37UL + 1) << 10, "card size from the CSD");
+}
+
+static void testSingleBlocks(Sd2Card &card) {
+  uint8_t written[CARD_BLOCK_SIZE], read[CARD_BLOCK_SIZE];
+
+  fill(written, 1);
+  check(card.writeBlock(100, written), "writeBlock");
+  check(memcmp(mock.block(100), written, CARD_BLOCK_SIZE) == 0, "block on the card matches");
+
+  memset(read, 0, sizeof(read));
+  check(card.readBlock(100, read) && memcmp(read, written, CARD_BLOCK_SIZE) == 0, "readBlock reads it back");
+
+  memset(read, 0, sizeof(read));
+  check(card.readData(100, 200, 50, read) && memcmp(read, written + 200, 50) == 0, "readData of part of a block");
+}
+
+static void testErase(Sd2Card &card) {
+  uint8_t block[CARD_BLOCK_SIZE];
+  fill(block, 2);
+  card.writeBlock(200, block);
+  card.writeBlock(201, block);
+
+  check(card.erase(200, 201), "erase");
+
+  uint8_t read[CARD_BLOCK_SIZE];
+  bool zeros = card.readBlock(201, read);
+  for(int i=0; i<CARD_BLOCK_SIZE; i++) zeros = zeros && read[i] == 0;
+  check(zeros, "erased block reads back as zeros");
+}
+
+static void testMultipleBlocks(Sd2Card &card) {
+  const int count = 16;
+  static uint8_t blocks[count][CARD_BLOCK_SIZE];
+
+  check(card.writeStart(1000, count), "writeStart");
+
+  bool started = true, pending = true;
+  for(int i=0; i<count; i++) {
+    fill(blocks[i], 1000 + i);
+    started = started && card.writeDataStart(blocks[i]);
+    pending = pending && card.writePending();
+  }
+  check(started, "writeDataStart for every block");
+  check(pending, "a started block is pending until finished");
+
+  check(card.writeDataFinish() && !card.writePending(), "writeDataFinish clears pending");
+  check(card.writeDataFinish(), "writeDataFinish with nothing pending");
+  check(card.writeStop(), "writeStop");
+
+  bool match = true;
+  for(int i=0; i<count; i++) {
+    match = match && memcmp(mock.block(1000 + i), blocks[i], CARD_BLOCK_SIZE) == 0;
+  }
+  check(match, "every block landed in order");
+
+  // writeStop finishes a block that is still pending
+  fill(blocks[0], 2000);
+  card.writeStart(2000, 1);
+  card.writeDataStart(blocks[0]);
+  check(card.writeStop() && memcmp(mock.block(2000), blocks[0], CARD_BLOCK_SIZE) == 0, "writeStop finishes the last block");
+}
+
+static void testRejectedBlock(Sd2Card &card) {
+  uint8_t block[CARD_BLOCK_SIZE];
+  fill(block, 3);
+
+  card.writeStart(3000, 4);
+  mock.reject(1);
+  card.writeDataStart(block);
+  card.writeDataStart(block);
+  check(!card.writeDataFinish(), "writeDataFinish fails on a rejected block");
+  check(card.errorCode() == SD_CARD_ERROR_WRITE, "error is SD_CARD_ERROR_WRITE");
+  card.writeStop();
+
+  card.writeStart(3100, 4);
+  mock.reject(0);
+  card.writeDataStart(block);
+  check(!card.writeDataStart(block), "writeDataStart fails after a rejected block");
+  card.writeStop();
+}
+
+static void testBusyTimeout(Sd2Card &card) {
+  uint8_t block[CARD_BLOCK_SIZE];
+  fill(block, 4);
+
+  card.writeStart(4000, 2);
+  mock.setBusyTime((uint64_t)SD_WRITE_TIMEOUT * 2000);
+  card.writeDataStart(block);
+  card.writeDataFinish();
+
+  uint64_t start = Sitl::now();
+  check(!card.writeDataStart(block), "writeDataStart fails while the card stays busy");
+  check(card.errorCode() == SD_CARD_ERROR_WRITE_MULTIPLE, "error is SD_CARD_ERROR_WRITE_MULTIPLE");
+  // millis() ticks over up to 1 ms after the wait starts
+  check(Sitl::now() - start >= (uint64_t)(SD_WRITE_TIMEOUT - 1) * 1000, "only after SD_WRITE_TIMEOUT");
+
+  mock.setBusyTime(CARD_PROGRAM_TIME);
+  Sitl::advanceTo(Sitl::now() + (uint64_t)SD_WRITE_TIMEOUT * 2000);
+  card.writeStop();
+}
+
+static void benchmark(Sd2Card &card, uint8_t sckRate, long count) {
+  static uint8_t blocks[2][CARD_BLOCK_SIZE];
+  fill(blocks[0], 5);
+  fill(blocks[1], 6);
+
+  mock.reset();
+  card.init(sckRate, CHIP_SELECT);
+
+  uint64_t transferred = SPI.getTransferred();
+  uint64_t simStart = Sitl::now();
+  double start = now();
+
+  bool ok = card.writeStart(10000, count);
+  for(long i=0; ok && i<count; i++) {
+    ok = card.writeDataStart(blocks[i & 1]);
+  }
+  ok = ok && card.writeStop();
+
+  double elapsed = now() - start;
+  double simulated = (Sitl::now() - simStart) * 1e-6;
+
+  if(!ok || mock.getBlocksWritten() != (uint32_t)count) {
+    printf("FAIL benchmark at rate %d\n", sckRate);
+    failures++;
+    return;
+  }
+
+  printf("sdcardtest: rate %d, %5.2f MHz: %7.1f us of bus per block, %6.1f kB/s, "
+         "%.1f bytes per block, %.0f ns host per block\n",
+         sckRate, SPI.getClock() / 1e6, simulated * 1e6 / count,
+         count * CARD_BLOCK_SIZE / simulated / 1024,
+         (double)(SPI.getTransferred() - transferred) / count, elapsed * 1e9 / count);
+}
+
+static void usage() {
+  fprintf(stderr, "usage: sdcardtest [-n BLOCKS]\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  long count = DEFAULT_BLOCKS;
+
+  for(int i=1; i<argc; i++) {
+    if(strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      count = atol(argv[++i]);
+      if(count < 1) usage();
+    } else {
+      usage();
+    }
+  }
+
+  SPI.attach(&mock);
+  Sitl::setPinListener(chipSelect);
+
+  Sd2Card card;
+  testInit(card);
+  testSingleBlocks(card);
+  testErase(card);
+  testMultipleBlocks(card);
+  testRejectedBlock(card);
+  testBusyTimeout(card);
+
+  for(uint8_t rate=SPI_FULL_SPEED; rate<=SPI_QUARTER_SPEED; rate++) {
+    benchmark(card, rate, count);
+  }
+
+  return checkResult("sdcardtest");
+}
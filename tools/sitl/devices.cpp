@@ -0,0 +1,209 @@
+#include "devices.h"
+#include "sitl.h"
+
+#include <MS5xxx.h>
+#include <Adafruit_BNO055.h>
+#include <airbrake.h>
+
+double isaPressure(double altitude) {
+  return ISA_SEA_LEVEL_PRESSURE * pow(1 - 2.25577e-5 * altitude, 5.25588);
+}
+
+// Calibration words from the MS5607 datasheet example
+static const uint16_t MS5607_PROM[8] = { 0, 46372, 43981, 29059, 27842, 31553, 28165, 0 };
+
+// Typical conversion times for OSR 256 to 4096
+static const uint64_t MS5607_CONV_TIME[5] = { 540, 1060, 2080, 4130, 8220 }; // us
+
+Ms5607::Ms5607(const Truth *truth, random_t *random, double noise) :
+  truth(truth), random(random), noise(0, noise), reading(READ_NONE), promIndex(0),
+  converting(false), convStart(0), convTime(0), result(0), conversions(0), earlyReads(0) {
+  memcpy(prom, MS5607_PROM, sizeof(prom));
+  prom[7] |= crc4();
+}
+
+// AN520, over the eight PROM words with the CRC nibble zeroed
+uint16_t Ms5607::crc4() const {
+  unsigned int remainder = 0;
+
+  for(int i = 0; i < 16; i++) {
+    uint16_t word = (i == 15 ? prom[7] & 0xFF00 : prom[i >> 1]);
+    remainder ^= (i % 2 == 1 ? word & 0xFF : word >> 8);
+
+    for(int bit = 0; bit < 8; bit++) {
+      remainder = (remainder & 0x8000 ? (remainder << 1) ^ 0x3000 : remainder << 1);
+    }
+  }
+
+  return (remainder >> 12) & 0xF;
+}
+
+void Ms5607::received(const uint8_t *data, size_t size) {
+  // A bare address probe
+  if(size == 0) return;
+
+  uint8_t command = data[0];
+
+  if(command == MS5xxx_CMD_RESET) {
+    converting = false;
+    reading = READ_NONE;
+  } else if(command >= MS5xxx_CMD_PROM_RD && command <= MS5xxx_CMD_PROM_RD + 14) {
+    promIndex = (command - MS5xxx_CMD_PROM_RD) / 2;
+    reading = READ_PROM;
+  } else if((command & 0xE0) == MS5xxx_CMD_ADC_CONV) {
+    int osr = (command & 0x0F) / 2;
+    if(osr > 4) osr = 4;
+
+    result = convert(command & MS5xxx_CMD_ADC_D2);
+    convStart = Sitl::now();
+    convTime = MS5607_CONV_TIME[osr];
+    converting = true;
+    conversions++;
+  } else if(command == MS5xxx_CMD_ADC_READ) {
+    reading = READ_ADC;
+  }
+}
+
+size_t Ms5607::requested(uint8_t *data, size_t size) {
+  if(reading == READ_PROM && size >= 2) {
+    data[0] = prom[promIndex] >> 8;
+    data[1] = prom[promIndex] & 0xFF;
+    reading = READ_NONE;
+    return 2;
+  }
+
+  if(reading == READ_ADC && size >= 3) {
+    // Reading before the conversion is done aborts it and returns zero
+    uint32_t value = 0;
+    if(converting && Sitl::now() - convStart >= convTime) {
+      value = result;
+    } else {
+      earlyReads++;
+    }
+
+    data[0] = value >> 16;
+    data[1] = (value >> 8) & 0xFF;
+    data[2] = value & 0xFF;
+    converting = false;
+    reading = READ_NONE;
+    return 3;
+  }
+
+  return 0;
+}
+
+// Find the raw ADC reading the driver's own compensation turns into the
+// wanted temperature or pressure. Both are monotonic in the reading.
+uint32_t Ms5607::convert(bool temperature) {
+  MS5xxx_Calibration cal;
+  cal.SENS_T1 = prom[1];
+  cal.OFF_T1 = prom[2];
+  cal.TCS = prom[3];
+  cal.TCO = prom[4];
+  cal.T_REF = prom[5];
+  cal.TEMPSENS = prom[6];
+
+  int32_t wantTemperature = BOARD_TEMPERATURE * 100;
+  int32_t wantPressure = (int32_t)lround(isaPressure(truth->altitude) + noise(*random));
+
+  // D2 first, since pressure compensation depends on it
+  uint32_t low = 0, high = (1 << 24) - 1;
+  while(low < high) {
+    uint32_t mid = (low + high) / 2;
+    int32_t P, TEMP;
+    MS5xxx::Compensate(cal, 0, mid, &P, &TEMP);
+    if(TEMP < wantTemperature) low = mid + 1;
+    else high = mid;
+  }
+  if(temperature) return low;
+
+  uint32_t D2 = low;
+  low = 0;
+  high = (1 << 24) - 1;
+  while(low < high) {
+    uint32_t mid = (low + high) / 2;
+    int32_t P, TEMP;
+    MS5xxx::Compensate(cal, mid, D2, &P, &TEMP);
+    if(P < wantPressure) low = mid + 1;
+    else high = mid;
+  }
+
+  return low;
+}
+
+Bno055::Bno055(const Truth *truth, random_t *random, double noise) :
+  truth(truth), random(random), noise(0, noise), address(0) {
+  memset(registers, 0, sizeof(registers));
+  registers[Adafruit_BNO055::BNO055_CHIP_ID_ADDR] = BNO055_ID;
+  registers[Adafruit_BNO055::BNO055_ACCEL_REV_ID_ADDR] = 0xFB;
+  registers[Adafruit_BNO055::BNO055_MAG_REV_ID_ADDR] = 0x32;
+  registers[Adafruit_BNO055::BNO055_GYRO_REV_ID_ADDR] = 0x0F;
+  registers[Adafruit_BNO055::BNO055_SELFTEST_RESULT_ADDR] = 0x0F;
+  registers[Adafruit_BNO055::BNO055_CALIB_STAT_ADDR] = 0xFF;
+}
+
+void Bno055::received(const uint8_t *data, size_t size) {
+  if(size == 0) return;
+
+  address = data[0] & 0x7F;
+  for(size_t i = 1; i < size; i++) {
+    registers[(address + i - 1) & 0x7F] = data[i];
+  }
+}
+
+size_t Bno055::requested(uint8_t *data, size_t size) {
+  if(address < Adafruit_BNO055::BNO055_CALIB_STAT_ADDR &&
+     address + size > Adafruit_BNO055::BNO055_ACCEL_DATA_X_LSB_ADDR) {
+    update();
+  }
+
+  for(size_t i = 0; i < size; i++) {
+    data[i] = registers[(address + i) & 0x7F];
+  }
+  address = (address + size) & 0x7F;
+  return size;
+}
+
+void Bno055::setVector(uint8_t at, double x, double y, double z, double lsb) {
+  double values[3] = { x, y, z };
+
+  for(int i = 0; i < 3; i++) {
+    double raw = round(values[i] * lsb);
+    if(raw > 32767) raw = 32767;
+    if(raw < -32768) raw = -32768;
+
+    int16_t value = (int16_t)raw;
+    registers[at + 2*i] = (uint16_t)value & 0xFF;
+    registers[at + 2*i + 1] = (uint16_t)value >> 8;
+  }
+}
+
+// The board is mounted with its x axis along the rocket, pointing up, and
+// the rocket flies straight up. Fusion's gravity estimate stays put, so
+// linear acceleration is everything else the accelerometer sees.
+void Bno055::update() {
+  double range = BNO055_ACCEL_RANGE * GRAV;
+
+  double accel[3] = { truth->acceleration + GRAV + noise(*random), noise(*random), noise(*random) };
+  for(int i = 0; i < 3; i++) {
+    if(accel[i] > range) accel[i] = range;
+    if(accel[i] < -range) accel[i] = -range;
+  }
+
+  setVector(Adafruit_BNO055::BNO055_ACCEL_DATA_X_LSB_ADDR, accel[0], accel[1], accel[2], 100);
+  setVector(Adafruit_BNO055::BNO055_MAG_DATA_X_LSB_ADDR, -40, 0, 20, 16);
+  setVector(Adafruit_BNO055::BNO055_GYRO_DATA_X_LSB_ADDR, 0, 0, 0, 16);
+  setVector(Adafruit_BNO055::BNO055_EULER_H_LSB_ADDR, 0, 0, 90, 16);
+  setVector(Adafruit_BNO055::BNO055_LINEAR_ACCEL_DATA_X_LSB_ADDR, accel[0] - GRAV, accel[1], accel[2], 100);
+  setVector(Adafruit_BNO055::BNO055_GRAVITY_DATA_X_LSB_ADDR, GRAV, 0, 0, 100);
+
+  // Nose up: a quarter turn about y
+  uint8_t at = Adafruit_BNO055::BNO055_QUATERNION_DATA_W_LSB_ADDR;
+  int16_t quaternion[4] = { 11585, 0, 11585, 0 }; // 2^14 / sqrt(2)
+  for(int i = 0; i < 4; i++) {
+    registers[at + 2*i] = (uint16_t)quaternion[i] & 0xFF;
+    registers[at + 2*i + 1] = (uint16_t)quaternion[i] >> 8;
+  }
+
+  registers[Adafruit_BNO055::BNO055_TEMP_ADDR] = BOARD_TEMPERATURE;
+}
@@ -0,0 +1,86 @@
+#ifndef DEVICES_H
+#define DEVICES_H
+
+// Simulated sensors for the flight simulator
+//
+// The barometer and IMU sit on the simulated I2C bus and answer the same
+// register and command traffic as the real parts, so the unmodified drivers
+// run against them. Readings come from the truth trajectory plus noise.
+
+#include <random>
+#include <Wire.h>
+
+#define MS5607_ADDRESS 0x76
+#define BNO055_ADDRESS 0x28
+
+#define ISA_SEA_LEVEL_PRESSURE 101325 // Pa
+#define BOARD_TEMPERATURE 25 // C
+
+// IMU full scale in fusion mode
+#define BNO055_ACCEL_RANGE 4 // g
+
+struct Truth {
+  double time;          // s
+  double altitude;      // m, above sea level
+  double velocity;      // m/s, up
+  double acceleration;  // m/s^2, up, zero at rest
+};
+
+typedef std::mt19937_64 random_t;
+
+// Pressure at an altitude in the standard atmosphere
+double isaPressure(double altitude);
+
+class Ms5607 : public I2CDevice {
+  public:
+    Ms5607(const Truth *truth, random_t *random, double noise);
+
+    void received(const uint8_t *data, size_t size);
+    size_t requested(uint8_t *data, size_t size);
+
+    unsigned long getConversions() const { return conversions; }
+    unsigned long getEarlyReads() const { return earlyReads; }
+
+  protected:
+    uint32_t convert(bool temperature);
+    uint16_t crc4() const;
+
+    enum { READ_NONE, READ_PROM, READ_ADC };
+
+    const Truth *truth;
+    random_t *random;
+    std::normal_distribution<double> noise; // Pa
+
+    uint16_t prom[8];
+    int reading;
+    int promIndex;
+
+    bool converting;
+    uint64_t convStart; // us
+    uint64_t convTime;  // us
+    uint32_t result;
+
+    unsigned long conversions;
+    unsigned long earlyReads;
+};
+
+class Bno055 : public I2CDevice {
+  public:
+    Bno055(const Truth *truth, random_t *random, double noise);
+
+    void received(const uint8_t *data, size_t size);
+    size_t requested(uint8_t *data, size_t size);
+
+  protected:
+    void update();
+    void setVector(uint8_t address, double x, double y, double z, double lsb);
+
+    const Truth *truth;
+    random_t *random;
+    std::normal_distribution<double> noise; // m/s^2
+
+    uint8_t registers[128];
+    uint8_t address;
+};
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef ADAFRUIT_GPS_H
+#define ADAFRUIT_GPS_H
+
+// Host stand-in for the GPS library, of which the flight software only uses
+// the receiver commands. The simulator sends NMEA sentences to GPS::GPSSerial
+// as the receiver would.
+
+#define PMTK_SET_NMEA_OUTPUT_RMCGGA "$PMTK314,0,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0*28"
+#define PMTK_SET_NMEA_UPDATE_5HZ "$PMTK220,200*2C"
+#define PMTK_API_SET_FIX_CTL_5HZ "$PMTK300,200,0,0,0,0*2F"
+
+#endif
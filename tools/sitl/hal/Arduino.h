@@ -0,0 +1,123 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// Host stand-in for the Arduino core, just the parts the Osprey library uses
+//
+// Time is simulated (see sitl.h). Pins are recorded instead of driven, and
+// every serial port is a byte queue the simulator feeds and drains.
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+#define A7 25
+
+// The Feather M0's SPI pins, as its variant.h has them
+#define SS 16
+#define MOSI 23
+#define MISO 22
+#define SCK 24
+
+#define DEC 10
+#define HEX 16
+
+#define PI 3.1415926535897932384626433832795
+
+// The core's abs is a macro that works on floats too. A template does the
+// same without breaking C++ library headers included after this one.
+#ifdef abs
+#undef abs
+#endif
+template<typename T> inline T abs(T x) { return x > 0 ? x : -x; }
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int value);
+int digitalRead(int pin);
+int analogRead(int pin);
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *s) { return write((const uint8_t*)s, strlen(s)); }
+    virtual void flush() {}
+
+    size_t print(const char *s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int n, int base=DEC) { return print((long)n, base); }
+    size_t print(unsigned int n, int base=DEC) { return print((unsigned long)n, base); }
+    size_t print(long n, int base=DEC);
+    size_t print(unsigned long n, int base=DEC);
+    size_t print(double n, int digits=2);
+
+    size_t println() { return write("\r\n"); }
+    template<typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    template<typename T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+class SERCOM {};
+extern SERCOM sercom1;
+
+#define SERCOM_RX_PAD_0 0
+#define UART_TX_PAD_2 2
+
+// A serial port. What the firmware writes goes to a file descriptor, what it
+// reads comes from a queue the simulator fills with receive().
+class Uart : public Stream {
+  public:
+    Uart();
+    Uart(SERCOM *sercom, int rxPin, int txPin, int rxPad, int txPad);
+
+    void begin(unsigned long baud);
+    void end() {}
+    int available();
+    int availableForWrite();
+    int read();
+    int peek();
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *buffer, size_t size);
+    using Print::write;
+    operator bool() { return true; }
+
+    void IrqHandler() {}
+
+    // Simulator side
+    void setOutput(int fd);
+    void receive(const uint8_t *data, size_t size);
+
+  protected:
+    enum { RX_BUFFER_SIZE = 4096 };
+    uint8_t rxBuffer[RX_BUFFER_SIZE];
+    size_t rxHead;
+    size_t rxTail;
+    int output;
+};
+
+extern Uart Serial;
+extern Uart Serial1;
+
+#endif
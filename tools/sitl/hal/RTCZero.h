@@ -0,0 +1,27 @@
+#ifndef RTC_ZERO_H
+#define RTC_ZERO_H
+
+// Host stand-in for the SAMD21 real time clock, counting simulated time
+
+#include "Arduino.h"
+
+class RTCZero {
+  public:
+    RTCZero();
+    void begin(bool resetTime=false) {}
+
+    uint8_t getSeconds();
+    uint8_t getMinutes();
+    uint8_t getHours();
+
+    void setTime(uint8_t hours, uint8_t minutes, uint8_t seconds);
+    void setDate(uint8_t day, uint8_t month, uint8_t year) {}
+
+  protected:
+    uint32_t elapsed();
+
+    unsigned long setAt; // ms
+    uint32_t setTo;      // s
+};
+
+#endif
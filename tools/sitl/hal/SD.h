@@ -0,0 +1,111 @@
+#ifndef __SD_H__
+#define __SD_H__
+
+// Host stand-in for the SD library. The card is a directory on the host and
+// each file on it a host file, so logs can be read straight back with
+// tools/logdecode. Contiguous files are mapped onto a range of blocks so raw
+// multiple block writes land in the right file.
+
+#include <fcntl.h>
+#include "Arduino.h"
+
+// O_CREAT and O_RDONLY are the host's own
+#define O_READ 0x01
+#define O_WRITE 0x02
+
+#define FILE_READ O_READ
+#define FILE_WRITE (O_READ | O_WRITE | O_CREAT)
+
+uint8_t const SPI_FULL_SPEED = 0;
+uint8_t const SPI_HALF_SPEED = 1;
+uint8_t const SD_CHIP_SELECT_PIN = 4;
+
+#define SD_BLOCK_SIZE 512
+
+class SdFile {
+  public:
+    SdFile();
+    uint8_t isOpen() const { return fd >= 0; }
+    uint8_t close();
+    uint8_t remove();
+    uint8_t truncate(uint32_t size);
+    uint8_t contiguousRange(uint32_t *bgnBlock, uint32_t *endBlock);
+
+  protected:
+    int fd;
+    char path[256];
+    uint32_t firstBlock;
+    uint32_t blocks;
+
+    friend class SDClass;
+    friend class Sd2Card;
+    friend class File;
+};
+
+class Sd2Card {
+  public:
+    Sd2Card();
+    uint8_t erase(uint32_t firstBlock, uint32_t lastBlock);
+    uint8_t writeStart(uint32_t blockNumber, uint32_t eraseCount);
+    uint8_t writeData(const uint8_t *src) { return writeDataStart(src); }
+    uint8_t writeDataStart(const uint8_t *src);
+    uint8_t writeDataFinish() { pending = false; return true; }
+    uint8_t writePending() const { return pending; }
+    uint8_t writeStop();
+
+  protected:
+    SdFile *find(uint32_t block);
+
+    enum { MAX_CONTIGUOUS = 4 };
+    SdFile *contiguous[MAX_CONTIGUOUS];
+    uint32_t nextFree;
+    uint32_t writeBlock;
+    bool writing;
+    bool pending;
+
+    friend class SDClass;
+    friend class SdFile;
+};
+
+class File : public Stream {
+  public:
+    File();
+    virtual size_t write(uint8_t c);
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    virtual int read();
+    virtual int peek();
+    virtual int available();
+    virtual void flush();
+    uint32_t size();
+    void close();
+    operator bool();
+    using Print::write;
+
+  protected:
+    int fd;
+
+    friend class SDClass;
+};
+
+class SDClass {
+  public:
+    boolean begin(uint8_t csPin=SD_CHIP_SELECT_PIN, uint8_t sckRateID=SPI_HALF_SPEED);
+    File open(const char *filename, uint8_t mode=FILE_READ);
+    boolean exists(const char *filepath);
+    boolean remove(const char *filepath);
+    boolean createContiguous(SdFile &file, const char *filename, uint32_t size);
+    Sd2Card &sdCard() { return card; }
+
+    // Simulator side, where the card lives on the host
+    void setRoot(const char *directory);
+
+  protected:
+    void path(const char *filename, char *buffer, size_t size);
+
+    Sd2Card card;
+    char root[200];
+};
+
+extern SDClass SD;
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef SPI_H
+#define SPI_H
+
+// Nothing talks SPI on the host, the SD card is simulated above it (see SD.h)
+
+#include "Arduino.h"
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef WIRE_H
+#define WIRE_H
+
+// Host stand-in for the I2C bus. Simulated devices attach at their address
+// and see exactly the transfers the real drivers make.
+
+#include "Arduino.h"
+
+#define WIRE_BUFFER_LENGTH 64
+#define WIRE_MAX_DEVICES 8
+
+class I2CDevice {
+  public:
+    virtual ~I2CDevice() {}
+    // The master wrote these bytes in one transmission
+    virtual void received(const uint8_t *data, size_t size) = 0;
+    // The master asked for size bytes. Returns how many were sent.
+    virtual size_t requested(uint8_t *data, size_t size) = 0;
+};
+
+class TwoWire : public Stream {
+  public:
+    TwoWire();
+
+    void begin() {}
+    void setClock(uint32_t frequency) {}
+
+    void beginTransmission(uint8_t address);
+    uint8_t endTransmission(bool stopBit=true);
+    uint8_t requestFrom(uint8_t address, size_t quantity, bool stopBit=true);
+
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t size);
+    using Print::write;
+    int available();
+    int read();
+    int peek();
+
+    // Simulator side
+    void attach(uint8_t address, I2CDevice *device);
+
+  protected:
+    I2CDevice *find(uint8_t address);
+
+    uint8_t addresses[WIRE_MAX_DEVICES];
+    I2CDevice *devices[WIRE_MAX_DEVICES];
+    int deviceCount;
+
+    uint8_t txAddress;
+    uint8_t txBuffer[WIRE_BUFFER_LENGTH];
+    size_t txLength;
+
+    uint8_t rxBuffer[WIRE_BUFFER_LENGTH];
+    size_t rxLength;
+    size_t rxIndex;
+};
+
+extern TwoWire Wire;
+
+#endif
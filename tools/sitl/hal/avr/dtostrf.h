@@ -0,0 +1,6 @@
+#ifndef DTOSTRF_H
+#define DTOSTRF_H
+
+char *dtostrf(double value, signed char width, unsigned char precision, char *buffer);
+
+#endif
@@ -0,0 +1,474 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Arduino.h"
+#include "RTCZero.h"
+#ifndef SITL_NO_SD
+#include "SD.h"
+#endif
+#include "Wire.h"
+#include "avr/dtostrf.h"
+#include "sitl.h"
+
+// Clock
+
+static uint64_t simTime = 0;
+static Sitl::delay_listener_t delayListener = 0;
+
+uint64_t Sitl::now() {
+  return simTime;
+}
+
+void Sitl::advanceTo(uint64_t time) {
+  if(time > simTime) simTime = time;
+}
+
+void Sitl::setDelayListener(delay_listener_t listener) {
+  delayListener = listener;
+}
+
+unsigned long micros() {
+  unsigned long time = simTime;
+  simTime += SITL_CLOCK_READ_COST;
+  return time;
+}
+
+unsigned long millis() {
+  return micros() / 1000;
+}
+
+void delay(unsigned long ms) {
+  simTime += (uint64_t)ms * 1000;
+  if(delayListener) delayListener(simTime);
+}
+
+void delayMicroseconds(unsigned int us) {
+  simTime += us;
+  if(delayListener) delayListener(simTime);
+}
+
+// Pins
+
+static int pins[SITL_PINS];
+static int analog[SITL_PINS];
+static Sitl::pin_listener_t pinListener = 0;
+
+int Sitl::pinState(int pin) {
+  return (pin >= 0 && pin < SITL_PINS) ? pins[pin] : LOW;
+}
+
+void Sitl::setPinListener(pin_listener_t listener) {
+  pinListener = listener;
+}
+
+void Sitl::setAnalog(int pin, int value) {
+  if(pin >= 0 && pin < SITL_PINS) analog[pin] = value;
+}
+
+void pinMode(int pin, int mode) {}
+
+void digitalWrite(int pin, int value) {
+  if(pin < 0 || pin >= SITL_PINS) return;
+
+  value = value ? HIGH : LOW;
+  if(pins[pin] != value && pinListener) {
+    pinListener(pin, value, simTime);
+  }
+  pins[pin] = value;
+}
+
+int digitalRead(int pin) {
+  return Sitl::pinState(pin);
+}
+
+int analogRead(int pin) {
+  return (pin >= 0 && pin < SITL_PINS) ? analog[pin] : 0;
+}
+
+// Print
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while(size--) {
+    n += write(*buffer++);
+  }
+  return n;
+}
+
+size_t Print::print(long n, int base) {
+  if(base == DEC) {
+    char buffer[24];
+    snprintf(buffer, sizeof(buffer), "%ld", n);
+    return write(buffer);
+  }
+  return print((unsigned long)n, base);
+}
+
+size_t Print::print(unsigned long n, int base) {
+  char buffer[24];
+  snprintf(buffer, sizeof(buffer), base == HEX ? "%lX" : "%lu", n);
+  return write(buffer);
+}
+
+size_t Print::print(double n, int digits) {
+  char buffer[48];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, n);
+  return write(buffer);
+}
+
+char *dtostrf(double value, signed char width, unsigned char precision, char *buffer) {
+  sprintf(buffer, "%*.*f", width, precision, value);
+  return buffer;
+}
+
+// Serial ports
+
+SERCOM sercom1;
+Uart Serial;
+Uart Serial1;
+
+Uart::Uart() : rxHead(0), rxTail(0), output(-1) {}
+
+Uart::Uart(SERCOM *sercom, int rxPin, int txPin, int rxPad, int txPad) : rxHead(0), rxTail(0), output(-1) {}
+
+void Uart::begin(unsigned long baud) {}
+
+int Uart::available() {
+  return (int)(rxHead - rxTail);
+}
+
+int Uart::availableForWrite() {
+  return 64;
+}
+
+int Uart::read() {
+  if(rxHead == rxTail) return -1;
+  return rxBuffer[rxTail++ % RX_BUFFER_SIZE];
+}
+
+int Uart::peek() {
+  if(rxHead == rxTail) return -1;
+  return rxBuffer[rxTail % RX_BUFFER_SIZE];
+}
+
+size_t Uart::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t Uart::write(const uint8_t *buffer, size_t size) {
+  if(output >= 0 && ::write(output, buffer, size) < 0) {
+    return 0;
+  }
+  return size;
+}
+
+void Uart::setOutput(int fd) {
+  output = fd;
+}
+
+void Uart::receive(const uint8_t *data, size_t size) {
+  // Like the real ring buffer, bytes that don't fit are lost
+  for(size_t i=0; i<size && rxHead - rxTail < RX_BUFFER_SIZE; i++) {
+    rxBuffer[rxHead++ % RX_BUFFER_SIZE] = data[i];
+  }
+}
+
+// I2C
+
+TwoWire Wire;
+
+TwoWire::TwoWire() : deviceCount(0), txAddress(0), txLength(0), rxLength(0), rxIndex(0) {}
+
+void TwoWire::attach(uint8_t address, I2CDevice *device) {
+  if(deviceCount < WIRE_MAX_DEVICES) {
+    addresses[deviceCount] = address;
+    devices[deviceCount] = device;
+    deviceCount++;
+  }
+}
+
+I2CDevice *TwoWire::find(uint8_t address) {
+  for(int i=0; i<deviceCount; i++) {
+    if(addresses[i] == address) return devices[i];
+  }
+  return 0;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  txAddress = address;
+  txLength = 0;
+}
+
+uint8_t TwoWire::endTransmission(bool stopBit) {
+  I2CDevice *device = find(txAddress);
+
+  // 2 is a NACK on the address, like the SAMD core
+  if(!device) return 2;
+
+  device->received(txBuffer, txLength);
+  txLength = 0;
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, size_t quantity, bool stopBit) {
+  I2CDevice *device = find(address);
+  if(quantity > WIRE_BUFFER_LENGTH) quantity = WIRE_BUFFER_LENGTH;
+
+  rxIndex = 0;
+  rxLength = device ? device->requested(rxBuffer, quantity) : 0;
+  return rxLength;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if(txLength >= WIRE_BUFFER_LENGTH) return 0;
+  txBuffer[txLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t size) {
+  size_t n = 0;
+  while(n < size && write(data[n])) {
+    n++;
+  }
+  return n;
+}
+
+int TwoWire::available() {
+  return rxLength - rxIndex;
+}
+
+int TwoWire::read() {
+  return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1;
+}
+
+int TwoWire::peek() {
+  return rxIndex < rxLength ? rxBuffer[rxIndex] : -1;
+}
+
+// SD card, left out with SITL_NO_SD by tools that link the real Sd2Card
+
+#ifndef SITL_NO_SD
+SDClass SD;
+
+SdFile::SdFile() : fd(-1), firstBlock(0), blocks(0) {
+  path[0] = '\0';
+}
+
+uint8_t SdFile::close() {
+  if(fd < 0) return false;
+
+  Sd2Card &card = SD.sdCard();
+  for(int i=0; i<Sd2Card::MAX_CONTIGUOUS; i++) {
+    if(card.contiguous[i] == this) card.contiguous[i] = 0;
+  }
+
+  ::close(fd);
+  fd = -1;
+  return true;
+}
+
+uint8_t SdFile::remove() {
+  close();
+  return unlink(path) == 0;
+}
+
+uint8_t SdFile::truncate(uint32_t size) {
+  return fd >= 0 && ftruncate(fd, size) == 0;
+}
+
+uint8_t SdFile::contiguousRange(uint32_t *bgnBlock, uint32_t *endBlock) {
+  if(fd < 0 || blocks == 0) return false;
+
+  *bgnBlock = firstBlock;
+  *endBlock = firstBlock + blocks - 1;
+  return true;
+}
+
+Sd2Card::Sd2Card() : nextFree(0x1000), writeBlock(0), writing(false), pending(false) {
+  for(int i=0; i<MAX_CONTIGUOUS; i++) {
+    contiguous[i] = 0;
+  }
+}
+
+SdFile *Sd2Card::find(uint32_t block) {
+  for(int i=0; i<MAX_CONTIGUOUS; i++) {
+    SdFile *file = contiguous[i];
+    if(file && block >= file->firstBlock && block < file->firstBlock + file->blocks) {
+      return file;
+    }
+  }
+  return 0;
+}
+
+uint8_t Sd2Card::erase(uint32_t firstBlock, uint32_t lastBlock) {
+  // Contiguous files are created sparse, so they already read back as zeros
+  return true;
+}
+
+uint8_t Sd2Card::writeStart(uint32_t blockNumber, uint32_t eraseCount) {
+  writeBlock = blockNumber;
+  writing = true;
+  return true;
+}
+
+uint8_t Sd2Card::writeDataStart(const uint8_t *src) {
+  SdFile *file = writing ? find(writeBlock) : 0;
+  if(!file) return false;
+
+  off_t offset = (off_t)(writeBlock - file->firstBlock) * SD_BLOCK_SIZE;
+  if(pwrite(file->fd, src, SD_BLOCK_SIZE, offset) != SD_BLOCK_SIZE) {
+    return false;
+  }
+
+  writeBlock++;
+  pending = true;
+  return true;
+}
+
+uint8_t Sd2Card::writeStop() {
+  if(!writing) return false;
+
+  writing = false;
+  pending = false;
+  return true;
+}
+
+File::File() : fd(-1) {}
+
+size_t File::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t File::write(const uint8_t *buffer, size_t size) {
+  if(fd < 0) return 0;
+
+  ssize_t n = ::write(fd, buffer, size);
+  return n < 0 ? 0 : n;
+}
+
+int File::read() {
+  uint8_t c;
+  return (fd >= 0 && ::read(fd, &c, 1) == 1) ? c : -1;
+}
+
+int File::peek() {
+  int c = read();
+  if(c >= 0) lseek(fd, -1, SEEK_CUR);
+  return c;
+}
+
+int File::available() {
+  if(fd < 0) return 0;
+  off_t position = lseek(fd, 0, SEEK_CUR);
+  return size() - position;
+}
+
+void File::flush() {}
+
+uint32_t File::size() {
+  struct stat info;
+  return (fd >= 0 && fstat(fd, &info) == 0) ? info.st_size : 0;
+}
+
+void File::close() {
+  if(fd >= 0) ::close(fd);
+  fd = -1;
+}
+
+File::operator bool() {
+  return fd >= 0;
+}
+
+void SDClass::setRoot(const char *directory) {
+  snprintf(root, sizeof(root), "%s", directory);
+}
+
+void SDClass::path(const char *filename, char *buffer, size_t size) {
+  snprintf(buffer, size, "%s/%s", root[0] ? root : ".", filename);
+}
+
+boolean SDClass::begin(uint8_t csPin, uint8_t sckRateID) {
+  if(root[0] && mkdir(root, 0755) != 0 && errno != EEXIST) {
+    return false;
+  }
+  return true;
+}
+
+File SDClass::open(const char *filename, uint8_t mode) {
+  char name[256];
+  path(filename, name, sizeof(name));
+
+  File file;
+  if(mode & O_WRITE) {
+    // Writes append, like the real library
+    file.fd = ::open(name, O_RDWR | ((mode & O_CREAT) ? O_CREAT : 0) | O_APPEND, 0644);
+  } else {
+    file.fd = ::open(name, O_RDONLY);
+  }
+  return file;
+}
+
+boolean SDClass::exists(const char *filepath) {
+  char name[256];
+  path(filepath, name, sizeof(name));
+  return access(name, F_OK) == 0;
+}
+
+boolean SDClass::remove(const char *filepath) {
+  char name[256];
+  path(filepath, name, sizeof(name));
+  return unlink(name) == 0;
+}
+
+boolean SDClass::createContiguous(SdFile &file, const char *filename, uint32_t size) {
+  int slot = -1;
+  for(int i=0; i<Sd2Card::MAX_CONTIGUOUS; i++) {
+    if(!card.contiguous[i]) slot = i;
+  }
+  if(slot < 0 || file.isOpen()) return false;
+
+  path(filename, file.path, sizeof(file.path));
+  file.fd = ::open(file.path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if(file.fd < 0) return false;
+
+  // Sparse, so a big recorder file costs nothing until it's written
+  if(ftruncate(file.fd, size) != 0) {
+    file.remove();
+    return false;
+  }
+
+  file.firstBlock = card.nextFree;
+  file.blocks = (size + SD_BLOCK_SIZE - 1) / SD_BLOCK_SIZE;
+  card.nextFree += file.blocks;
+  card.contiguous[slot] = &file;
+
+  return true;
+}
+#endif
+
+// Real time clock
+
+RTCZero::RTCZero() : setAt(0), setTo(0) {}
+
+uint32_t RTCZero::elapsed() {
+  return setTo + (uint32_t)((simTime / 1000 - setAt) / 1000);
+}
+
+uint8_t RTCZero::getSeconds() {
+  return elapsed() % 60;
+}
+
+uint8_t RTCZero::getMinutes() {
+  return elapsed() / 60 % 60;
+}
+
+uint8_t RTCZero::getHours() {
+  return elapsed() / 3600 % 24;
+}
+
+void RTCZero::setTime(uint8_t hours, uint8_t minutes, uint8_t seconds) {
+  setAt = simTime / 1000;
+  setTo = hours * 3600UL + minutes * 60UL + seconds;
+}
@@ -0,0 +1,31 @@
+#ifndef SITL_H
+#define SITL_H
+
+// The simulator's side of the host HAL
+//
+// Time only moves when the simulator moves it or the firmware waits. Reading
+// the clock also costs SITL_CLOCK_READ_COST, which stands in for the time
+// code takes to run and keeps busy-wait loops like "poll until the sensor
+// is ready" from spinning forever at one instant.
+
+#include <stdint.h>
+
+#define SITL_CLOCK_READ_COST 1 // us
+#define SITL_PINS 64
+
+namespace Sitl {
+  typedef void (*pin_listener_t)(int pin, int value, uint64_t time);
+  typedef void (*delay_listener_t)(uint64_t time);
+
+  uint64_t now(); // us, without charging for the read
+  void advanceTo(uint64_t time);
+
+  // Called after the firmware waits, so the world can catch up with the clock
+  void setDelayListener(delay_listener_t listener);
+
+  int pinState(int pin);
+  void setPinListener(pin_listener_t listener);
+  void setAnalog(int pin, int value);
+}
+
+#endif
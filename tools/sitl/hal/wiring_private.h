@@ -0,0 +1,10 @@
+#ifndef WIRING_PRIVATE_H
+#define WIRING_PRIVATE_H
+
+#include "Arduino.h"
+
+#define PIO_SERCOM 2
+
+inline int pinPeripheral(int pin, int function) { return 0; }
+
+#endif
@@ -0,0 +1,588 @@
+// Software in the loop flight simulator
+//
+// Build (from the repository root, as one line):
+//   g++ -std=gnu++11 -O2 -DARDUINO=10810 -Itools/sitl/hal -Ilibraries/Osprey -Ilibraries/MS5xxx
+//     -Ilibraries/Adafruit_BNO055 -o sitl tools/sitl/sitl.cpp tools/sitl/devices.cpp tools/sitl/hal/hal.cpp
+//     $(ls libraries/Osprey/*.cpp | grep -v -e /SD.cpp -e /File.cpp -e /RTCZero.cpp)
+//     libraries/MS5xxx/MS5xxx.cpp libraries/Adafruit_BNO055/Adafruit_BNO055.cpp -x c++ osprey/osprey.ino
+// Usage: sitl [-o DIR] [-p] [-r] [-c TIME:COMMAND]... [-l LAUNCH] [-t THRUST] [-b BURN] [-g ALT]
+//             [-n BARO_NOISE] [-a ACCEL_NOISE] [-s SEED] [-x MAX_TIME]
+//
+// Runs the unmodified flight software (osprey.ino, the Osprey library and the
+// sensor drivers) on the host against a simulated flight. tools/sitl/hal
+// stands in for the Arduino core: the clock is simulated, the barometer and
+// IMU are models on the I2C bus (devices.h), the GPS sends NMEA sentences to
+// its UART, the SD card is DIR/sd and the console goes to DIR/serial.txt.
+// The radio goes to DIR/radio.bin, or with -p to a pseudo terminal that a
+// ground station can open while the flight runs (-r paces the simulation to
+// the wall clock for that).
+//
+// The truth trajectory is the point mass model of airbrake.cpp flown at 1 ms
+// steps, with a constant thrust burn from the launch time. The air brakes open
+// when the firmware raises their pin and the drogue and main open with theirs.
+// Every scheduler tick runs the tick interrupt and then loop(). Unless -c or
+// -p is given, the start flight command is sent at START_COMMAND_TIME and the
+// end flight command after landing, which closes the log so tools/logdecode
+// can read it.
+//
+// At the end the detected events are compared with the truth and the host CPU
+// time of every tick that ran a task is summarised. Host CPU time is no
+// measure of the SAMD21's, but the worst ticks and the tasks in them are the
+// ones to look at on the target.
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#include <Arduino.h>
+#include <SD.h>
+#include <Wire.h>
+#include <airbrake.h>
+#include <constants.h>
+#include <event.h>
+#include <gps.h>
+#include <radio.h>
+#include <scheduler.h>
+#include <sitl.h>
+
+#include "devices.h"
+
+#define TICK 1000                 // us, one scheduler tick
+#define STEP 0.001                // s, truth integration step
+#define GPS_UPDATE 0.2            // s, the receiver runs at 5 Hz
+#define BRAKE_PIN 13
+
+#define DEFAULT_DIRECTORY "sitl"
+#define DEFAULT_SEED 1
+#define LAUNCH_TIME 10.0          // s
+#define THRUST 3600.0             // N
+#define BURN_TIME 2.4             // s
+#define PAD_ALTITUDE 1400.0       // m above sea level
+#define BARO_NOISE 2.5            // Pa, one sigma at OSR 4096
+#define ACCEL_NOISE 0.05          // m/s^2, one sigma
+#define MAX_TIME 600.0            // s
+
+#define START_COMMAND_TIME 2.0    // s
+#define LINGER_TIME 10.0          // s on the ground before the flight is ended
+#define STOP_TIME 1.0             // s after that before the simulation stops
+
+#define DROGUE_RATE 25.0          // m/s descent under the drogue
+#define MAIN_RATE 6.0             // m/s descent under the main
+
+#define PAD_LATITUDE 32.9401      // degrees
+#define PAD_LONGITUDE -106.9193   // degrees
+#define KNOTS_PER_MPS 1.943844
+
+struct Command {
+  double time; // s
+  std::string text;
+};
+
+struct Config {
+  const char *directory;
+  bool pty;
+  bool realTime;
+  std::vector<Command> commands;
+  double launchTime;
+  double thrust;
+  double burnTime;
+  double padAltitude;
+  double baroNoise;
+  double accelNoise;
+  unsigned long long seed;
+  double maxTime;
+};
+
+// What actually happened, times in s and altitudes above sea level
+struct Flight {
+  StateVector x;
+  Truth truth;
+  bool landed;
+  double apogee;
+  double apogeeTime;
+  double mainAltitude; // above the pad
+  double mainTime;
+  double landedTime;
+  double nextGps;
+  std::string nmea;   // sentences still to go out on the GPS UART
+  size_t nmeaSent;
+};
+
+// What the firmware did about it
+struct Detected {
+  double phase[LANDED + 1];
+  double apogeePin;
+  double mainPin;
+  double brakes;
+  double brakesAltitude;
+  double brakesVelocity;
+};
+
+static Config config;
+static Flight flight;
+static Detected detected;
+static bool setupDone = false;
+
+void setup();
+void loop();
+void SERCOM1_Handler();
+
+namespace Osprey {
+  extern Event event;
+  extern GPS gps;
+  extern Scheduler scheduler;
+}
+
+// Ballistic coefficient that falls at rate near the ground
+static float descentCoeff(double rate) {
+  float rho = Exponentially_Decaying_Density_Model(config.padAltitude / 1000);
+  return GRAV / (rho * rate * rate);
+}
+
+static StateVector derivative(StateVector x, double t) {
+  StateVector xdot = Truth_gravdiffeq_air_brake(x, t);
+  if(t >= config.launchTime && t < config.launchTime + config.burnTime) {
+    xdot.vec.z += config.thrust / MASS_ROCKET;
+  }
+  return xdot;
+}
+
+// "ddmm.mmmm,N" as the receiver sends it
+static std::string nmeaCoordinate(double degrees, int width, char positive, char negative) {
+  char field[32];
+  double magnitude = fabs(degrees);
+  int whole = (int)magnitude;
+  snprintf(field, sizeof(field), "%0*d%07.4f,%c", width, whole, (magnitude - whole) * 60,
+           degrees < 0 ? negative : positive);
+  return field;
+}
+
+static std::string nmeaSentence(const std::string &body) {
+  uint8_t checksum = 0;
+  for(size_t i=0; i<body.size(); i++) checksum ^= body[i];
+
+  char end[8];
+  snprintf(end, sizeof(end), "*%02X\r\n", checksum);
+  return "$" + body + end;
+}
+
+// The GGA and RMC sentences of one fix, queued for the GPS UART
+static void updateGps(double t) {
+  // 22 June 2019, 15:00 UTC at launch minus LAUNCH_TIME
+  long clock = lround((15 * 3600 + t) * 1000); // ms
+  char time[16];
+  snprintf(time, sizeof(time), "%02ld%02ld%02ld.%03ld", clock / 3600000 % 24,
+           clock / 60000 % 60, clock / 1000 % 60, clock % 1000);
+
+  std::string position = nmeaCoordinate(PAD_LATITUDE, 2, 'N', 'S') + "," +
+                         nmeaCoordinate(PAD_LONGITUDE, 3, 'E', 'W');
+  char gga[40], rmc[40];
+  snprintf(gga, sizeof(gga), ",1,08,1.00,%.1f,M,-22.0,M,,", flight.truth.altitude);
+  snprintf(rmc, sizeof(rmc), ",%.2f,0.00,220619,,,A", fabs(flight.truth.velocity) * KNOTS_PER_MPS);
+
+  flight.nmea.erase(0, flight.nmeaSent);
+  flight.nmeaSent = 0;
+  flight.nmea += nmeaSentence(std::string("GPGGA,") + time + "," + position + gga);
+  flight.nmea += nmeaSentence(std::string("GPRMC,") + time + ",A," + position + rmc);
+}
+
+// About a byte a millisecond, as at 9600 baud, each raising the UART's
+// interrupt
+static void sendGps() {
+  if(flight.nmeaSent >= flight.nmea.size()) return;
+
+  GPS::GPSSerial.receive((const uint8_t*)flight.nmea.data() + flight.nmeaSent++, 1);
+  SERCOM1_Handler();
+}
+
+static void step() {
+  Truth &truth = flight.truth;
+  double t = truth.time;
+  truth.time += STEP;
+
+  // Held on the rail until launch and on the ground after landing
+  if(t < config.launchTime || flight.landed) return;
+
+  StateVector x = flight.x;
+  StateVector k1 = derivative(x, t);
+  StateVector k2 = derivative(add(x, mult(STEP/2, k1)), t + STEP/2);
+  StateVector k3 = derivative(add(x, mult(STEP/2, k2)), t + STEP/2);
+  StateVector k4 = derivative(add(x, mult(STEP, k3)), t + STEP);
+  flight.x = add(x, mult(STEP/6, add(add(k1, k4), mult(2, add(k2, k3)))));
+
+  double agl = flight.x.height - config.padAltitude;
+  double previous = x.height - config.padAltitude;
+
+  if(flight.x.height > flight.apogee) {
+    flight.apogee = flight.x.height;
+    flight.apogeeTime = truth.time;
+  }
+
+  if(flight.x.vec.z < 0 && previous > flight.mainAltitude && agl <= flight.mainAltitude) {
+    flight.mainTime = truth.time;
+  }
+
+  if(agl <= 0 && t > config.launchTime + config.burnTime) {
+    flight.landed = true;
+    flight.landedTime = truth.time;
+    flight.x.height = config.padAltitude;
+    flight.x.vec = Vector3D(0, 0, 0);
+  }
+
+  truth.altitude = flight.x.height;
+  truth.velocity = flight.x.vec.z;
+  truth.acceleration = flight.landed ? 0 : derivative(flight.x, truth.time).vec.z;
+}
+
+// Bring the world up to the firmware's clock
+static void catchUp(uint64_t time) {
+  while(flight.truth.time + STEP/2 < time * 1e-6) {
+    step();
+
+    if(flight.truth.time >= flight.nextGps) {
+      updateGps(flight.truth.time);
+      flight.nextGps += GPS_UPDATE;
+    }
+    sendGps();
+  }
+}
+
+static void pinChanged(int pin, int value, uint64_t time) {
+  if(value != HIGH) return;
+  double t = time * 1e-6;
+
+  if(pin == APOGEE_PIN && detected.apogeePin < 0) {
+    detected.apogeePin = t;
+    if(detected.mainPin < 0) flight.x.balCoeff = descentCoeff(DROGUE_RATE);
+  } else if(pin == MAIN_PIN && detected.mainPin < 0) {
+    detected.mainPin = t;
+    flight.x.balCoeff = descentCoeff(MAIN_RATE);
+  } else if(pin == BRAKE_PIN && detected.brakes < 0) {
+    detected.brakes = t;
+    detected.brakesAltitude = flight.x.height - config.padAltitude;
+    detected.brakesVelocity = flight.x.vec.z;
+    if(detected.apogeePin < 0 && detected.mainPin < 0) flight.x.balCoeff = BAL_COEFF_OPEN;
+  }
+}
+
+static void delayed(uint64_t time) {
+  catchUp(time);
+
+  // printInitError never returns
+  if(!setupDone && time * 1e-6 > config.maxTime) {
+    fprintf(stderr, "sitl: setup did not finish, see %s/serial.txt\n", config.directory);
+    exit(1);
+  }
+}
+
+static int openFile(const char *name) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s", config.directory, name);
+
+  int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if(fd < 0) {
+    fprintf(stderr, "sitl: can't create %s: %s\n", path, strerror(errno));
+    exit(1);
+  }
+  return fd;
+}
+
+static int openPty() {
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if(master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+    fprintf(stderr, "sitl: can't open a pseudo terminal: %s\n", strerror(errno));
+    exit(1);
+  }
+
+  // Raw, so both ends see exactly the bytes sent. The slave stays open so
+  // the master doesn't see a hangup before a ground station connects.
+  int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+  struct termios tio;
+  if(slave < 0 || tcgetattr(slave, &tio) != 0) {
+    fprintf(stderr, "sitl: can't open %s: %s\n", ptsname(master), strerror(errno));
+    exit(1);
+  }
+  cfmakeraw(&tio);
+  tcsetattr(slave, TCSANOW, &tio);
+
+  fcntl(master, F_SETFL, O_NONBLOCK);
+  fprintf(stderr, "sitl: radio on %s\n", ptsname(master));
+  return master;
+}
+
+static void send(const std::string &text) {
+  std::string line = text + "\n";
+  Serial1.receive((const uint8_t*)line.data(), line.size());
+}
+
+static double cpuSeconds(clockid_t clock) {
+  struct timespec ts;
+  clock_gettime(clock, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void printEvent(const char *name, double truth, double detected, const char *note) {
+  printf("%-10s", name);
+  if(truth >= 0) printf(" %10.3f", truth);
+  else printf(" %10s", "-");
+  if(detected >= 0) printf(" %10.3f", detected);
+  else printf(" %10s", "missed");
+  if(truth >= 0 && detected >= 0) printf(" %+10.0f", (detected - truth) * 1000);
+  else printf(" %10s", "");
+  printf("  %s\n", note);
+}
+
+static const char* apogeeCause(int cause) {
+  switch(cause) {
+    case APOGEE_CAUSE_ALTITUDE: return "altitude";
+    case APOGEE_CAUSE_COUNTDOWN: return "countdown";
+    case APOGEE_CAUSE_SAFETY_COUNTDOWN: return "safety countdown";
+    case APOGEE_CAUSE_FREE_FALL: return "free fall";
+    case APOGEE_CAUSE_MANUAL: return "manual";
+    case APOGEE_CAUSE_VELOCITY: return "velocity";
+    default: return "";
+  }
+}
+
+static void usage() {
+  fprintf(stderr, "usage: sitl [-o DIR] [-p] [-r] [-c TIME:COMMAND]... [-l LAUNCH] [-t THRUST] [-b BURN] [-g ALT]\n"
+                  "            [-n BARO_NOISE] [-a ACCEL_NOISE] [-s SEED] [-x MAX_TIME]\n");
+  exit(1);
+}
+
+int main(int argc, char **argv) {
+  config.directory = DEFAULT_DIRECTORY;
+  config.pty = false;
+  config.realTime = false;
+  config.launchTime = LAUNCH_TIME;
+  config.thrust = THRUST;
+  config.burnTime = BURN_TIME;
+  config.padAltitude = PAD_ALTITUDE;
+  config.baroNoise = BARO_NOISE;
+  config.accelNoise = ACCEL_NOISE;
+  config.seed = DEFAULT_SEED;
+  config.maxTime = MAX_TIME;
+
+  for(int i=1; i<argc; i++) {
+    const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+    if(strcmp(argv[i], "-p") == 0) {
+      config.pty = true;
+      continue;
+    }
+    if(strcmp(argv[i], "-r") == 0) {
+      config.realTime = true;
+      continue;
+    }
+    if(!value) usage();
+
+    if(strcmp(argv[i], "-o") == 0) config.directory = value;
+    else if(strcmp(argv[i], "-c") == 0) {
+      const char *colon = strchr(value, ':');
+      if(!colon) usage();
+      Command command = { atof(value), colon + 1 };
+      config.commands.push_back(command);
+    }
+    else if(strcmp(argv[i], "-l") == 0) config.launchTime = atof(value);
+    else if(strcmp(argv[i], "-t") == 0) config.thrust = atof(value);
+    else if(strcmp(argv[i], "-b") == 0) config.burnTime = atof(value);
+    else if(strcmp(argv[i], "-g") == 0) config.padAltitude = atof(value);
+    else if(strcmp(argv[i], "-n") == 0) config.baroNoise = atof(value);
+    else if(strcmp(argv[i], "-a") == 0) config.accelNoise = atof(value);
+    else if(strcmp(argv[i], "-s") == 0) config.seed = strtoull(value, NULL, 0);
+    else if(strcmp(argv[i], "-x") == 0) config.maxTime = atof(value);
+    else usage();
+    i++;
+  }
+
+  if(config.launchTime < 0 || config.burnTime < 0 || config.maxTime <= 0) usage();
+
+  // Driven by hand from the radio or the command list, or automatically
+  bool automatic = !config.pty && config.commands.empty();
+  if(automatic) {
+    Command start = { START_COMMAND_TIME, "4" };
+    config.commands.push_back(start);
+  }
+
+  char card[512];
+  snprintf(card, sizeof(card), "%s/sd", config.directory);
+  mkdir(config.directory, 0755);
+  mkdir(card, 0755);
+  SD.setRoot(card);
+
+  Serial.setOutput(openFile("serial.txt"));
+  int radio = config.pty ? openPty() : openFile("radio.bin");
+  Serial1.setOutput(radio);
+
+  flight.x = StateVector(config.padAltitude, Vector3D(0, 0, 0), BAL_COEFF_CLOSED);
+  flight.truth.time = 0;
+  flight.truth.altitude = config.padAltitude;
+  flight.truth.velocity = 0;
+  flight.truth.acceleration = 0;
+  flight.landed = false;
+  flight.apogee = config.padAltitude;
+  flight.apogeeTime = -1;
+  flight.mainTime = -1;
+  flight.landedTime = -1;
+  flight.nextGps = 0;
+  flight.nmeaSent = 0;
+
+  for(int i=0; i<=LANDED; i++) detected.phase[i] = -1;
+  detected.apogeePin = detected.mainPin = detected.brakes = -1;
+
+  random_t random(config.seed);
+  Ms5607 barometer(&flight.truth, &random, config.baroNoise);
+  Bno055 imu(&flight.truth, &random, config.accelNoise);
+  Wire.attach(MS5607_ADDRESS, &barometer);
+  Wire.attach(BNO055_ADDRESS, &imu);
+
+  Sitl::setPinListener(pinChanged);
+  Sitl::setDelayListener(delayed);
+
+  setup();
+  setupDone = true;
+  flight.mainAltitude = Osprey::event.getAltitude(EVENT_MAIN);
+
+  std::vector<float> tickTimes;
+  double worstTick = 0;
+  double worstTickTime = 0;
+  std::string worstTickTasks;
+  double loopTime = 0;
+
+  unsigned long runs[SCHEDULER_MAX_TASKS];
+  size_t nextCommand = 0;
+  double endTime = -1;
+  double stopTime = config.maxTime;
+  double wallStart = cpuSeconds(CLOCK_MONOTONIC);
+  double cpuStart = cpuSeconds(CLOCK_PROCESS_CPUTIME_ID);
+
+  while(true) {
+    uint64_t tickStart = Sitl::now();
+    double now = tickStart * 1e-6;
+    if(now >= stopTime) break;
+
+    catchUp(tickStart);
+
+    while(nextCommand < config.commands.size() && config.commands[nextCommand].time <= now) {
+      send(config.commands[nextCommand++].text);
+    }
+
+    if(config.pty) {
+      uint8_t buffer[256];
+      ssize_t n = read(radio, buffer, sizeof(buffer));
+      if(n > 0) Serial1.receive(buffer, n);
+    }
+
+    if(automatic && flight.landed && endTime < 0) {
+      endTime = now + LINGER_TIME;
+    }
+    if(endTime >= 0 && now >= endTime) {
+      send("5");
+      endTime = -1;
+      automatic = false;
+      stopTime = std::min(stopTime, now + STOP_TIME);
+    }
+
+    int tasks = Osprey::scheduler.numTasks();
+    for(int i=0; i<tasks; i++) runs[i] = Osprey::scheduler.getTask(i)->runs;
+
+    double cpuBefore = cpuSeconds(CLOCK_THREAD_CPUTIME_ID);
+    Scheduler::tick();
+    loop();
+    double cpu = cpuSeconds(CLOCK_THREAD_CPUTIME_ID) - cpuBefore;
+    loopTime += cpu;
+
+    std::string ran;
+    for(int i=0; i<tasks; i++) {
+      const task_t *task = Osprey::scheduler.getTask(i);
+      if(task->runs == runs[i]) continue;
+      if(!ran.empty()) ran += ", ";
+      ran += task->name;
+    }
+    if(!ran.empty()) {
+      tickTimes.push_back(cpu * 1e6);
+      if(cpu > worstTick) {
+        worstTick = cpu;
+        worstTickTime = now;
+        worstTickTasks = ran;
+      }
+    }
+
+    int phase = Osprey::event.getPhase();
+    if(phase >= 0 && phase <= LANDED && detected.phase[phase] < 0) {
+      detected.phase[phase] = now;
+    }
+
+    Sitl::advanceTo(tickStart + TICK);
+
+    if(config.realTime) {
+      double ahead = Sitl::now() * 1e-6 - (cpuSeconds(CLOCK_MONOTONIC) - wallStart);
+      if(ahead > 0) usleep(ahead * 1e6);
+    }
+  }
+
+  double simulated = Sitl::now() * 1e-6;
+  double cpuTotal = cpuSeconds(CLOCK_PROCESS_CPUTIME_ID) - cpuStart;
+
+  // Events, truth against the flight computer
+  double burnout = config.launchTime + config.burnTime;
+  bool launched = simulated > config.launchTime;
+  char note[64];
+
+  printf("%-10s %10s %10s %10s\n", "event", "truth s", "detected s", "late ms");
+  printEvent("liftoff", launched ? config.launchTime : -1, detected.phase[BOOST], "");
+  printEvent("burnout", simulated > burnout ? burnout : -1, detected.phase[COAST], "");
+  printEvent("apogee", flight.apogeeTime, detected.apogeePin, apogeeCause(Osprey::event.getApogeeCause()));
+  snprintf(note, sizeof(note), "at %.0f m", flight.mainAltitude);
+  printEvent("main", flight.mainTime, detected.mainPin, note);
+  printEvent("landed", flight.landedTime, detected.phase[LANDED], "");
+
+  printf("\napogee %.1f m above the pad at %.3f s, target %.0f m\n",
+         flight.apogee - config.padAltitude, flight.apogeeTime, h_TARGET);
+  if(detected.brakes >= 0) {
+    printf("air brakes opened at %.3f s, %.1f m and %.1f m/s\n",
+           detected.brakes, detected.brakesAltitude, detected.brakesVelocity);
+  } else {
+    printf("air brakes never opened\n");
+  }
+  printf("barometer: %lu conversions, %lu read early\n", barometer.getConversions(), barometer.getEarlyReads());
+  printf("radio: %lu bytes dropped and %lu lines too long received, %lu packets dropped and %lu rejected sending\n",
+         Radio::getRxDropped(), Radio::getOverlong(), Radio::getTxDropped(), Radio::getTxRejected());
+  printf("gps: %lu sentences, %lu errors, %lu bytes dropped\n",
+         Osprey::gps.getSentences(), Osprey::gps.getErrors(), GPS::getDropped());
+
+  // Host CPU per tick that ran something
+  if(!tickTimes.empty()) {
+    std::vector<float> sorted(tickTimes);
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0;
+    for(size_t i=0; i<sorted.size(); i++) sum += sorted[i];
+
+    printf("\nhost cpu per tick, us: mean %.1f  p50 %.1f  p99 %.1f  max %.1f over %zu ticks\n",
+           sum / sorted.size(), sorted[sorted.size() / 2], sorted[sorted.size() * 99 / 100],
+           sorted.back(), sorted.size());
+    printf("worst tick at %.3f s ran %s\n", worstTickTime, worstTickTasks.c_str());
+  }
+  printf("simulated %.1f s in %.2f s of cpu (%.2f s in loop), %.0fx real time\n",
+         simulated, cpuTotal, loopTime, cpuTotal > 0 ? simulated / cpuTotal : 0);
+
+  // The scheduler's own view, in simulated time
+  printf("\n%-10s %8s %8s %8s %12s %14s\n", "task", "runs", "overruns", "missed", "jitter max", "duration max");
+  for(int i=0; i<Osprey::scheduler.numTasks(); i++) {
+    const task_t *task = Osprey::scheduler.getTask(i);
+    printf("%-10s %8lu %8lu %8lu %12lu %14lu\n", task->name, task->runs, task->overruns,
+           task->missed, task->maxJitter, task->maxDuration);
+  }
+
+  return 0;
+}
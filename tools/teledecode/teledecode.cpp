@@ -0,0 +1,250 @@
+// Host-side decoder for the binary radio downlink (see libraries/Osprey/telemetry.h)
+//
+// Build: g++ -O2 -o teledecode tools/teledecode/teledecode.cpp
+// Usage: teledecode [-f csv|json] [-t state|ack] [FILE]
+//
+// FILE is a capture of the radio's bytes or the radio's serial device itself,
+// which must already be raw (stty -F DEVICE raw 115200). Without FILE or with
+// "-" it reads standard input. Packets are printed as they arrive, and bad
+// packets and lost ones (gaps in the sequence numbers) are counted on stderr
+// at the end.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../libraries/Osprey/telemetry.h"
+
+#define FORMAT_CSV 0
+#define FORMAT_JSON 1
+
+// Anything longer without a delimiter can't be a packet
+#define MAX_ENCODED (TELEMETRY_MAX_FRAME * 2)
+
+static int format = FORMAT_CSV;
+static int onlyType = -1;
+
+static unsigned long packets = 0;
+static unsigned long badFrames = 0;
+static unsigned long badCrcs = 0;
+static unsigned long lost = 0;
+static int expected[TELEMETRY_TYPES];
+
+// Packets are little-endian regardless of the host
+static uint16_t readU16(const uint8_t *p) {
+  return p[0] | (p[1] << 8);
+}
+
+static uint32_t readU32(const uint8_t *p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int16_t readI16(const uint8_t *p) {
+  return (int16_t)readU16(p);
+}
+
+static int32_t readI32(const uint8_t *p) {
+  return (int32_t)readU32(p);
+}
+
+static const char* typeName(int type) {
+  switch(type) {
+    case TELEMETRY_STATE: return "state";
+    case TELEMETRY_ACK: return "ack";
+    default: return "unknown";
+  }
+}
+
+static int typeFromName(const char *name) {
+  for(int type = TELEMETRY_STATE; type < TELEMETRY_TYPES; type++) {
+    if(strcmp(name, typeName(type)) == 0) return type;
+  }
+
+  return -1;
+}
+
+static void printHeader(int type) {
+  switch(type) {
+    case TELEMETRY_STATE:
+      printf("type,sequence,time_ms,phase,altitude_m,velocity_ms,acceleration_ms2,"
+             "quaternion_w,quaternion_x,quaternion_y,quaternion_z,"
+             "latitude_deg,longitude_deg,gps_altitude_m,gps_quality,battery_v\n");
+      break;
+    case TELEMETRY_ACK:
+      printf("type,sequence,command,status\n");
+      break;
+    default:
+      printf("type,sequence,...\n");
+      break;
+  }
+}
+
+// Each entry is printed as either a CSV column or a JSON member
+static void field(const char *name, double value, int decimals, int *first) {
+  if(format == FORMAT_JSON) {
+    printf("%s\"%s\": %.*f", *first ? "" : ", ", name, decimals, value);
+  } else {
+    printf("%s%.*f", *first ? "" : ",", decimals, value);
+  }
+
+  *first = 0;
+}
+
+static int decodePayload(int type, int sequence, const uint8_t *p, size_t length) {
+  int first = 1;
+
+  if(format == FORMAT_JSON) {
+    printf("{\"type\": \"%s\", ", typeName(type));
+  } else {
+    printf("%s,", typeName(type));
+  }
+  field("sequence", sequence, 0, &first);
+
+  switch(type) {
+    case TELEMETRY_STATE:
+      if(length < sizeof(telemetry_state_t)) return 0;
+      field("time_ms", readU32(p + 0), 0, &first);
+      field("phase", p[4], 0, &first);
+      field("altitude_m", readI32(p + 5) / 100.0, 2, &first);
+      field("velocity_ms", readI16(p + 9) / 10.0, 1, &first);
+      field("acceleration_ms2", readI16(p + 11) / 100.0, 2, &first);
+      field("quaternion_w", readI16(p + 13) / (double)TELEMETRY_QUATERNION_SCALE, 4, &first);
+      field("quaternion_x", readI16(p + 15) / (double)TELEMETRY_QUATERNION_SCALE, 4, &first);
+      field("quaternion_y", readI16(p + 17) / (double)TELEMETRY_QUATERNION_SCALE, 4, &first);
+      field("quaternion_z", readI16(p + 19) / (double)TELEMETRY_QUATERNION_SCALE, 4, &first);
+      field("latitude_deg", readI32(p + 21) / 1e7, 7, &first);
+      field("longitude_deg", readI32(p + 25) / 1e7, 7, &first);
+      field("gps_altitude_m", readI16(p + 29), 0, &first);
+      field("gps_quality", p[31], 0, &first);
+      field("battery_v", readU16(p + 32) / 1000.0, 3, &first);
+      break;
+    case TELEMETRY_ACK:
+      if(length < sizeof(telemetry_ack_t)) return 0;
+      if(format == FORMAT_JSON) {
+        printf(", \"command\": \"%c\", \"status\": \"%s\"", p[0], p[1] ? "ack" : "err");
+      } else {
+        printf(",%c,%s", p[0], p[1] ? "ack" : "err");
+      }
+      break;
+    default:
+      break;
+  }
+
+  printf(format == FORMAT_JSON ? "}\n" : "\n");
+  return 1;
+}
+
+// Counts the packets of this type that went missing since the last one. The
+// radio sends events ahead of queued telemetry, but each type on its own
+// arrives in order.
+static void checkSequence(int type, int sequence) {
+  if(type >= TELEMETRY_TYPES) return;
+
+  if(expected[type] >= 0) {
+    lost += (uint8_t)(sequence - expected[type]);
+  }
+
+  expected[type] = (uint8_t)(sequence + 1);
+}
+
+static void decodeFrame(const uint8_t *frame, size_t length) {
+  uint8_t packet[MAX_ENCODED];
+  size_t payloadLength;
+
+  switch(telemetryDecode(frame, length, packet, &payloadLength)) {
+    case TELEMETRY_BAD_FRAME:
+      badFrames++;
+      return;
+    case TELEMETRY_BAD_CRC:
+      badCrcs++;
+      return;
+  }
+
+  int type = packet[0];
+  int sequence = packet[1];
+
+  packets++;
+  checkSequence(type, sequence);
+  if(onlyType > 0 && type != onlyType) return;
+
+  if(!decodePayload(type, sequence, packet + sizeof(telemetry_header_t), payloadLength)) {
+    fprintf(stderr, "teledecode: short %s packet\n", typeName(type));
+  }
+}
+
+static void decode(FILE *in) {
+  uint8_t frame[MAX_ENCODED];
+  size_t length = 0;
+  bool overlong = false;
+  int c;
+
+  if(format == FORMAT_CSV && onlyType > 0) {
+    printHeader(onlyType);
+  }
+
+  for(int i=0; i<TELEMETRY_TYPES; i++) {
+    expected[i] = -1;
+  }
+
+  // Whatever precedes the first delimiter is usually the tail of a packet
+  // that started before the capture, and is counted as a bad frame
+  while((c = getc(in)) != EOF) {
+    if(c != 0) {
+      if(length < sizeof(frame)) frame[length++] = c;
+      else overlong = true;
+      continue;
+    }
+
+    if(overlong) badFrames++;
+    else if(length > 0) decodeFrame(frame, length);
+
+    length = 0;
+    overlong = false;
+  }
+
+  fprintf(stderr, "teledecode: %lu packets, %lu bad frames, %lu bad CRCs, %lu lost\n",
+          packets, badFrames, badCrcs, lost);
+}
+
+static void usage() {
+  fprintf(stderr, "usage: teledecode [-f csv|json] [-t state|ack] [FILE]\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  const char *path = NULL;
+
+  for(int i=1; i<argc; i++) {
+    if(strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+      i++;
+      if(strcmp(argv[i], "json") == 0) format = FORMAT_JSON;
+      else if(strcmp(argv[i], "csv") == 0) format = FORMAT_CSV;
+      else usage();
+    } else if(strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      onlyType = typeFromName(argv[++i]);
+      if(onlyType < 0) usage();
+    } else if((argv[i][0] == '-' && argv[i][1] != '\0') || path) {
+      usage();
+    } else {
+      path = argv[i];
+    }
+  }
+
+  FILE *in = stdin;
+  if(path && strcmp(path, "-") != 0) {
+    in = fopen(path, "rb");
+    if(!in) {
+      perror(path);
+      return 1;
+    }
+  }
+
+  // Live packets are seen as they arrive
+  setvbuf(stdout, NULL, _IOLBF, 0);
+
+  decode(in);
+  if(in != stdin) fclose(in);
+
+  return 0;
+}